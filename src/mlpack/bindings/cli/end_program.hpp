@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Matthew Amidon
  *
- * Terminate the program; handle --verbose option; print output parameters.
+ * Terminate the program; handle --verbose and --profile options; print output
+ * parameters.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -73,6 +74,20 @@ inline void EndProgram()
     }
   }
 
+  if (CLI::HasParam("profile"))
+  {
+    const std::string filename = CLI::GetParam<std::string>("profile");
+    const std::string suffix = ".trace.json";
+    const bool chrome = (filename.size() >= suffix.size() &&
+        filename.compare(filename.size() - suffix.size(), suffix.size(),
+        suffix) == 0);
+    if (!Profiler::Save(filename, chrome ? "chrome" : "json"))
+    {
+      Log::Warn << "Could not save profile to '" << filename << "'."
+          << std::endl;
+    }
+  }
+
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
   // them.  But we may hold the same pointer twice, so we have to be careful to
   // not delete it multiple times.
@@ -27,6 +27,10 @@ PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_STRING_IN("profile", "If specified, profile the program and save the "
+    "profile to this file at the end of execution.  If the filename ends in "
+    "'.trace.json', the Chrome trace event format is used; otherwise a JSON "
+    "summary of regions and counters is saved.", "", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -174,6 +178,9 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
+  if (CLI::HasParam("profile"))
+    Profiler::Enable();
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
@@ -44,6 +44,10 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * When mlpack is compiled with OpenMP, the k folds are trained and evaluated
+ * in parallel, each on its own model, so it must be safe to train several
+ * MLAlgorithm objects concurrently.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -245,17 +245,38 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
+  std::unique_ptr<MLAlgorithm> lastModel;
+  std::exception_ptr exception;
+
+  // The folds are independent, so they are trained and evaluated in parallel.
+  // Each score is stored at the index of its fold, so the result does not
+  // depend on the order in which the folds finish.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    // Exceptions may not leave an OpenMP region, so keep the first one and
+    // rethrow it afterwards.
+    try
+    {
+      MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
+          GetTrainingSubset(ys, i), args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if (i == k - 1)
+        lastModel.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical(KFoldCVException)
+      if (!exception)
+        exception = std::current_exception();
+    }
   }
 
+  if (exception)
+    std::rethrow_exception(exception);
+
+  modelPtr = std::move(lastModel);
   return arma::mean(evaluations);
 }
 
@@ -272,20 +293,37 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
+  std::unique_ptr<MLAlgorithm> lastModel;
+  std::exception_ptr exception;
 
-  for (size_t i = 0; i < k; ++i)
+  // See the unweighted version above.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    try
+    {
+      MLAlgorithm&& model = (weights.n_elem > 0) ?
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              GetTrainingSubset(weights, i), args...) :
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if (i == k - 1)
+        lastModel.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical(KFoldCVException)
+      if (!exception)
+        exception = std::current_exception();
+    }
   }
 
+  if (exception)
+    std::rethrow_exception(exception);
+
+  modelPtr = std::move(lastModel);
   return arma::mean(evaluations);
 }
 
@@ -241,7 +241,7 @@ arma::vec GammaDistribution::Random() const
   {
     std::gamma_distribution<double> dist(alpha(d), beta(d));
     // Use the mlpack random object.
-    randVec(d) = dist(mlpack::math::randGen);
+    randVec(d) = dist(mlpack::math::ThreadRandGen());
   }
 
   return randVec;
@@ -9,6 +9,8 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <random>
+#include <atomic>
+#include <cstdint>
 #include <mlpack/mlpack_export.hpp>
 
 namespace mlpack {
@@ -21,5 +23,10 @@ MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
 
+// Seed used for the per-thread and per-task random streams.
+MLPACK_EXPORT std::atomic<uint64_t> randStreamSeed(0);
+// Number of times the stream seed has been changed.
+MLPACK_EXPORT std::atomic<size_t> randStreamGeneration(0);
+
 } // namespace math
 } // namespace mlpack
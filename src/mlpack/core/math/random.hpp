@@ -14,6 +14,13 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
 #include <random>
+#include <atomic>
+
+#include "random_stream.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
@@ -23,13 +30,67 @@ namespace math /** Miscellaneous math routines. */ {
  * correctly on Windows.
  */
 
-// Global random object.
+// Global random object.  This is shared between all threads; code that may run
+// in parallel should use ThreadRandGen() or TaskRandGen() instead.
 extern MLPACK_EXPORT std::mt19937 randGen;
 // Global uniform distribution.
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
 
+// Seed used for the per-thread and per-task random streams.
+extern MLPACK_EXPORT std::atomic<uint64_t> randStreamSeed;
+// Incremented every time the seed changes, so that each thread knows when to
+// reseed its own stream.
+extern MLPACK_EXPORT std::atomic<size_t> randStreamGeneration;
+
+/**
+ * Get the random stream of the calling thread.  Every thread owns a separate
+ * RandomStream, keyed by the seed given to RandomSeed() and by the thread's
+ * OpenMP thread number, so random numbers can be drawn inside parallel regions
+ * without locking and the results are reproducible for a fixed number of
+ * threads.  Threads not created by OpenMP all use the stream of thread 0.
+ *
+ * The Random(), RandInt() and RandNormal() functions all draw from this stream.
+ */
+inline RandomStream& ThreadRandGen()
+{
+  static thread_local RandomStream generator;
+  static thread_local size_t generation = (size_t) -1;
+
+  const size_t currentGeneration =
+      randStreamGeneration.load(std::memory_order_relaxed);
+  if (generation != currentGeneration)
+  {
+    uint64_t threadNum = 0;
+    #ifdef HAS_OPENMP
+      threadNum = (uint64_t) omp_get_thread_num();
+    #endif
+
+    // Thread streams use the upper half of the stream index space, so they
+    // never overlap with the streams given by TaskRandGen().
+    generator.Seed(randStreamSeed.load(std::memory_order_relaxed),
+        (uint64_t(1) << 63) | threadNum);
+    generation = currentGeneration;
+  }
+
+  return generator;
+}
+
+/**
+ * Get a random stream for the given task, keyed by the seed given to
+ * RandomSeed() and by the task index.  Parallel code whose output should not
+ * depend on the number of threads can give each independent unit of work (a
+ * tree of a forest, a fold, a worker) its own stream via this function.
+ *
+ * @param task Index of the task; this must be smaller than 2^63.
+ */
+inline RandomStream TaskRandGen(const size_t task)
+{
+  return RandomStream(randStreamSeed.load(std::memory_order_relaxed),
+      (uint64_t) task);
+}
+
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
@@ -41,6 +102,8 @@ inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
     randGen.seed((uint32_t) seed);
+    randStreamSeed = (uint64_t) seed;
+    ++randStreamGeneration;
     srand((unsigned int) seed);
     arma::arma_rng::set_seed(seed);
   #else
@@ -60,6 +123,8 @@ inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
   randGen.seed((uint32_t) seed);
+  randStreamSeed = (uint64_t) seed;
+  ++randStreamGeneration;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -70,7 +135,7 @@ inline void FixedRandomSeed()
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return ThreadRandGen().Random();
 }
 
 /**
@@ -78,7 +143,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * ThreadRandGen().Random();
 }
 
 /**
@@ -97,7 +162,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * ThreadRandGen().Random());
 }
 
 /**
@@ -106,7 +171,7 @@ inline int RandInt(const int hiExclusive)
 inline int RandInt(const int lo, const int hiExclusive)
 {
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * ThreadRandGen().Random());
 }
 
 /**
@@ -114,7 +179,7 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  return ThreadRandGen().RandNormal();
 }
 
 /**
@@ -126,22 +191,24 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * ThreadRandGen().RandNormal() + mean;
 }
 
 /**
- * Obtains no more than maxNumSamples distinct samples. Each sample belongs to
- * [loInclusive, hiExclusive).
+ * Obtains no more than maxNumSamples distinct samples, drawing from the given
+ * random stream. Each sample belongs to [loInclusive, hiExclusive).
  *
  * @param loInclusive The lower bound (inclusive).
  * @param hiExclusive The high bound (exclusive).
  * @param maxNumSamples The maximum number of samples to obtain.
  * @param distinctSamples The samples that will be obtained.
+ * @param generator The random stream to draw from.
  */
 inline void ObtainDistinctSamples(const size_t loInclusive,
                                   const size_t hiExclusive,
                                   const size_t maxNumSamples,
-                                  arma::uvec& distinctSamples)
+                                  arma::uvec& distinctSamples,
+                                  RandomStream& generator)
 {
   const size_t samplesRangeSize = hiExclusive - loInclusive;
 
@@ -152,7 +219,10 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
     samples.zeros(samplesRangeSize);
 
     for (size_t i = 0; i < maxNumSamples; i++)
-      samples [ (size_t) math::RandInt(samplesRangeSize) ]++;
+    {
+      samples [ (size_t) std::floor((double) samplesRangeSize *
+          generator.Random()) ]++;
+    }
 
     distinctSamples = arma::find(samples > 0);
 
@@ -167,6 +237,24 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
   }
 }
 
+/**
+ * Obtains no more than maxNumSamples distinct samples. Each sample belongs to
+ * [loInclusive, hiExclusive).
+ *
+ * @param loInclusive The lower bound (inclusive).
+ * @param hiExclusive The high bound (exclusive).
+ * @param maxNumSamples The maximum number of samples to obtain.
+ * @param distinctSamples The samples that will be obtained.
+ */
+inline void ObtainDistinctSamples(const size_t loInclusive,
+                                  const size_t hiExclusive,
+                                  const size_t maxNumSamples,
+                                  arma::uvec& distinctSamples)
+{
+  ObtainDistinctSamples(loInclusive, hiExclusive, maxNumSamples,
+      distinctSamples, ThreadRandGen());
+}
+
 } // namespace math
 } // namespace mlpack
 
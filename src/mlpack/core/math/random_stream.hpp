@@ -0,0 +1,200 @@
+/**
+ * @file random_stream.hpp
+ *
+ * Definition of the RandomStream class, a counter-based random number
+ * generator whose streams can be split deterministically by seed and stream
+ * index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+#define MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * A counter-based random number generator implementing Philox4x32-10.  The
+ * output of the generator is a pure function of its key (the seed), the stream
+ * index and a block counter, so any number of statistically independent
+ * streams can be created from one seed without any shared state: two
+ * RandomStream objects with the same seed but different stream indices never
+ * overlap.
+ *
+ * The class satisfies the C++ UniformRandomBitGenerator requirements, so it can
+ * be passed to std::shuffle() and to the distributions in <random>.  The
+ * convenience functions Random() and RandNormal() are also provided.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{salmon2011parallel,
+ *   title={Parallel random numbers: as easy as 1, 2, 3},
+ *   author={Salmon, J.K. and Moraes, M.A. and Dror, R.O. and Shaw, D.E.},
+ *   booktitle={Proceedings of the 2011 International Conference for High
+ *       Performance Computing, Networking, Storage and Analysis (SC '11)},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class RandomStream
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint32_t result_type;
+
+  /**
+   * Create the generator for the given seed and stream index.
+   *
+   * @param seed Seed (key) of the generator.
+   * @param stream Index of the stream to draw from.
+   */
+  RandomStream(const uint64_t seed = 0, const uint64_t stream = 0)
+  {
+    Seed(seed, stream);
+  }
+
+  /**
+   * Reset the generator to the start of the given stream.
+   *
+   * @param seed Seed (key) of the generator.
+   * @param stream Index of the stream to draw from.
+   */
+  void Seed(const uint64_t seed, const uint64_t stream = 0)
+  {
+    this->seed = seed;
+    this->stream = stream;
+    block = 0;
+    position = 4;
+    hasSpareNormal = false;
+  }
+
+  //! Get the seed of the generator.
+  uint64_t Seed() const { return seed; }
+  //! Get the stream index of the generator.
+  uint64_t Stream() const { return stream; }
+
+  //! Smallest value that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Largest value that can be generated.
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+  //! Generate the next 32-bit random number.
+  result_type operator()()
+  {
+    if (position == 4)
+    {
+      GenerateBlock();
+      position = 0;
+    }
+
+    return output[position++];
+  }
+
+  /**
+   * Skip ahead in the stream by the given number of 32-bit outputs.  This takes
+   * constant time.
+   */
+  void Discard(const uint64_t n)
+  {
+    const uint64_t target = 4 * block - (4 - position) + n;
+    block = target / 4;
+    position = 4;
+    for (size_t i = 0; i < target % 4; ++i)
+      (*this)();
+  }
+
+  //! Generate a uniform random number in [0, 1) with 53 bits of precision.
+  double Random()
+  {
+    const uint64_t a = (*this)() >> 5;
+    const uint64_t b = (*this)() >> 6;
+    return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+  }
+
+  /**
+   * Generate a normally distributed random number with mean 0 and variance 1,
+   * using the Marsaglia polar method.
+   */
+  double RandNormal()
+  {
+    if (hasSpareNormal)
+    {
+      hasSpareNormal = false;
+      return spareNormal;
+    }
+
+    double u, v, s;
+    do
+    {
+      u = 2.0 * Random() - 1.0;
+      v = 2.0 * Random() - 1.0;
+      s = u * u + v * v;
+    } while (s >= 1.0 || s == 0.0);
+
+    const double factor = std::sqrt(-2.0 * std::log(s) / s);
+    spareNormal = v * factor;
+    hasSpareNormal = true;
+    return u * factor;
+  }
+
+ private:
+  //! Compute the next block of four outputs from the counter and the key.
+  void GenerateBlock()
+  {
+    uint32_t c0 = (uint32_t) block;
+    uint32_t c1 = (uint32_t) (block >> 32);
+    uint32_t c2 = (uint32_t) stream;
+    uint32_t c3 = (uint32_t) (stream >> 32);
+    uint32_t k0 = (uint32_t) seed;
+    uint32_t k1 = (uint32_t) (seed >> 32);
+
+    for (size_t round = 0; round < 10; ++round)
+    {
+      const uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+      const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+
+      c0 = ((uint32_t) (p1 >> 32)) ^ c1 ^ k0;
+      c1 = (uint32_t) p1;
+      c2 = ((uint32_t) (p0 >> 32)) ^ c3 ^ k1;
+      c3 = (uint32_t) p0;
+
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+    ++block;
+  }
+
+  //! The seed (key) of the generator.
+  uint64_t seed;
+  //! The stream index (upper half of the counter).
+  uint64_t stream;
+  //! The block index (lower half of the counter) of the next block.
+  uint64_t block;
+  //! The last generated block.
+  uint32_t output[4];
+  //! The position of the next output in the block.
+  size_t position;
+
+  //! Whether a second normal value from the polar method is cached.
+  bool hasSpareNormal;
+  //! The cached normal value.
+  double spareNormal;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
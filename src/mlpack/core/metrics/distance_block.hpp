@@ -0,0 +1,198 @@
+/**
+ * @file distance_block.hpp
+ *
+ * Evaluation of the distances between a set of query points and a range of
+ * reference points at once.  For the Euclidean and squared Euclidean distances,
+ * this is done with one matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_DISTANCE_BLOCK_HPP
+#define MLPACK_CORE_METRICS_DISTANCE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Compute the distances between some query points and the contiguous reference
+ * points of a leaf; this is used by the blocked base cases of the dual-tree
+ * rules.  By default, each distance is evaluated separately with the metric
+ * and is exact; the specialization for the Euclidean and squared Euclidean
+ * distances is faster but only accurate up to rounding errors.
+ *
+ * @tparam MetricType Type of metric.
+ * @tparam MatType Type of the data matrices.
+ */
+template<typename MetricType, typename MatType = arma::mat>
+class DistanceBlock
+{
+ public:
+  //! Whether the distances are computed with a matrix product (and are not
+  //! exact).
+  static const bool UsesProduct = false;
+
+  /**
+   * Prepare to compute distances between points of the given sets.
+   *
+   * @param metric Instantiated metric.
+   * @param querySet Set of query points.
+   * @param referenceSet Set of reference points.
+   */
+  DistanceBlock(MetricType& metric,
+                const MatType& querySet,
+                const MatType& referenceSet) :
+      metric(metric),
+      querySet(querySet),
+      referenceSet(referenceSet)
+  { }
+
+  /**
+   * Compute the distances between the given query points and the given range
+   * of reference points; after the call, distances(i, j) holds the distance
+   * between query point queryIndices[j] and reference point referenceBegin + i.
+   *
+   * @param queryIndices Indices of the query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   * @param distances Matrix to store the distances in.
+   * @return Bound on the absolute error of the distances.
+   */
+  double Evaluate(const std::vector<size_t>& queryIndices,
+                  const size_t referenceBegin,
+                  const size_t referenceCount,
+                  arma::mat& distances)
+  {
+    distances.set_size(referenceCount, queryIndices.size());
+    for (size_t j = 0; j < queryIndices.size(); ++j)
+      for (size_t i = 0; i < referenceCount; ++i)
+        distances(i, j) = metric.Evaluate(querySet.col(queryIndices[j]),
+            referenceSet.col(referenceBegin + i));
+
+    return 0.0;
+  }
+
+ private:
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The set of query points.
+  const MatType& querySet;
+  //! The set of reference points.
+  const MatType& referenceSet;
+};
+
+/**
+ * The squared Euclidean distance between q and r is expanded as
+ * ||q||^2 + ||r||^2 - 2 q^T r, where the squared norms are computed once for
+ * every point and all the inner products of a block are computed with one
+ * matrix multiplication.  The subtraction cancels digits when the points are
+ * close compared to their norms, so the distances are only accurate up to the
+ * bound returned by Evaluate().
+ */
+template<bool TakeRoot, typename MatType>
+class DistanceBlock<LMetric<2, TakeRoot>, MatType>
+{
+ public:
+  //! The distances are computed with a matrix product.
+  static const bool UsesProduct = true;
+
+  //! Prepare to compute distances between points of the given sets.
+  DistanceBlock(LMetric<2, TakeRoot>& /* metric */,
+                const MatType& querySet,
+                const MatType& referenceSet) :
+      querySet(querySet),
+      referenceSet(referenceSet)
+  { }
+
+  //! Compute the distances between the given query points and the given range
+  //! of reference points, and return a bound on their absolute error.
+  double Evaluate(const std::vector<size_t>& queryIndices,
+                  const size_t referenceBegin,
+                  const size_t referenceCount,
+                  arma::mat& distances)
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    if (queryIndices.empty() || referenceCount == 0)
+    {
+      distances.set_size(referenceCount, queryIndices.size());
+      return 0.0;
+    }
+
+    // The norms are computed the first time they are needed, since the rules
+    // may never use a block.
+    if (referenceNorms.n_elem != referenceSet.n_cols)
+      referenceNorms = arma::conv_to<arma::vec>::from(
+          arma::sum(arma::square(referenceSet), 0));
+    const arma::vec& allQueryNorms = (&querySet == &referenceSet) ?
+        referenceNorms : QueryNorms();
+
+    queries.set_size(querySet.n_rows, queryIndices.size());
+    for (size_t j = 0; j < queryIndices.size(); ++j)
+      queries.col(j) = querySet.col(queryIndices[j]);
+
+    distances = arma::conv_to<arma::mat>::from(referenceSet.cols(
+        referenceBegin, referenceBegin + referenceCount - 1).t() * queries);
+
+    double maxQueryNorm = 0.0;
+    double maxReferenceNorm = 0.0;
+    const double* rNorms = referenceNorms.memptr() + referenceBegin;
+    for (size_t i = 0; i < referenceCount; ++i)
+      maxReferenceNorm = std::max(maxReferenceNorm, rNorms[i]);
+
+    for (size_t j = 0; j < queryIndices.size(); ++j)
+    {
+      const double qNorm = allQueryNorms[queryIndices[j]];
+      maxQueryNorm = std::max(maxQueryNorm, qNorm);
+
+      double* d = distances.colptr(j);
+      for (size_t i = 0; i < referenceCount; ++i)
+      {
+        // Rounding may make the squared distance slightly negative.
+        const double squared = std::max(qNorm + rNorms[i] - 2.0 * d[i], 0.0);
+        d[i] = TakeRoot ? std::sqrt(squared) : squared;
+      }
+    }
+
+    // The error of an inner product of n terms is at most about n times the
+    // machine epsilon times the product of the norms (which is less than the
+    // sum of the squared norms).
+    const double squaredError = 4.0 * (querySet.n_rows + 2) *
+        std::numeric_limits<ElemType>::epsilon() *
+        (maxQueryNorm + maxReferenceNorm);
+
+    // |a - b| <= sqrt(|a^2 - b^2|) for non-negative a and b.
+    return TakeRoot ? std::sqrt(squaredError) : squaredError;
+  }
+
+ private:
+  //! Get the squared norms of the query points, computing them if necessary.
+  const arma::vec& QueryNorms()
+  {
+    if (queryNorms.n_elem != querySet.n_cols)
+      queryNorms = arma::conv_to<arma::vec>::from(
+          arma::sum(arma::square(querySet), 0));
+    return queryNorms;
+  }
+
+  //! The set of query points.
+  const MatType& querySet;
+  //! The set of reference points.
+  const MatType& referenceSet;
+  //! The squared norms of the query points (unless the sets are the same).
+  arma::vec queryNorms;
+  //! The squared norms of the reference points.
+  arma::vec referenceNorms;
+  //! The query points of the current block.
+  MatType queries;
+};
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file base_case_block.hpp
+ *
+ * Detection of rules that can compute the base cases between some query points
+ * and all the points of a reference leaf at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BASE_CASE_BLOCK_HPP
+#define MLPACK_CORE_TREE_BASE_CASE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BaseCaseBlock, HasBaseCaseBlockCheck);
+
+/**
+ * HasBaseCaseBlock<RuleType>::value is true if the rules have a method
+ *
+ * @code
+ * void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+ *                    const size_t referenceBegin,
+ *                    const size_t referenceCount);
+ * @endcode
+ *
+ * which must be equivalent to calling BaseCase(query, reference) for every
+ * query point of queryIndices (in order) and every reference point in
+ * [referenceBegin, referenceBegin + referenceCount).  Traversers of trees whose
+ * leaves hold contiguous points call it on pairs of leaves, after scoring each
+ * query point against the reference leaf; the rules must then not depend on
+ * the base cases of the other query points of the leaf in Score().
+ *
+ * The method must be declared by the rules class itself: a class that derives
+ * from rules with a blocked base case (for instance, to change BaseCase()) does
+ * not match, and gets the base cases one at a time.
+ */
+template<typename RuleType>
+struct HasBaseCaseBlock
+{
+  static const bool value = HasBaseCaseBlockCheck<RuleType,
+      void(RuleType::*)(const std::vector<size_t>&, const size_t,
+                        const size_t)>::value;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -88,6 +88,9 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If the tree is frozen, the block of memory holding every node but the
+  //! root (only set in the root).
+  BinarySpaceTree* frozenNodes;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -300,6 +303,24 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Freeze the tree for query serving: move every node object but the root
+   * into one contiguous block of memory, in van Emde Boas order, so that the
+   * node objects of a small subtree are close together.  Only the node objects
+   * are moved; data that a node or its bound allocates separately (such as the
+   * ranges of an HRectBound) stays where it was allocated.  The tree is
+   * otherwise unchanged, and it can still be searched, copied, moved and
+   * serialized; a copied or loaded tree is not frozen.
+   *
+   * This must be called on the root of the tree, and it invalidates any
+   * pointers or references to the other nodes.  The nodes of a frozen tree
+   * must not be deleted individually.
+   */
+  void Freeze();
+
+  //! Return whether the tree has been frozen with Freeze().
+  bool IsFrozen() const { return frozenNodes != NULL; }
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -531,6 +552,32 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Append the nodes of the first levels of the subtree rooted at the given
+   * node to order, in van Emde Boas order, and append the nodes just below
+   * these levels to frontier.
+   *
+   * @param node Root of the subtree.
+   * @param levels Number of levels of the subtree to order.
+   * @param order Nodes in van Emde Boas order.
+   * @param frontier Children of the deepest ordered nodes.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t levels,
+                               std::vector<BinarySpaceTree*>& order,
+                               std::vector<BinarySpaceTree*>& frontier);
+
+  //! Return the number of levels of the subtree rooted at this node.
+  size_t Height() const;
+
+  //! Destroy the other nodes of a frozen tree and release their memory; this
+  //! must be called on the root.
+  void DestroyFrozenNodes();
+
+  //! Call the destructors of the descendants of this node, which are in the
+  //! block of memory of a frozen tree.
+  void DestroyFrozenDescendants();
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -40,7 +40,8 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    frozenNodes(NULL)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -68,7 +69,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    frozenNodes(NULL)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -102,7 +104,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    frozenNodes(NULL)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -137,7 +140,8 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    frozenNodes(NULL)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -165,7 +169,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    frozenNodes(NULL)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -199,7 +204,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    frozenNodes(NULL)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -238,7 +244,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    frozenNodes(NULL)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +274,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    frozenNodes(NULL)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +309,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    frozenNodes(NULL)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +351,8 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    frozenNodes(NULL)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,7 +410,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    frozenNodes(other.frozenNodes)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -412,6 +423,7 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.frozenNodes = NULL;
 
   // Set new parent.
   if (left)
@@ -455,6 +467,9 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
+  if (frozenNodes)
+    DestroyFrozenNodes();
+
   delete left;
   delete right;
 
@@ -463,6 +478,134 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     delete dataset;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Freeze()
+{
+  if (parent)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Freeze(): only the root of "
+        "a tree can be frozen!");
+  }
+
+  if (frozenNodes || !left)
+    return;
+
+  std::vector<BinarySpaceTree*> order;
+  std::vector<BinarySpaceTree*> frontier;
+  VanEmdeBoasOrder(this, Height(), order, frontier);
+
+  // The root stays where it is, and the other nodes are moved into the block
+  // in order.  A parent always comes before its children in the order, so when
+  // a node is moved, its parent has been moved already and only the pointer of
+  // the parent to the node must be updated (the move constructor of the
+  // parent updated the parent pointer of the node).
+  frozenNodes = static_cast<BinarySpaceTree*>(::operator new(
+      sizeof(BinarySpaceTree) * (order.size() - 1)));
+  for (size_t i = 1; i < order.size(); ++i)
+  {
+    BinarySpaceTree* node = order[i];
+    BinarySpaceTree* frozenNode = new (frozenNodes + (i - 1))
+        BinarySpaceTree(std::move(*node));
+
+    if (frozenNode->parent->left == node)
+      frozenNode->parent->left = frozenNode;
+    else
+      frozenNode->parent->right = frozenNode;
+
+    // The moved node holds nothing anymore.
+    delete node;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    VanEmdeBoasOrder(BinarySpaceTree* node,
+                     const size_t levels,
+                     std::vector<BinarySpaceTree*>& order,
+                     std::vector<BinarySpaceTree*>& frontier)
+{
+  if (levels <= 1)
+  {
+    order.push_back(node);
+    if (node->left)
+      frontier.push_back(node->left);
+    if (node->right)
+      frontier.push_back(node->right);
+    return;
+  }
+
+  // Order the top half of the levels, and then each of the subtrees below
+  // them.
+  const size_t topLevels = levels / 2;
+  std::vector<BinarySpaceTree*> middle;
+  VanEmdeBoasOrder(node, topLevels, order, middle);
+  for (size_t i = 0; i < middle.size(); ++i)
+    VanEmdeBoasOrder(middle[i], levels - topLevels, order, frontier);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                       SplitType>::Height() const
+{
+  if (!left)
+    return 1;
+
+  return 1 + std::max(left->Height(), right ? right->Height() : 0);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DestroyFrozenNodes()
+{
+  DestroyFrozenDescendants();
+  ::operator delete(frozenNodes);
+  frozenNodes = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DestroyFrozenDescendants()
+{
+  BinarySpaceTree* children[2] = { left, right };
+  left = NULL;
+  right = NULL;
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    if (children[i])
+    {
+      children[i]->DestroyFrozenDescendants();
+      children[i]->~BinarySpaceTree();
+    }
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -928,7 +1071,8 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    frozenNodes(NULL)
 {
   // Nothing to do.
 }
@@ -949,6 +1093,9 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
+    if (frozenNodes)
+      DestroyFrozenNodes();
+
     if (left)
       delete left;
     if (right)
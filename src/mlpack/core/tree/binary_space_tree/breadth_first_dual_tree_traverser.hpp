@@ -17,6 +17,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <queue>
+#include <chrono>
 
 #include "../binary_space_tree.hpp"
 
@@ -46,8 +47,25 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
  public:
   /**
    * Instantiate the dual-tree traverser with the given rule set.
+   *
+   * The queues of node combinations hold at most maxQueueSize combinations in
+   * total; when a combination would exceed that budget, it is traversed
+   * depth-first right away instead of being queued, so the memory used by the
+   * traversal is bounded.  The results are the same either way.
+   *
+   * If timeLimit is positive, the traversal stops once it has run for that many
+   * seconds, and the rules are left with the best results found so far (see
+   * TimedOut()).
+   *
+   * @param rule Rules to traverse with.
+   * @param maxQueueSize Maximum number of queued node combinations (0 means no
+   *     limit).
+   * @param timeLimit Time limit of each traversal in seconds (0 means no
+   *     limit).
    */
-  BreadthFirstDualTreeTraverser(RuleType& rule);
+  BreadthFirstDualTreeTraverser(RuleType& rule,
+                                const size_t maxQueueSize = 1000000,
+                                const double timeLimit = 0.0);
 
   typedef QueueFrame<BinarySpaceTree, typename RuleType::TraversalInfoType>
       QueueFrameType;
@@ -84,7 +102,49 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the number of combinations traversed depth-first because the queues
+  //! were full.
+  size_t NumSpills() const { return numSpills; }
+  //! Modify the number of combinations traversed depth-first because the
+  //! queues were full.
+  size_t& NumSpills() { return numSpills; }
+
+  //! Get the maximum number of queued node combinations (0 means no limit).
+  size_t MaxQueueSize() const { return maxQueueSize; }
+  //! Modify the maximum number of queued node combinations (0 means no limit).
+  size_t& MaxQueueSize() { return maxQueueSize; }
+
+  //! Get the time limit of each traversal in seconds (0 means no limit).
+  double TimeLimit() const { return timeLimit; }
+  //! Modify the time limit of each traversal in seconds (0 means no limit).
+  double& TimeLimit() { return timeLimit; }
+
+  //! Get whether the last traversal was stopped by the time limit, so that the
+  //! results of the rules may be incomplete.
+  bool TimedOut() const { return timedOut; }
+
  private:
+  /**
+   * Push the given combination to the given queue, or traverse it depth-first
+   * if the queues are full.
+   */
+  void Push(std::priority_queue<QueueFrameType>& queue,
+            const QueueFrameType& frame);
+
+  /**
+   * Traverse the given combination depth-first.  The combination must already
+   * have been scored.
+   */
+  void DepthFirstTraverse(BinarySpaceTree& queryNode,
+                          BinarySpaceTree& referenceNode);
+
+  //! Compute the base cases between two leaves.
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode);
+
+  //! Check whether the time limit has been reached.
+  bool TimeUp();
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
@@ -100,6 +160,21 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! The number of combinations traversed depth-first.
+  size_t numSpills;
+
+  //! The maximum number of queued node combinations.
+  size_t maxQueueSize;
+  //! The number of node combinations currently held in the queues.
+  size_t queueSize;
+
+  //! The time limit of each traversal in seconds.
+  double timeLimit;
+  //! The time at which the current traversal must stop.
+  std::chrono::steady_clock::time_point deadline;
+  //! Whether the last traversal was stopped by the time limit.
+  bool timedOut;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
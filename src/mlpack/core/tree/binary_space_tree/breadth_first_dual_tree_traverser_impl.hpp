@@ -29,12 +29,19 @@ template<typename MetricType,
 template<typename RuleType>
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BreadthFirstDualTreeTraverser<RuleType>::BreadthFirstDualTreeTraverser(
-    RuleType& rule) :
+    RuleType& rule,
+    const size_t maxQueueSize,
+    const double timeLimit) :
     rule(rule),
     numPrunes(0),
     numVisited(0),
     numScores(0),
-    numBaseCases(0)
+    numBaseCases(0),
+    numSpills(0),
+    maxQueueSize(maxQueueSize),
+    queueSize(0),
+    timeLimit(timeLimit),
+    timedOut(false)
 { /* Nothing to do. */ }
 
 template<typename TreeType, typename TraversalInfoType>
@@ -68,6 +75,16 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
 
+  // Start the clock, if there is a time limit.
+  queueSize = 0;
+  timedOut = false;
+  if (timeLimit > 0.0)
+  {
+    deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(timeLimit));
+  }
+
   // Must score the root combination.
   const double rootScore = rule.Score(queryRoot, referenceRoot);
   if (rootScore == DBL_MAX)
@@ -83,6 +100,7 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   rootFrame.traversalInfo = rule.TraversalInfo();
 
   queue.push(rootFrame);
+  ++queueSize;
 
   // Start the traversal.
   Traverse(queryRoot, queue);
@@ -108,8 +126,13 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
 
   while (!referenceQueue.empty())
   {
+    // If the time is up, the remaining combinations are dropped.
+    if (TimeUp())
+      return;
+
     QueueFrameType currentFrame = referenceQueue.top();
     referenceQueue.pop();
+    --queueSize;
 
     BinarySpaceTree& queryNode = *currentFrame.queryNode;
     BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
@@ -129,35 +152,18 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     // If both are leaves, we must evaluate the base case.
     if (queryNode.IsLeaf() && referenceNode.IsLeaf())
     {
-      // Loop through each of the points in each node.
-      const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
-      {
-        // See if we need to investigate this point (this function should be
-        // implemented for the single-tree recursion too).  Restore the
-        // traversal information first.
-//        const double childScore = rule.Score(query, referenceNode);
-
-//        if (childScore == DBL_MAX)
-//          continue; // We can't improve this particular point.
-
-        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-          rule.BaseCase(query, ref);
-
-        numBaseCases += referenceNode.Count();
-      }
+      LeafBaseCases(queryNode, referenceNode);
     }
     else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
     {
       // We have to recurse down the query node.
       QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
           score, rule.TraversalInfo() };
-      leftChildQueue.push(fl);
+      Push(leftChildQueue, fl);
 
       QueueFrameType fr = { queryNode.Right(), &referenceNode, queryDepth + 1,
           score, ti };
-      rightChildQueue.push(fr);
+      Push(rightChildQueue, fr);
     }
     else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
     {
@@ -166,11 +172,11 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // traversal information correctly.
       QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
           score, rule.TraversalInfo() };
-      referenceQueue.push(fl);
+      Push(referenceQueue, fl);
 
       QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
           score, ti };
-      referenceQueue.push(fr);
+      Push(referenceQueue, fr);
     }
     else
     {
@@ -180,19 +186,19 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // correctly.
       QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(fll);
+      Push(leftChildQueue, fll);
 
       QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(flr);
+      Push(leftChildQueue, flr);
 
       QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frl);
+      Push(rightChildQueue, frl);
 
       QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frr);
+      Push(rightChildQueue, frr);
     }
   }
 
@@ -200,10 +206,168 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   // matter.
   if (leftChildQueue.size() > 0)
     Traverse(*queryNode.Left(), leftChildQueue);
-  if (rightChildQueue.size() > 0)
+  if (rightChildQueue.size() > 0 && !timedOut)
     Traverse(*queryNode.Right(), rightChildQueue);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::Push(
+    std::priority_queue<QueueFrameType>& queue,
+    const QueueFrameType& frame)
+{
+  if (maxQueueSize == 0 || queueSize < maxQueueSize)
+  {
+    queue.push(frame);
+    ++queueSize;
+    return;
+  }
+
+  // The queues are full, so the combination is traversed right away.  The
+  // caller may still use the current traversal information, so it is restored
+  // afterwards.
+  ++numSpills;
+  const typename RuleType::TraversalInfoType info = rule.TraversalInfo();
+  rule.TraversalInfo() = frame.traversalInfo;
+
+  const double score = rule.Score(*frame.queryNode, *frame.referenceNode);
+  ++numScores;
+
+  if (score == DBL_MAX)
+    ++numPrunes;
+  else
+    DepthFirstTraverse(*frame.queryNode, *frame.referenceNode);
+
+  rule.TraversalInfo() = info;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::DepthFirstTraverse(
+    BinarySpaceTree& queryNode,
+    BinarySpaceTree& referenceNode)
+{
+  ++numVisited;
+
+  if (TimeUp())
+    return;
+
+  if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+  {
+    LeafBaseCases(queryNode, referenceNode);
+    return;
+  }
+
+  // Recurse into the children of every node that is not a leaf.
+  BinarySpaceTree* queryChildren[2] = { &queryNode, NULL };
+  size_t numQueryChildren = 1;
+  if (!queryNode.IsLeaf())
+  {
+    queryChildren[0] = queryNode.Left();
+    queryChildren[1] = queryNode.Right();
+    numQueryChildren = 2;
+  }
+
+  BinarySpaceTree* referenceChildren[2] = { &referenceNode, NULL };
+  size_t numReferenceChildren = 1;
+  if (!referenceNode.IsLeaf())
+  {
+    referenceChildren[0] = referenceNode.Left();
+    referenceChildren[1] = referenceNode.Right();
+    numReferenceChildren = 2;
+  }
+
+  const typename RuleType::TraversalInfoType parentInfo = rule.TraversalInfo();
+  for (size_t i = 0; i < numQueryChildren; ++i)
+  {
+    BinarySpaceTree& queryChild = *queryChildren[i];
+
+    double scores[2];
+    typename RuleType::TraversalInfoType infos[2];
+    for (size_t j = 0; j < numReferenceChildren; ++j)
+    {
+      rule.TraversalInfo() = parentInfo;
+      scores[j] = rule.Score(queryChild, *referenceChildren[j]);
+      infos[j] = rule.TraversalInfo();
+      ++numScores;
+    }
+
+    // Visit the reference child with the better score first; the other one
+    // must be rescored afterwards, since the bounds may have changed.
+    const size_t first = (numReferenceChildren == 2 && scores[1] < scores[0]) ?
+        1 : 0;
+    for (size_t j = 0; j < numReferenceChildren; ++j)
+    {
+      const size_t c = (j == 0) ? first : 1 - first;
+      double score = scores[c];
+      if (j > 0 && score != DBL_MAX)
+        score = rule.Rescore(queryChild, *referenceChildren[c], score);
+
+      if (score == DBL_MAX)
+      {
+        ++numPrunes;
+        continue;
+      }
+
+      rule.TraversalInfo() = infos[c];
+      DepthFirstTraverse(queryChild, *referenceChildren[c]);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::LeafBaseCases(
+    BinarySpaceTree& queryNode,
+    BinarySpaceTree& referenceNode)
+{
+  // Loop through each of the points in each node.
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+      rule.BaseCase(query, ref);
+
+    numBaseCases += referenceNode.Count();
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::TimeUp()
+{
+  if (timeLimit > 0.0 && !timedOut &&
+      std::chrono::steady_clock::now() >= deadline)
+    timedOut = true;
+
+  return timedOut;
+}
+
 } // namespace tree
 } // namespace mlpack
 
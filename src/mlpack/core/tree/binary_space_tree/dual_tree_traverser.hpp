@@ -16,6 +16,7 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/base_case_block.hpp>
 
 #include "binary_space_tree.hpp"
 
@@ -69,6 +70,21 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   size_t& NumBaseCases() { return numBaseCases; }
 
  private:
+  //! Compute the base cases between two leaves, with the blocked base case of
+  //! the rules.
+  template<typename Rule = RuleType>
+  void LeafBaseCases(
+      BinarySpaceTree& queryNode,
+      BinarySpaceTree& referenceNode,
+      const typename std::enable_if_t<HasBaseCaseBlock<Rule>::value>* = 0);
+
+  //! Compute the base cases between two leaves, one pair at a time.
+  template<typename Rule = RuleType>
+  void LeafBaseCases(
+      BinarySpaceTree& queryNode,
+      BinarySpaceTree& referenceNode,
+      const typename std::enable_if_t<!HasBaseCaseBlock<Rule>::value>* = 0);
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
@@ -87,6 +103,10 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The query points of a leaf that were not pruned, held in the class so
+  //! that it isn't continually being reallocated.
+  std::vector<size_t> leafQueries;
 };
 
 } // namespace tree
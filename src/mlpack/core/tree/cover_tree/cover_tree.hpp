@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/range.hpp>
+#include <deque>
 
 #include "../statistic.hpp"
 #include "first_point_is_root.hpp"
@@ -50,6 +51,13 @@ namespace tree {
  * -- non-leaf nodes with more than one child.  A leaf node has no children, and
  * its scale level is INT_MIN.
  *
+ * When OpenMP is enabled and more than one thread is available, the children of
+ * large nodes are built in parallel.  To know which points each of them uses
+ * before it is built, these children only take the points of their own near
+ * set, instead of also taking points of their far set; the resulting tree still
+ * satisfies the nesting and covering invariants, but its shape may differ from
+ * the tree built with one thread.
+ *
  * For more information on cover trees, see
  *
  * @code
@@ -533,6 +541,44 @@ class CoverTree
    */
   void RemoveNewImplicitNodes();
 
+  /**
+   * Remove any implicit nodes that have been created at the given position in
+   * the list of children.
+   *
+   * @param i Index of the child to look at.
+   */
+  void RemoveImplicitNodes(const size_t i);
+
+  /**
+   * Buffers that are reused during the construction of the tree, so that the
+   * indices and distances of the points of each new child are not allocated
+   * again for every node.  The calls to CreateChildren() are nested, so each
+   * recursion depth has its own buffers.  Each thread has its own arena, which
+   * is released when its outermost call to CreateChildren() returns.
+   */
+  struct BuildArena
+  {
+    BuildArena() : depth(0) { }
+
+    //! The buffers of indices, one for each recursion depth.
+    std::deque<arma::Col<size_t>> indices;
+    //! The buffers of distances, one for each recursion depth.
+    std::deque<arma::vec> distances;
+    //! The current recursion depth.
+    size_t depth;
+    //! Temporary indices for SortPointSet().
+    arma::Col<size_t> sortIndices;
+    //! Temporary distances for SortPointSet().
+    arma::Col<ElemType> sortDistances;
+  };
+
+  //! Get the arena of the calling thread.
+  static BuildArena& Arena();
+
+  //! Leave one recursion depth of the arena of the calling thread, and release
+  //! the arena if this was the outermost one.
+  static void LeaveArena();
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
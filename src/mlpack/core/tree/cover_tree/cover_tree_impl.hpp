@@ -18,6 +18,10 @@
 #include <queue>
 #include <string>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -989,6 +993,9 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     size_t& farSetSize,
     size_t& usedSetSize)
 {
+  // The arena must know how deep this call is.
+  ++Arena().depth;
+
   // Determine the next scale level.  This should be the first level where there
   // are any points in the far set.  So, if we know the maximum distance in the
   // distances array, this will be the largest i such that
@@ -1029,6 +1036,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     // [ far | all used ].
     SortPointSet(indices, distances, 0, usedSetSize, farSetSize);
 
+    LeaveArena();
     return;
   }
 
@@ -1036,6 +1044,37 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       (int) ceil(log(maxDistance) / log(base))) - 1;
   const ElemType bound = pow(base, nextScale);
 
+  // The points of each new child (other than the self child) are held in the
+  // buffers of this depth.
+  BuildArena& arena = Arena();
+  if (arena.indices.size() < arena.depth)
+  {
+    arena.indices.emplace_back();
+    arena.distances.emplace_back();
+  }
+  arma::Col<size_t>& indicesBuffer = arena.indices[arena.depth - 1];
+  arma::vec& distancesBuffer = arena.distances[arena.depth - 1];
+
+  // With several threads, large children of large nodes are only built once
+  // all the children are known, so that they can be built in parallel.
+  struct DeferredChild
+  {
+    size_t slot;
+    size_t point;
+    ElemType parentDistance;
+    size_t nearSetSize;
+    arma::Col<size_t> indices;
+    arma::vec distances;
+    CoverTree* node;
+  };
+  std::vector<DeferredChild> deferredChildren;
+  #ifdef HAS_OPENMP
+  const bool deferChildren = (omp_get_max_threads() > 1) &&
+      !omp_in_parallel() && (nearSetSize + farSetSize >= 4096);
+  #else
+  const bool deferChildren = false;
+  #endif
+
   // First, make the self child.  We must split the given near set into the near
   // set and far set for the self child.
   size_t childNearSetSize =
@@ -1117,20 +1156,52 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       break;
     }
 
-    // Create the near and far set indices and distance vectors.  We don't fill
-    // in the self-point, yet.
-    arma::Col<size_t> childIndices(nearSetSize + farSetSize);
-    childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
-        nearSetSize + farSetSize - 1);
-    arma::vec childDistances(nearSetSize + farSetSize);
+    // Create the near and far set indices and distance vectors, using the
+    // buffers of the arena.  We don't fill in the self-point, yet.
+    const size_t childSetSize = nearSetSize + farSetSize;
+    if (indicesBuffer.n_elem < childSetSize)
+    {
+      indicesBuffer.set_size(childSetSize);
+      distancesBuffer.set_size(childSetSize);
+    }
+    arma::Col<size_t> childIndices(indicesBuffer.memptr(), childSetSize, false,
+        true);
+    arma::vec childDistances(distancesBuffer.memptr(), childSetSize, false,
+        true);
+    childIndices.rows(0, (childSetSize - 2)) = indices.rows(1,
+        childSetSize - 1);
 
     // Build distances for the child.
-    ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
-        + farSetSize - 1);
+    ComputeDistances(indices[0], childIndices, childDistances,
+        childSetSize - 1);
 
     // Split into near and far sets for this point.
     childNearSetSize = SplitNearFar(childIndices, childDistances, bound,
-        nearSetSize + farSetSize - 1);
+        childSetSize - 1);
+
+    if (deferChildren && childNearSetSize >= 64)
+    {
+      // This child only takes its near set, so the points it uses are known
+      // now; it gets its own copy of them, since it will be built later.
+      childIndices(childNearSetSize) = indices[0];
+      childDistances(childNearSetSize) = 0;
+
+      DeferredChild child;
+      child.slot = children.size();
+      child.point = indices[0];
+      child.parentDistance = distances[0];
+      child.nearSetSize = childNearSetSize;
+      child.indices = childIndices.rows(0, childNearSetSize);
+      child.distances = childDistances.rows(0, childNearSetSize);
+      child.node = NULL;
+      deferredChildren.push_back(std::move(child));
+      children.push_back(NULL);
+
+      MoveToUsedSet(indices, distances, nearSetSize, farSetSize, usedSetSize,
+          childIndices, 0, childNearSetSize + 1);
+      continue;
+    }
+
     childFarSetSize = PruneFarSet(childIndices, childDistances,
         base * bound, childNearSetSize,
         (nearSetSize + farSetSize - 1));
@@ -1163,11 +1234,37 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
         childIndices, childFarSetSize, childUsedSetSize);
   }
 
+  // Build the deferred children.  They don't share any points, and the
+  // construction of each of them is serial.
+  #pragma omp parallel for schedule(dynamic) if (deferredChildren.size() > 1)
+  for (omp_size_t i = 0; i < (omp_size_t) deferredChildren.size(); ++i)
+  {
+    DeferredChild& child = deferredChildren[i];
+    size_t deferredFarSetSize = 0;
+    size_t deferredUsedSetSize = 1; // The self point.
+    child.node = new CoverTree(*dataset, base, child.point, nextScale, this,
+        child.parentDistance, child.indices, child.distances,
+        child.nearSetSize, deferredFarSetSize, deferredUsedSetSize, *metric);
+  }
+
+  for (size_t i = 0; i < deferredChildren.size(); ++i)
+  {
+    const size_t slot = deferredChildren[i].slot;
+    children[slot] = deferredChildren[i].node;
+    numDescendants += children[slot]->NumDescendants();
+
+    RemoveImplicitNodes(slot);
+
+    distanceComps += children[slot]->DistanceComps();
+  }
+
   // Calculate furthest descendant.
   for (size_t i = (nearSetSize + farSetSize); i < (nearSetSize + farSetSize +
       usedSetSize); ++i)
     if (distances[i] > furthestDescendantDistance)
       furthestDescendantDistance = distances[i];
+
+  LeaveArena();
 }
 
 template<
@@ -1243,7 +1340,8 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   // For each point, rebuild the distances.  The indices do not need to be
   // modified.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  #pragma omp parallel for if (pointSetSize >= 4096)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
@@ -1274,8 +1372,15 @@ size_t CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   if (bufferSize == 0)
     return (childFarSetSize + farSetSize);
 
-  size_t* indicesBuffer = new size_t[bufferSize];
-  ElemType* distancesBuffer = new ElemType[bufferSize];
+  // The temporary memory is reused from the arena.
+  BuildArena& arena = Arena();
+  if (arena.sortIndices.n_elem < bufferSize)
+  {
+    arena.sortIndices.set_size(bufferSize);
+    arena.sortDistances.set_size(bufferSize);
+  }
+  size_t* indicesBuffer = arena.sortIndices.memptr();
+  ElemType* distancesBuffer = arena.sortDistances.memptr();
 
   // The start of the memory region to copy to the buffer.
   const size_t bufferFromLocation = ((bufferSize == farSetSize) ?
@@ -1308,9 +1413,6 @@ size_t CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   memcpy(distances.memptr() + bufferToLocation, distancesBuffer,
       sizeof(ElemType) * bufferSize);
 
-  delete[] indicesBuffer;
-  delete[] distancesBuffer;
-
   // This returns the complete size of the far set.
   return (childFarSetSize + farSetSize);
 }
@@ -1515,16 +1617,31 @@ template<
 >
 inline void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
     RemoveNewImplicitNodes()
+{
+  RemoveImplicitNodes(children.size() - 1);
+}
+
+/**
+ * Remove any implicit nodes that have been created at the given position in the
+ * list of children.
+ */
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+inline void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    RemoveImplicitNodes(const size_t i)
 {
   // If we created an implicit node, take its self-child instead (this could
   // happen multiple times).
-  while (children[children.size() - 1]->NumChildren() == 1)
+  while (children[i]->NumChildren() == 1)
   {
-    CoverTree* old = children[children.size() - 1];
-    children.erase(children.begin() + children.size() - 1);
+    CoverTree* old = children[i];
 
     // Now take its child.
-    children.push_back(&(old->Child(0)));
+    children[i] = &(old->Child(0));
 
     // Set its parent and parameters correctly, and rebuild the statistic.
     old->Child(0).Parent() = this;
@@ -1540,6 +1657,34 @@ inline void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   }
 }
 
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+typename CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    BuildArena&
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::Arena()
+{
+  static thread_local BuildArena arena;
+  return arena;
+}
+
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    LeaveArena()
+{
+  BuildArena& arena = Arena();
+  if (--arena.depth == 0)
+    arena = BuildArena();
+}
+
 /**
  * Default constructor, only for use with boost::serialization.
  */
@@ -0,0 +1,114 @@
+/**
+ * @file parallel_single_tree_traversal.hpp
+ *
+ * A driver that runs the single-tree traversals of many query points in
+ * parallel, for the single-tree modes of the tree-based methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_SINGLE_TREE_TRAVERSAL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_SINGLE_TREE_TRAVERSAL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Traverse the reference tree once for each query point in [0, numQueries)
+ * with a single-tree traverser.  The query points are independent, so with
+ * OpenMP they are distributed dynamically among the threads, and each thread
+ * traverses with its own rules object and its own traverser; the rules
+ * objects are created by calling createRules(), which must return a pointer to
+ * a new RuleType object (it is deleted by this function).
+ *
+ * For the results to be right and not to depend on the number of threads, the
+ * rules objects must write the results of a query point only to storage that
+ * belongs to that query point (usually, all the rules objects share the
+ * results), and they must not modify the reference tree.  Rules that cache
+ * values in the reference nodes (as the rules of many methods do for cover
+ * trees) must be run with parallel set to false.
+ *
+ * @code
+ * size_t baseCases = 0, scores = 0, numPrunes = 0;
+ * ParallelSingleTreeTraversal<TreeType::template SingleTreeTraverser,
+ *     RuleType>(referenceTree, querySet.n_cols, [&]()
+ *     { return new RuleType(referenceSet, querySet, results); },
+ *     baseCases, scores, numPrunes);
+ * @endcode
+ *
+ * @tparam TraverserType Class template of the single-tree traverser.
+ * @tparam RuleType Type of the rules.
+ * @param referenceTree Tree to traverse.
+ * @param numQueries Number of query points.
+ * @param createRules Function object that creates a rules object.
+ * @param baseCases Incremented by the number of base cases of all the rules.
+ * @param scores Incremented by the number of scores of all the rules.
+ * @param numPrunes Incremented by the number of nodes pruned by all the
+ *     traversers.
+ * @param parallel If false, all the query points are traversed by one thread.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType,
+         typename CreateRulesType>
+void ParallelSingleTreeTraversal(TreeType& referenceTree,
+                                 const size_t numQueries,
+                                 const CreateRulesType& createRules,
+                                 size_t& baseCases,
+                                 size_t& scores,
+                                 size_t& numPrunes,
+                                 const bool parallel = true)
+{
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+  size_t totalPrunes = 0;
+
+  #pragma omp parallel if (parallel && numQueries > 1) \
+      reduction(+:totalBaseCases, totalScores, totalPrunes)
+  {
+    RuleType* rules = createRules();
+    TraverserType<RuleType> traverser(*rules);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+      traverser.Traverse(i, referenceTree);
+
+    totalBaseCases += rules->BaseCases();
+    totalScores += rules->Scores();
+    totalPrunes += traverser.NumPrunes();
+    delete rules;
+  }
+
+  baseCases += totalBaseCases;
+  scores += totalScores;
+  numPrunes += totalPrunes;
+}
+
+/**
+ * Traverse the reference tree once for each query point in [0, numQueries),
+ * as above, when the number of pruned nodes is not needed.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType,
+         typename CreateRulesType>
+void ParallelSingleTreeTraversal(TreeType& referenceTree,
+                                 const size_t numQueries,
+                                 const CreateRulesType& createRules,
+                                 size_t& baseCases,
+                                 size_t& scores,
+                                 const bool parallel = true)
+{
+  size_t numPrunes = 0;
+  ParallelSingleTreeTraversal<TraverserType, RuleType>(referenceTree,
+      numQueries, createRules, baseCases, scores, numPrunes, parallel);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -33,6 +33,9 @@
 #include "rectangle_tree/hilbert_r_tree_split.hpp"
 #include "rectangle_tree/hilbert_r_tree_auxiliary_information.hpp"
 #include "rectangle_tree/discrete_hilbert_value.hpp"
+#include "rectangle_tree/packing_traits.hpp"
+#include "rectangle_tree/sort_tile_recursive_packing.hpp"
+#include "rectangle_tree/hilbert_packing.hpp"
 #include "rectangle_tree/r_plus_tree_descent_heuristic.hpp"
 #include "rectangle_tree/r_plus_tree_split_policy.hpp"
 #include "rectangle_tree/minimal_coverage_sweep.hpp"
@@ -41,6 +44,7 @@
 #include "rectangle_tree/r_plus_plus_tree_auxiliary_information.hpp"
 #include "rectangle_tree/r_plus_plus_tree_descent_heuristic.hpp"
 #include "rectangle_tree/r_plus_plus_tree_split_policy.hpp"
+#include "rectangle_tree/is_rectangle_tree.hpp"
 #include "rectangle_tree/traits.hpp"
 #include "rectangle_tree/typedef.hpp"
 
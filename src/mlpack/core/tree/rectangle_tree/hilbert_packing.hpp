@@ -0,0 +1,76 @@
+/**
+ * @file hilbert_packing.hpp
+ *
+ * Definition of the HilbertPacking class, which orders the points of a
+ * bulk-loaded rectangle type tree along the Hilbert curve.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "discrete_hilbert_value.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The Hilbert packing policy for the bulk-loading constructor of
+ * RectangleTree.  The points are sorted once by their discrete Hilbert values
+ * (see DiscreteHilbertValue), and every node gets a contiguous range of the
+ * sorted points.  The Hilbert values are computed and sorted in parallel when
+ * OpenMP is available.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{kamel1993packing,
+ *   title={On packing R-trees},
+ *   author={Kamel, Ibrahim and Faloutsos, Christos},
+ *   booktitle={Proceedings of the Second International Conference on
+ *       Information and Knowledge Management},
+ *   pages={490--499},
+ *   year={1993},
+ *   organization={ACM}
+ * }
+ * @endcode
+ */
+class HilbertPacking
+{
+ public:
+  /**
+   * Sort the points by their Hilbert values.
+   *
+   * @param data The dataset.
+   * @param points Indices of the points to build the tree on.
+   */
+  template<typename MatType>
+  static void Prepare(const MatType& data, std::vector<size_t>& points);
+
+  /**
+   * Reorder points[offsets.front(), offsets.back()) so that each range
+   * [offsets[i], offsets[i + 1]) holds the points of one child.  The points
+   * are already sorted along the Hilbert curve, so this does nothing.
+   *
+   * @param data The dataset.
+   * @param points Indices of the points to build the tree on.
+   * @param offsets Boundaries of the children in points.
+   */
+  template<typename MatType>
+  static void Partition(const MatType& /* data */,
+                        std::vector<size_t>& /* points */,
+                        const std::vector<size_t>& /* offsets */)
+  { }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "hilbert_packing_impl.hpp"
+
+#endif
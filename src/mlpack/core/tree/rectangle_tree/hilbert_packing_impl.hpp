@@ -0,0 +1,77 @@
+/**
+ * @file hilbert_packing_impl.hpp
+ *
+ * Implementation of the HilbertPacking class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_IMPL_HPP
+
+#include "hilbert_packing.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void HilbertPacking::Prepare(const MatType& data, std::vector<size_t>& points)
+{
+  typedef DiscreteHilbertValue<typename MatType::elem_type> HilbertValue;
+  typedef typename HilbertValue::HilbertElemType HilbertElemType;
+
+  arma::Mat<HilbertElemType> values(data.n_rows, data.n_cols);
+  #pragma omp parallel for if (points.size() >= 1000)
+  for (omp_size_t i = 0; i < (omp_size_t) points.size(); ++i)
+    values.col(points[i]) = HilbertValue::CalculateValue(data.col(points[i]));
+
+  auto lessThan = [&values](const size_t a, const size_t b)
+  {
+    return HilbertValue::CompareValues(values.unsafe_col(a),
+        values.unsafe_col(b)) < 0;
+  };
+
+  // Sort one block of points per thread, then merge pairs of sorted blocks
+  // until one block is left.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  if (points.size() >= 1000 && !omp_in_parallel())
+    numBlocks = std::min((size_t) omp_get_max_threads(), points.size() / 500);
+  #endif
+
+  std::vector<size_t> blocks(numBlocks + 1);
+  for (size_t i = 0; i <= numBlocks; ++i)
+    blocks[i] = i * points.size() / numBlocks;
+
+  #pragma omp parallel for schedule(dynamic) if (numBlocks > 1)
+  for (omp_size_t i = 0; i < (omp_size_t) numBlocks; ++i)
+    std::sort(points.begin() + blocks[i], points.begin() + blocks[i + 1],
+        lessThan);
+
+  for (size_t width = 1; width < numBlocks; width *= 2)
+  {
+    #pragma omp parallel for schedule(dynamic) if (numBlocks > 2 * width)
+    for (omp_size_t i = 0; i < (omp_size_t) numBlocks; i += 2 * width)
+    {
+      const size_t first = (size_t) i;
+      if (first + width < numBlocks)
+      {
+        std::inplace_merge(points.begin() + blocks[first],
+            points.begin() + blocks[first + width],
+            points.begin() + blocks[std::min(first + 2 * width, numBlocks)],
+            lessThan);
+      }
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file packing_traits.hpp
+ *
+ * Definition of the PackingTraits class, which tells whether a rectangle type
+ * tree may be bulk loaded by packing its nodes directly.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_PACKING_TRAITS_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_PACKING_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The PackingTraits class is used by the bulk-loading constructor of
+ * RectangleTree.  If CanPack is true, the nodes of the tree are filled
+ * directly with the packed points, which only requires that the children of a
+ * node may overlap and that the auxiliary information of a node does not
+ * depend on the order in which the points were inserted.  Otherwise, the
+ * packed points are inserted one by one with InsertPoint().  The
+ * specializations are in traits.hpp.
+ */
+template<typename TreeType>
+class PackingTraits
+{
+ public:
+  //! Whether the nodes of the tree can be packed directly.
+  static const bool CanPack = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "packing_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -156,6 +157,63 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset, instead of inserting the points one by one.  The points
+   * are ordered with the given packing policy (SortTileRecursivePacking or
+   * HilbertPacking), and the nodes are filled from the top down: every leaf is
+   * on the same level, and the nodes are nearly full.  This is much faster than
+   * the point-by-point construction, and the resulting tree is usually faster
+   * to search, but it is not the tree that the insertions would build.
+   *
+   * Trees whose nodes can't be packed directly (see PackingTraits), such as the
+   * Hilbert R tree and the R+/R++ trees, are built by inserting the points in
+   * the packed order.  The minimum fill of the nodes is only guaranteed if
+   * minLeafSize <= maxLeafSize / 2 and minNumChildren <= maxNumChildren / 2.
+   *
+   * @param packing Instantiated packing policy.
+   * @param data Dataset from which to create the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   * @param firstDataIndex The index of the first data point.
+   */
+  template<typename PackingType>
+  RectangleTree(const PackingType& packing,
+                const MatType& data,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2,
+                const size_t firstDataIndex = 0);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset, and taking ownership of the given dataset.  See the
+   * constructor above for details.
+   *
+   * @param packing Instantiated packing policy.
+   * @param data Dataset from which to create the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   * @param firstDataIndex The index of the first data point.
+   */
+  template<typename PackingType>
+  RectangleTree(const PackingType& packing,
+                MatType&& data,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2,
+                const size_t firstDataIndex = 0);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -542,6 +600,16 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Build the tree under this empty root node from the points with indices in
+   * [firstDataIndex, dataset->n_cols), ordering them with the given packing
+   * policy.
+   *
+   * @param firstDataIndex The index of the first data point.
+   */
+  template<typename PackingType>
+  void BulkLoad(const size_t firstDataIndex);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
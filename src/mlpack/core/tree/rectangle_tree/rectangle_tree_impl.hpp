@@ -101,6 +101,82 @@ RectangleTree(MatType&& data,
     root->InsertPoint(i);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PackingType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const PackingType& /* packing */,
+              const MatType& data,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren,
+              const size_t firstDataIndex) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  stat = StatisticType(*this);
+
+  BulkLoad<PackingType>(firstDataIndex);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PackingType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const PackingType& /* packing */,
+              MatType&& data,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren,
+              const size_t firstDataIndex) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  stat = StatisticType(*this);
+
+  BulkLoad<PackingType>(firstDataIndex);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1303,6 +1379,120 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PackingType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoad(const size_t firstDataIndex)
+{
+  if (firstDataIndex >= dataset->n_cols)
+    return;
+
+  std::vector<size_t> order(dataset->n_cols - firstDataIndex);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = firstDataIndex + i;
+  PackingType::Prepare(*dataset, order);
+
+  if (!PackingTraits<RectangleTree>::CanPack)
+  {
+    for (size_t i = 0; i < order.size(); ++i)
+      InsertPoint(order[i]);
+    return;
+  }
+
+  // capacities[h] is the number of points that a full subtree of height h can
+  // hold; the tree gets the smallest height that can hold all the points.
+  std::vector<size_t> capacities(1, maxLeafSize);
+  while (capacities.back() < order.size())
+    capacities.push_back(capacities.back() * maxNumChildren);
+
+  // The tree is built level by level.  The nodes of a level hold consecutive
+  // ranges of the packed points: node i of the level holds the points in
+  // [offsets[i], offsets[i + 1]).  The points of a node are divided as evenly
+  // as possible among as few children as possible, so that every node is
+  // nearly full.  The nodes of a level are independent, so they are split in
+  // parallel.
+  std::vector<std::vector<RectangleTree*>> levels(1,
+      std::vector<RectangleTree*>(1, this));
+  std::vector<size_t> offsets = { 0, order.size() };
+  for (size_t height = capacities.size() - 1; height > 0; --height)
+  {
+    const std::vector<RectangleTree*>& nodes = levels.back();
+    std::vector<std::vector<size_t>> childOffsets(nodes.size());
+
+    #pragma omp parallel for schedule(dynamic) if (nodes.size() > 1)
+    for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+    {
+      const size_t numPoints = offsets[i + 1] - offsets[i];
+      const size_t numNodeChildren = std::max(
+          (numPoints + capacities[height - 1] - 1) / capacities[height - 1],
+          std::min(minNumChildren, numPoints));
+
+      std::vector<size_t>& nodeOffsets = childOffsets[i];
+      nodeOffsets.resize(numNodeChildren + 1);
+      for (size_t j = 0; j <= numNodeChildren; ++j)
+        nodeOffsets[j] = offsets[i] + j * numPoints / numNodeChildren;
+      PackingType::Partition(*dataset, order, nodeOffsets);
+
+      RectangleTree* node = nodes[i];
+      for (size_t j = 0; j < numNodeChildren; ++j)
+        node->children[j] = new RectangleTree(node);
+      node->numChildren = numNodeChildren;
+    }
+
+    std::vector<RectangleTree*> nextNodes;
+    std::vector<size_t> nextOffsets(1, 0);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      for (size_t j = 0; j < nodes[i]->numChildren; ++j)
+      {
+        nextNodes.push_back(nodes[i]->children[j]);
+        nextOffsets.push_back(childOffsets[i][j + 1]);
+      }
+    }
+
+    levels.push_back(std::move(nextNodes));
+    offsets.swap(nextOffsets);
+  }
+
+  // Fill the leaves.
+  const std::vector<RectangleTree*>& leaves = levels.back();
+  #pragma omp parallel for if (leaves.size() > 1)
+  for (omp_size_t i = 0; i < (omp_size_t) leaves.size(); ++i)
+  {
+    RectangleTree* leaf = leaves[i];
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      leaf->points[leaf->count++] = order[j];
+      leaf->bound |= dataset->col(order[j]);
+    }
+    leaf->numDescendants = leaf->count;
+    leaf->stat = StatisticType(*leaf);
+  }
+
+  // Compute the bounds of the other nodes, from the bottom up.
+  for (size_t level = levels.size() - 1; level-- > 0; )
+  {
+    const std::vector<RectangleTree*>& nodes = levels[level];
+    #pragma omp parallel for if (nodes.size() > 1)
+    for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+    {
+      RectangleTree* node = nodes[i];
+      for (size_t j = 0; j < node->numChildren; ++j)
+      {
+        node->bound |= node->children[j]->Bound();
+        node->numDescendants += node->children[j]->numDescendants;
+      }
+      node->stat = StatisticType(*node);
+    }
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
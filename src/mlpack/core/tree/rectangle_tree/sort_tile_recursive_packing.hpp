@@ -0,0 +1,91 @@
+/**
+ * @file sort_tile_recursive_packing.hpp
+ *
+ * Definition of the SortTileRecursivePacking class, which orders the points of
+ * a bulk-loaded rectangle type tree with the Sort-Tile-Recursive algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_SORT_TILE_RECURSIVE_PACKING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_SORT_TILE_RECURSIVE_PACKING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The Sort-Tile-Recursive (STR) packing policy for the bulk-loading
+ * constructor of RectangleTree.  The points of a node are cut into slabs along
+ * the dimension of largest spread, each slab is cut along the dimension of
+ * largest spread of its points, and so on, until there is one tile for each
+ * child of the node.  With S^d tiles in d dimensions, each cut makes S slabs,
+ * so the tiles are roughly square.  Only partial orderings are computed (with
+ * std::nth_element()), so a node with n points is tiled in O(n d) time.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title={STR: A simple and efficient algorithm for R-tree packing},
+ *   author={Leutenegger, Scott T. and Lopez, Mario A. and Edgington, Jeffrey},
+ *   booktitle={Proceedings of the 13th International Conference on Data
+ *       Engineering},
+ *   pages={497--506},
+ *   year={1997},
+ *   organization={IEEE}
+ * }
+ * @endcode
+ */
+class SortTileRecursivePacking
+{
+ public:
+  /**
+   * Reorder all the points before the tree is built.  The tiles are computed
+   * node by node, so this does nothing.
+   *
+   * @param data The dataset.
+   * @param points Indices of the points to build the tree on.
+   */
+  template<typename MatType>
+  static void Prepare(const MatType& /* data */,
+                      std::vector<size_t>& /* points */)
+  { }
+
+  /**
+   * Reorder points[offsets.front(), offsets.back()) so that each range
+   * [offsets[i], offsets[i + 1]) holds the points of one tile.
+   *
+   * @param data The dataset.
+   * @param points Indices of the points to build the tree on.
+   * @param offsets Boundaries of the tiles in points.
+   */
+  template<typename MatType>
+  static void Partition(const MatType& data,
+                        std::vector<size_t>& points,
+                        const std::vector<size_t>& offsets);
+
+ private:
+  /**
+   * Tile the points of the tiles [firstTile, lastTile), cutting along at most
+   * the given number of dimensions.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& data,
+                   std::vector<size_t>& points,
+                   const std::vector<size_t>& offsets,
+                   const size_t firstTile,
+                   const size_t lastTile,
+                   const size_t numCuts);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "sort_tile_recursive_packing_impl.hpp"
+
+#endif
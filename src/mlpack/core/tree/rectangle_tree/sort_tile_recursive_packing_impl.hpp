@@ -0,0 +1,101 @@
+/**
+ * @file sort_tile_recursive_packing_impl.hpp
+ *
+ * Implementation of the SortTileRecursivePacking class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_SORT_TILE_RECURSIVE_PACKING_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_SORT_TILE_RECURSIVE_PACKING_IMPL_HPP
+
+#include "sort_tile_recursive_packing.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void SortTileRecursivePacking::Partition(const MatType& data,
+                                         std::vector<size_t>& points,
+                                         const std::vector<size_t>& offsets)
+{
+  Tile(data, points, offsets, 0, offsets.size() - 1, data.n_rows);
+}
+
+template<typename MatType>
+void SortTileRecursivePacking::Tile(const MatType& data,
+                                    std::vector<size_t>& points,
+                                    const std::vector<size_t>& offsets,
+                                    const size_t firstTile,
+                                    const size_t lastTile,
+                                    const size_t numCuts)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t numTiles = lastTile - firstTile;
+  if (numTiles < 2)
+    return;
+
+  const size_t end = offsets[lastTile];
+
+  // Find the dimension of largest spread.
+  arma::Col<ElemType> minValues(data.n_rows);
+  arma::Col<ElemType> maxValues(data.n_rows);
+  minValues.fill(std::numeric_limits<ElemType>::max());
+  maxValues.fill(std::numeric_limits<ElemType>::lowest());
+  for (size_t i = offsets[firstTile]; i < end; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      const ElemType value = data(d, points[i]);
+      minValues[d] = std::min(minValues[d], value);
+      maxValues[d] = std::max(maxValues[d], value);
+    }
+  }
+  const size_t dim = arma::index_max(maxValues - minValues);
+
+  // Find the smallest number of slabs such that cutting every slab the same way
+  // along the remaining dimensions gives enough tiles.  Along the last
+  // dimension, every tile is a slab.
+  size_t numSlabs = numTiles;
+  if (numCuts > 1)
+  {
+    for (numSlabs = 2; numSlabs < numTiles; ++numSlabs)
+    {
+      size_t tiles = 1;
+      for (size_t c = 0; c < numCuts && tiles < numTiles; ++c)
+        tiles *= numSlabs;
+      if (tiles >= numTiles)
+        break;
+    }
+  }
+  const size_t tilesPerSlab = (numTiles + numSlabs - 1) / numSlabs;
+
+  auto lessThan = [&data, dim](const size_t a, const size_t b)
+  {
+    return data(dim, a) < data(dim, b);
+  };
+
+  for (size_t slab = firstTile; slab < lastTile; slab += tilesPerSlab)
+  {
+    const size_t slabEnd = std::min(slab + tilesPerSlab, lastTile);
+
+    // Move the points with the smallest values in the dimension to this slab.
+    if (slabEnd < lastTile)
+    {
+      std::nth_element(points.begin() + offsets[slab],
+                       points.begin() + offsets[slabEnd],
+                       points.begin() + end, lessThan);
+    }
+
+    Tile(data, points, offsets, slab, slabEnd, std::max(numCuts - 1,
+        (size_t) 1));
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
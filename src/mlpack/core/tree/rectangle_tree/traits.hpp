@@ -13,6 +13,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_TRAITS_HPP
 
 #include <mlpack/core/tree/tree_traits.hpp>
+#include "packing_traits.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -131,6 +132,51 @@ class TreeTraits<RectangleTree<MetricType,
   static const bool UniqueNumDescendants = true;
 };
 
+/**
+ * The nodes of an R+/R++ tree must not overlap, so the bulk-loading constructor
+ * inserts the packed points one by one.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitPolicyType,
+         template<typename> class SweepType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+class PackingTraits<RectangleTree<MetricType,
+    StatisticType,
+    MatType,
+    RPlusTreeSplit<SplitPolicyType,
+                   SweepType>,
+    DescentType,
+    AuxiliaryInformationType>>
+{
+ public:
+  static const bool CanPack = false;
+};
+
+/**
+ * The nodes of a Hilbert R tree hold the largest Hilbert value of their points,
+ * which is maintained by the insertions, so the bulk-loading constructor
+ * inserts the packed points one by one.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         size_t SplitOrder,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+class PackingTraits<RectangleTree<MetricType,
+    StatisticType,
+    MatType,
+    HilbertRTreeSplit<SplitOrder>,
+    DescentType,
+    AuxiliaryInformationType>>
+{
+ public:
+  static const bool CanPack = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
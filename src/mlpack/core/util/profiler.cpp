@@ -0,0 +1,424 @@
+/**
+ * @file profiler.cpp
+ *
+ * Implementation of the Profiler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace mlpack;
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+
+//! Maximum number of trace events kept for each thread.
+const size_t maxEventsPerThread = 1 << 20;
+
+//! A node of the region tree of one thread.
+struct ProfileNode
+{
+  ProfileNode(const size_t region, const size_t parent) :
+      region(region), parent(parent), calls(0), total(0) { }
+
+  //! ID of the region.
+  size_t region;
+  //! Index of the parent node.
+  size_t parent;
+  //! Indices of the child nodes.
+  vector<size_t> children;
+  //! Number of times the region was left.
+  uint64_t calls;
+  //! Total time spent in the region.
+  nanoseconds total;
+};
+
+//! A completed region, for the Chrome trace.
+struct TraceEvent
+{
+  //! ID of the region.
+  size_t region;
+  //! Start time, relative to the start of the profiler.
+  nanoseconds start;
+  //! Duration of the region.
+  nanoseconds duration;
+};
+
+//! Everything recorded by one thread.
+struct ThreadProfile
+{
+  ThreadProfile(const size_t index) : index(index) { Clear(); }
+
+  //! Forget everything that has been recorded.
+  void Clear()
+  {
+    nodes.clear();
+    nodes.push_back(ProfileNode(size_t(-1), size_t(-1)));
+    current = 0;
+    startTimes.clear();
+    counters.clear();
+    events.clear();
+    droppedEvents = 0;
+  }
+
+  //! Index of the thread (in order of first use of the profiler).
+  size_t index;
+  //! The region tree; the first node is the root, which is not a region.
+  vector<ProfileNode> nodes;
+  //! Index of the node of the innermost active region.
+  size_t current;
+  //! Start times of the active regions.
+  vector<steady_clock::time_point> startTimes;
+  //! Counter values, indexed by counter ID.
+  vector<uint64_t> counters;
+  //! Completed regions.
+  vector<TraceEvent> events;
+  //! Number of completed regions that did not fit in the event buffer.
+  uint64_t droppedEvents;
+};
+
+//! The global state of the profiler; this is only used under the mutex.
+struct ProfilerState
+{
+  ProfilerState() : enabled(false), epoch(steady_clock::now())
+  {
+    // These must match the order of the ProfileCounter enum.
+    counterNames.push_back("base_cases");
+    counterNames.push_back("prunes");
+    counterNames.push_back("node_visits");
+  }
+
+  mutex stateMutex;
+  vector<string> regionNames;
+  vector<string> counterNames;
+  vector<unique_ptr<ThreadProfile>> threads;
+  atomic<bool> enabled;
+  steady_clock::time_point epoch;
+};
+
+ProfilerState& State()
+{
+  static ProfilerState state;
+  return state;
+}
+
+//! Get the profile of the calling thread, creating it if needed.
+ThreadProfile& ThreadData()
+{
+  static thread_local ThreadProfile* profile = NULL;
+  if (profile == NULL)
+  {
+    ProfilerState& state = State();
+    lock_guard<mutex> lock(state.stateMutex);
+    state.threads.emplace_back(new ThreadProfile(state.threads.size()));
+    profile = state.threads.back().get();
+  }
+
+  return *profile;
+}
+
+//! Register a name in the given list, returning its index.
+size_t Register(vector<string>& names, const string& name)
+{
+  for (size_t i = 0; i < names.size(); ++i)
+    if (names[i] == name)
+      return i;
+
+  names.push_back(name);
+  return names.size() - 1;
+}
+
+//! Escape a string for use in JSON.
+string Escape(const string& str)
+{
+  ostringstream oss;
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      oss << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      oss << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+    else
+      oss << c;
+  }
+
+  return oss.str();
+}
+
+//! A node of the region tree merged over all threads.
+struct MergedNode
+{
+  MergedNode() : calls(0), total(0) { }
+
+  uint64_t calls;
+  nanoseconds total;
+  map<size_t, MergedNode> children;
+};
+
+//! Add a subtree of one thread to the merged tree.
+void Merge(const ThreadProfile& profile,
+           const size_t node,
+           MergedNode& merged)
+{
+  for (const size_t child : profile.nodes[node].children)
+  {
+    const ProfileNode& p = profile.nodes[child];
+    MergedNode& m = merged.children[p.region];
+    m.calls += p.calls;
+    m.total += p.total;
+    Merge(profile, child, m);
+  }
+}
+
+//! Write the children of a merged node as a JSON array.
+void WriteRegions(ostream& out,
+                  const MergedNode& node,
+                  const vector<string>& names,
+                  const size_t indent)
+{
+  const string pad(indent, ' ');
+  out << "[";
+  bool first = true;
+  for (const auto& child : node.children)
+  {
+    out << (first ? "\n" : ",\n") << pad << "  {\"name\": \""
+        << Escape(names[child.first]) << "\", \"calls\": "
+        << child.second.calls << ", \"total_us\": "
+        << duration_cast<microseconds>(child.second.total).count()
+        << ", \"children\": ";
+    WriteRegions(out, child.second, names, indent + 2);
+    out << "}";
+    first = false;
+  }
+
+  if (!first)
+    out << "\n" << pad;
+  out << "]";
+}
+
+} // anonymous namespace
+
+size_t Profiler::RegisterRegion(const string& name)
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.stateMutex);
+  return Register(state.regionNames, name);
+}
+
+size_t Profiler::RegisterCounter(const string& name)
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.stateMutex);
+  return Register(state.counterNames, name);
+}
+
+void Profiler::Add(const size_t counter, const uint64_t amount)
+{
+  if (!State().enabled.load(memory_order_relaxed))
+    return;
+
+  ThreadProfile& profile = ThreadData();
+  if (counter >= profile.counters.size())
+    profile.counters.resize(counter + 1, 0);
+  profile.counters[counter] += amount;
+}
+
+void Profiler::Enter(const size_t region)
+{
+  ThreadProfile& profile = ThreadData();
+
+  // Find the node of this region below the current one.
+  size_t node = size_t(-1);
+  for (const size_t child : profile.nodes[profile.current].children)
+  {
+    if (profile.nodes[child].region == region)
+    {
+      node = child;
+      break;
+    }
+  }
+
+  if (node == size_t(-1))
+  {
+    node = profile.nodes.size();
+    profile.nodes.push_back(ProfileNode(region, profile.current));
+    profile.nodes[profile.current].children.push_back(node);
+  }
+
+  profile.current = node;
+  profile.startTimes.push_back(steady_clock::now());
+}
+
+void Profiler::Leave()
+{
+  const steady_clock::time_point end = steady_clock::now();
+  ThreadProfile& profile = ThreadData();
+
+  // Ignore unbalanced calls (for instance, after a Reset()).
+  if (profile.current == 0 || profile.startTimes.empty())
+    return;
+
+  const steady_clock::time_point start = profile.startTimes.back();
+  profile.startTimes.pop_back();
+
+  ProfileNode& node = profile.nodes[profile.current];
+  const nanoseconds duration = duration_cast<nanoseconds>(end - start);
+  ++node.calls;
+  node.total += duration;
+
+  if (profile.events.size() < maxEventsPerThread)
+  {
+    TraceEvent event;
+    event.region = node.region;
+    event.start = duration_cast<nanoseconds>(start - State().epoch);
+    event.duration = duration;
+    profile.events.push_back(event);
+  }
+  else
+  {
+    ++profile.droppedEvents;
+  }
+
+  profile.current = node.parent;
+}
+
+void Profiler::Enable()
+{
+  State().enabled = true;
+}
+
+void Profiler::Disable()
+{
+  State().enabled = false;
+}
+
+bool Profiler::Enabled()
+{
+  return State().enabled.load(memory_order_relaxed);
+}
+
+void Profiler::Reset()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.stateMutex);
+  for (auto& profile : state.threads)
+    profile->Clear();
+}
+
+uint64_t Profiler::CounterValue(const size_t counter)
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.stateMutex);
+
+  uint64_t total = 0;
+  for (const auto& profile : state.threads)
+    if (counter < profile->counters.size())
+      total += profile->counters[counter];
+
+  return total;
+}
+
+string Profiler::ToJSON()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.stateMutex);
+
+  MergedNode root;
+  vector<uint64_t> counters(state.counterNames.size(), 0);
+  uint64_t droppedEvents = 0;
+  for (const auto& profile : state.threads)
+  {
+    Merge(*profile, 0, root);
+    // Ignore the ids of counters that were never registered.
+    const size_t numCounters = std::min(profile->counters.size(),
+        counters.size());
+    for (size_t i = 0; i < numCounters; ++i)
+      counters[i] += profile->counters[i];
+    droppedEvents += profile->droppedEvents;
+  }
+
+  ostringstream out;
+  out << "{\n  \"threads\": " << state.threads.size() << ",\n";
+  out << "  \"dropped_events\": " << droppedEvents << ",\n";
+  out << "  \"counters\": {";
+  for (size_t i = 0; i < counters.size(); ++i)
+  {
+    out << (i == 0 ? "\n" : ",\n") << "    \""
+        << Escape(state.counterNames[i]) << "\": " << counters[i];
+  }
+  out << (counters.empty() ? "},\n" : "\n  },\n");
+  out << "  \"regions\": ";
+  WriteRegions(out, root, state.regionNames, 2);
+  out << "\n}\n";
+
+  return out.str();
+}
+
+string Profiler::ToChromeTrace()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.stateMutex);
+
+  ostringstream out;
+  out << fixed << setprecision(3);
+  out << "{\"traceEvents\": [";
+  bool first = true;
+  vector<uint64_t> counters(state.counterNames.size(), 0);
+  for (const auto& profile : state.threads)
+  {
+    for (const TraceEvent& event : profile->events)
+    {
+      out << (first ? "\n" : ",\n") << "  {\"name\": \""
+          << Escape(state.regionNames[event.region])
+          << "\", \"cat\": \"mlpack\", \"ph\": \"X\", \"ts\": "
+          << (event.start.count() / 1000.0) << ", \"dur\": "
+          << (event.duration.count() / 1000.0) << ", \"pid\": 0, \"tid\": "
+          << profile->index << "}";
+      first = false;
+    }
+
+    // Ignore the ids of counters that were never registered.
+    const size_t numCounters = std::min(profile->counters.size(),
+        counters.size());
+    for (size_t i = 0; i < numCounters; ++i)
+      counters[i] += profile->counters[i];
+  }
+
+  // Counters don't have a time, so they are stored as metadata.
+  out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {";
+  for (size_t i = 0; i < counters.size(); ++i)
+  {
+    out << (i == 0 ? "" : ", ") << "\"" << Escape(state.counterNames[i])
+        << "\": \"" << counters[i] << "\"";
+  }
+  out << "}}\n";
+
+  return out.str();
+}
+
+bool Profiler::Save(const string& filename, const string& format)
+{
+  const string output = (format == "chrome") ? ToChromeTrace() : ToJSON();
+
+  ofstream ofs(filename);
+  if (!ofs.is_open())
+    return false;
+
+  ofs << output;
+  return ofs.good();
+}
@@ -0,0 +1,185 @@
+/**
+ * @file profiler.hpp
+ *
+ * A low-overhead hierarchical profiler for mlpack.  Unlike Timer, which looks
+ * up a named timer in a global map under a mutex on every call, the profiler
+ * keeps all of its state in thread-local storage and identifies regions and
+ * counters by pre-registered integer IDs, so it can be used inside hot loops
+ * and OpenMP regions.  The per-thread results are merged when they are
+ * exported.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PROFILER_HPP
+#define MLPACK_CORE_UTIL_PROFILER_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace mlpack {
+
+/**
+ * IDs of the counters that are always registered with the profiler.  Other
+ * counters can be added with Profiler::RegisterCounter().
+ */
+enum ProfileCounter
+{
+  //! Number of base cases (point-to-point computations) evaluated.
+  BaseCasesCounter = 0,
+  //! Number of nodes (or node combinations) pruned during traversals.
+  PrunesCounter,
+  //! Number of nodes (or node combinations) visited and scored.
+  NodeVisitsCounter
+};
+
+/**
+ * The Profiler class collects timings of nested regions and values of counters
+ * for every thread, without any locking on the hot path.  Regions and counters
+ * are registered once by name, which returns an ID; afterwards, entering a
+ * region (through a ProfileScope object) or incrementing a counter only
+ * touches thread-local data.
+ *
+ * Regions are hierarchical: a region entered while another one is active on
+ * the same thread is recorded as its child, so the exported profile is a tree
+ * of regions with call counts and total times.  Each completed region is also
+ * recorded as an event, so the profile can be exported in the Chrome trace
+ * format (viewable in chrome://tracing or Perfetto).
+ *
+ * The profiler is disabled by default, in which case entering regions and
+ * incrementing counters does nothing.  Command-line programs enable it when
+ * the --profile option is given.
+ *
+ * @code
+ * static const size_t region = Profiler::RegisterRegion("bootstrap");
+ * #pragma omp parallel for
+ * for (omp_size_t i = 0; i < n; ++i)
+ * {
+ *   ProfileScope scope(region);
+ *   ...
+ *   Profiler::Add(BaseCasesCounter, baseCases);
+ * }
+ * @endcode
+ */
+class Profiler
+{
+ public:
+  /**
+   * Register a region with the given name and return its ID.  Registering the
+   * same name twice gives the same ID.  This takes a lock, so it should be done
+   * once (for instance, by initializing a function-local static variable).
+   *
+   * @param name Name of the region.
+   */
+  static size_t RegisterRegion(const std::string& name);
+
+  /**
+   * Register a counter with the given name and return its ID.  Registering the
+   * same name twice gives the same ID.  The counters in the ProfileCounter
+   * enum are always registered.
+   *
+   * @param name Name of the counter.
+   */
+  static size_t RegisterCounter(const std::string& name);
+
+  /**
+   * Add the given amount to a counter of the calling thread.
+   *
+   * @param counter ID of the counter.
+   * @param amount Amount to add.
+   */
+  static void Add(const size_t counter, const uint64_t amount = 1);
+
+  /**
+   * Enter the given region on the calling thread.  Prefer ProfileScope, which
+   * makes sure the region is left.
+   */
+  static void Enter(const size_t region);
+
+  /**
+   * Leave the innermost region of the calling thread.
+   */
+  static void Leave();
+
+  //! Enable the profiler.  Do not call this while regions are active.
+  static void Enable();
+  //! Disable the profiler.  Do not call this while regions are active.
+  static void Disable();
+  //! Return whether or not the profiler is enabled.
+  static bool Enabled();
+
+  /**
+   * Forget all recorded timings, events and counter values.  Registered
+   * regions and counters are kept.  Do not call this while regions are active.
+   */
+  static void Reset();
+
+  /**
+   * Get the total value of a counter, summed over all threads.
+   *
+   * @param counter ID of the counter.
+   */
+  static uint64_t CounterValue(const size_t counter);
+
+  /**
+   * Get the merged profile as a JSON document: the tree of regions with call
+   * counts and total times (summed over threads), and the values of all
+   * counters.
+   */
+  static std::string ToJSON();
+
+  /**
+   * Get all recorded region events in the Chrome trace event format.  Each
+   * thread keeps at most a fixed number of events; later events are dropped
+   * (but still counted in the JSON summary).
+   */
+  static std::string ToChromeTrace();
+
+  /**
+   * Save the profile to the given file.
+   *
+   * @param filename File to save to.
+   * @param format Either "json" (for ToJSON()) or "chrome" (for
+   *     ToChromeTrace()).
+   * @return Whether the file could be written.
+   */
+  static bool Save(const std::string& filename,
+                   const std::string& format = "json");
+};
+
+/**
+ * Enter a profiler region for the lifetime of this object.  This does nothing
+ * if the profiler is disabled when the object is created.
+ */
+class ProfileScope
+{
+ public:
+  //! Enter the given region.
+  ProfileScope(const size_t region) : active(Profiler::Enabled())
+  {
+    if (active)
+      Profiler::Enter(region);
+  }
+
+  //! Leave the region.
+  ~ProfileScope()
+  {
+    if (active)
+      Profiler::Leave();
+  }
+
+ private:
+  // Scopes can't be copied.
+  ProfileScope(const ProfileScope&);
+  ProfileScope& operator=(const ProfileScope&);
+
+  //! Whether a region was entered.
+  bool active;
+};
+
+} // namespace mlpack
+
+#endif
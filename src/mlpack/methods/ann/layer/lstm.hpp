@@ -43,6 +43,14 @@ namespace ann /** Artificial Neural Network. */ {
  * }
  * @endcode
  *
+ * The products of all four gates with the input and with the previous output
+ * are each computed with a single matrix multiplication over the whole batch,
+ * using fused copies of the gate weights, and the activations of the gates,
+ * the cell and the output are then computed in one pass; the backward pass
+ * likewise propagates the errors of all gates with one multiplication.  The
+ * storage for the backpropagation through time is allocated once for the
+ * longest sequence seen, and reused afterwards.
+ *
  * \see FastLSTM for a faster LSTM version which combines the calculation of the
  * input, forget, output gates and hidden state in a single step.
  *
@@ -168,6 +176,12 @@ class LSTM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Copy the weights of the gates into fusedInputWeight, fusedOutputWeight and
+   * fusedBias.
+   */
+  void FuseWeights();
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -250,17 +264,25 @@ class LSTM
   //! Weights between cell and output gate.
   OutputDataType cell2GateOutputWeight;
 
-  //! Locally-stored input gate parameter.
-  OutputDataType inputGate;
+  //! Input weights of the output, forget, input gates and hidden layer,
+  //! stacked in this order.
+  OutputDataType fusedInputWeight;
+
+  //! Output (recurrent) weights of the gates, stacked like fusedInputWeight.
+  OutputDataType fusedOutputWeight;
 
-  //! Locally-stored forget gate parameter.
-  OutputDataType forgetGate;
+  //! Biases of the gates, stacked like fusedInputWeight.
+  OutputDataType fusedBias;
 
-  //! Locally-stored hidden layer parameter.
-  OutputDataType hiddenLayer;
+  //! Pre-activations of all the gates for the current step.
+  OutputDataType gates;
 
-  //! Locally-stored output gate parameter.
-  OutputDataType outputGate;
+  //! Errors of all the gates for the current step, stacked like
+  //! fusedInputWeight.
+  OutputDataType gateError;
+
+  //! Gradient of the fused input or output weights.
+  OutputDataType fusedGradient;
 
   //! Locally-stored input gate activation.
   OutputDataType inputGateActivation;
@@ -289,12 +311,6 @@ class LSTM
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
-  //! Locally-stored forget gate error.
-  OutputDataType forgetGateError;
-
-  //! Locally-stored output gate error.
-  OutputDataType outputGateError;
-
   //! Locally-stored previous error.
   OutputDataType prevError;
 
@@ -304,12 +320,6 @@ class LSTM
   //! Locally-stored input cell error parameter.
   OutputDataType inputCellError;
 
-  //! Locally-stored input gate error.
-  OutputDataType inputGateError;
-
-  //! Locally-stored hidden layer error.
-  OutputDataType hiddenError;
-
   //! Locally-stored current rho size.
   size_t rhoSize;
 
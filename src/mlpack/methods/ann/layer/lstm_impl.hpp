@@ -60,21 +60,22 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   backwardStep = batchSize * size - 1;
   gradientStep = batchSize * size - 1;
 
+  // The storage is only reallocated when a longer sequence (or a larger batch)
+  // is seen.
   const size_t rhoBatchSize = size * batchSize;
-  if (inputGate.is_empty() || inputGate.n_cols < rhoBatchSize)
+  gates.set_size(4 * outSize, batchSize);
+  gateError.set_size(4 * outSize, batchSize);
+  inputCellError.set_size(outSize, batchSize);
+  if (inputGateActivation.is_empty() ||
+      inputGateActivation.n_cols < rhoBatchSize)
   {
-    inputGate.set_size(outSize, rhoBatchSize);
-    forgetGate.set_size(outSize, rhoBatchSize);
-    hiddenLayer.set_size(outSize, rhoBatchSize);
-    outputGate.set_size(outSize, rhoBatchSize);
-
     inputGateActivation.set_size(outSize, rhoBatchSize);
     forgetGateActivation.set_size(outSize, rhoBatchSize);
     outputGateActivation.set_size(outSize, rhoBatchSize);
     hiddenLayerActivation.set_size(outSize, rhoBatchSize);
 
     cellActivation.set_size(outSize, rhoBatchSize);
-    prevError.set_size(4 * outSize, batchSize);
+    prevError.set_size(outSize, batchSize);
 
     if (cell.is_empty())
     {
@@ -159,6 +160,29 @@ void LSTM<InputDataType, OutputDataType>::Reset()
       offset, outSize, 1, false, false);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::FuseWeights()
+{
+  fusedInputWeight.set_size(4 * outSize, inSize);
+  fusedOutputWeight.set_size(4 * outSize, outSize);
+  fusedBias.set_size(4 * outSize, 1);
+
+  fusedInputWeight.rows(0, outSize - 1) = input2GateOutputWeight;
+  fusedInputWeight.rows(outSize, 2 * outSize - 1) = input2GateForgetWeight;
+  fusedInputWeight.rows(2 * outSize, 3 * outSize - 1) = input2GateInputWeight;
+  fusedInputWeight.rows(3 * outSize, 4 * outSize - 1) = input2HiddenWeight;
+
+  fusedOutputWeight.rows(0, outSize - 1) = output2GateOutputWeight;
+  fusedOutputWeight.rows(outSize, 2 * outSize - 1) = output2GateForgetWeight;
+  fusedOutputWeight.rows(2 * outSize, 3 * outSize - 1) = output2GateInputWeight;
+  fusedOutputWeight.rows(3 * outSize, 4 * outSize - 1) = output2HiddenWeight;
+
+  fusedBias.rows(0, outSize - 1) = input2GateOutputBias;
+  fusedBias.rows(outSize, 2 * outSize - 1) = input2GateForgetBias;
+  fusedBias.rows(2 * outSize, 3 * outSize - 1) = input2GateInputBias;
+  fusedBias.rows(3 * outSize, 4 * outSize - 1) = input2HiddenBias;
+}
+
 // Forward when cellState is not needed.
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename OutputType>
@@ -187,90 +211,68 @@ void LSTM<InputDataType, OutputDataType>::Forward(InputType&& input,
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
-      forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
+  // The weights do not change during a sequence, so they only need to be
+  // fused at its beginning.
+  if (forwardStep == 0)
+    FuseWeights();
 
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
+  // Compute the products of all gates with the input and the previous output.
+  gates = fusedInputWeight * input + fusedOutputWeight * outParameter.cols(
       forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
+  gates.each_col() += fusedBias;
 
-  if (forwardStep > 0)
+  if (forwardStep > 0 && useCellState)
   {
-    if (useCellState)
+    if (!cellState.is_empty())
     {
-      if (!cellState.is_empty())
-      {
-        cell.cols(forwardStep - batchSize,
-            forwardStep - batchSize + batchStep) = cellState;
-      }
-      else
-      {
-        throw std::runtime_error("Cell parameter is empty.");
-      }
+      cell.cols(forwardStep - batchSize,
+          forwardStep - batchSize + batchStep) = cellState;
+    }
+    else
+    {
+      throw std::runtime_error("Cell parameter is empty.");
     }
-    inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-
-    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
 
-  inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
-
-  forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
-
-  hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
-
-  if (forwardStep == 0)
+  // Compute the activations of the gates, the cell and the output in a single
+  // pass.  The input and forget gates see the previous cell, the output gate
+  // sees the new cell.
+  typedef typename OutputDataType::elem_type ElemType;
+  for (size_t b = 0; b < batchSize; ++b)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep)
-        + inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
-      forwardStep + batchStep).each_col() % cell2GateOutputWeight;
-
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
-
-  outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
-
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
+    const size_t col = forwardStep + b;
+    const ElemType* gate = gates.colptr(b);
+    const ElemType* prevCell = (forwardStep > 0) ?
+        cell.colptr(col - batchSize) : NULL;
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      ElemType inputValue = gate[2 * outSize + j];
+      ElemType forgetValue = gate[outSize + j];
+      if (prevCell)
+      {
+        inputValue += cell2GateInputWeight[j] * prevCell[j];
+        forgetValue += cell2GateForgetWeight[j] * prevCell[j];
+      }
 
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) =
-      cellActivation.cols(forwardStep, forwardStep + batchStep) %
-      outputGateActivation.cols(forwardStep, forwardStep + batchStep);
+      const ElemType inputActivation = 1.0 / (1.0 + std::exp(-inputValue));
+      const ElemType forgetActivation = 1.0 / (1.0 + std::exp(-forgetValue));
+      const ElemType hiddenActivation = std::tanh(gate[3 * outSize + j]);
+      const ElemType cellValue = prevCell ? (forgetActivation * prevCell[j] +
+          inputActivation * hiddenActivation) :
+          (inputActivation * hiddenActivation);
+      const ElemType outputActivation = 1.0 / (1.0 + std::exp(-(gate[j] +
+          cell2GateOutputWeight[j] * cellValue)));
+      const ElemType cellValueActivation = std::tanh(cellValue);
+
+      inputGateActivation(j, col) = inputActivation;
+      forgetGateActivation(j, col) = forgetActivation;
+      hiddenLayerActivation(j, col) = hiddenActivation;
+      outputGateActivation(j, col) = outputActivation;
+      cell(j, col) = cellValue;
+      cellActivation(j, col) = cellValueActivation;
+      outParameter(j, col + batchSize) = outputActivation * cellValueActivation;
+    }
+  }
 
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
@@ -290,62 +292,54 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Backward(
   const InputType&& /* input */, ErrorType&& gy, GradientType&& g)
 {
-  if (gradientStepIdx > 0)
+  // Compute the errors of all the gates, and the error of the cell that is
+  // passed to the previous step, in a single pass.
+  typedef typename OutputDataType::elem_type ElemType;
+  for (size_t b = 0; b < batchSize; ++b)
   {
-    gy += prevError;
-  }
-
-  outputGateError =
-      gy % cellActivation.cols(backwardStep - batchStep, backwardStep) %
-      (outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - outputGateActivation.cols(backwardStep - batchStep,
-      backwardStep)));
-
-  OutputDataType cellError = gy %
-      outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep -
-      batchStep, backwardStep), 2)) + outputGateError.each_col() %
-      cell2GateOutputWeight;
-
-  if (gradientStepIdx > 0)
-  {
-    cellError += inputCellError;
-  }
-
-  if (backwardStep > batchStep)
-  {
-    forgetGateError = cell.cols((backwardStep - batchSize) - batchStep,
-      (backwardStep - batchSize)) % cellError % (forgetGateActivation.cols(
-      backwardStep - batchStep, backwardStep) % (1.0 -
-      forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
-  }
-  else
-  {
-    forgetGateError.zeros();
+    const size_t col = backwardStep - batchStep + b;
+    const ElemType* prevCell = (backwardStep > batchStep) ?
+        cell.colptr(col - batchSize) : NULL;
+    ElemType* error = gateError.colptr(b);
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      ElemType outputError = gy(j, b);
+      if (gradientStepIdx > 0)
+        outputError += prevError(j, b);
+
+      const ElemType inputActivation = inputGateActivation(j, col);
+      const ElemType forgetActivation = forgetGateActivation(j, col);
+      const ElemType hiddenActivation = hiddenLayerActivation(j, col);
+      const ElemType outputActivation = outputGateActivation(j, col);
+      const ElemType cellValueActivation = cellActivation(j, col);
+
+      const ElemType outputGateError = outputError * cellValueActivation *
+          outputActivation * (1.0 - outputActivation);
+      ElemType cellError = outputError * outputActivation *
+          (1.0 - cellValueActivation * cellValueActivation) +
+          outputGateError * cell2GateOutputWeight[j];
+      if (gradientStepIdx > 0)
+        cellError += inputCellError(j, b);
+
+      const ElemType forgetGateError = prevCell ? (prevCell[j] * cellError *
+          forgetActivation * (1.0 - forgetActivation)) : 0.0;
+      const ElemType inputGateError = hiddenActivation * cellError *
+          inputActivation * (1.0 - inputActivation);
+      const ElemType hiddenError = inputActivation * cellError *
+          (1.0 - hiddenActivation * hiddenActivation);
+
+      error[j] = outputGateError;
+      error[outSize + j] = forgetGateError;
+      error[2 * outSize + j] = inputGateError;
+      error[3 * outSize + j] = hiddenError;
+
+      inputCellError(j, b) = forgetActivation * cellError + forgetGateError *
+          cell2GateForgetWeight[j] + inputGateError * cell2GateInputWeight[j];
+    }
   }
 
-  inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError %
-      (inputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - inputGateActivation.cols(backwardStep - batchStep, backwardStep)));
-
-  hiddenError = inputGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError % (1 - arma::pow(hiddenLayerActivation.cols(
-      backwardStep - batchStep, backwardStep), 2));
-
-  inputCellError = forgetGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError + forgetGateError.each_col() %
-      cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
-
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
-
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = fusedInputWeight.t() * gateError;
+  prevError = fusedOutputWeight.t() * gateError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
@@ -361,65 +355,35 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Gradient(
     InputType&& input, ErrorType&& /* error */, GradientType&& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
+  // The gradients of the input weights and biases of each gate are stored
+  // next to each other, in the same order as the rows of gateError.
+  const size_t gateSize = input2GateOutputWeight.n_elem +
+      input2GateOutputBias.n_elem;
+  fusedGradient = gateError * input.t();
+  for (size_t k = 0; k < 4; ++k)
+  {
+    const size_t offset = k * gateSize;
+    gradient.submat(offset, 0, offset + outSize * inSize - 1, 0) =
+        arma::vectorise(fusedGradient.rows(k * outSize, (k + 1) * outSize - 1));
+    gradient.submat(offset + outSize * inSize, 0, offset + gateSize - 1, 0) =
+        arma::sum(gateError.rows(k * outSize, (k + 1) * outSize - 1), 1);
+  }
+  size_t offset = 4 * gateSize;
 
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
+  // The gradients of the output weights of each gate follow, in the same
+  // order.
+  fusedGradient = gateError *
+      outParameter.cols(gradientStep - batchStep, gradientStep).t();
+  for (size_t k = 0; k < 4; ++k)
+  {
+    gradient.submat(offset, 0, offset + outSize * outSize - 1, 0) =
+        arma::vectorise(fusedGradient.rows(k * outSize, (k + 1) * outSize - 1));
+    offset += outSize * outSize;
+  }
 
   // Cell2GateOutputWeight gradients.
   gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      arma::sum(outputGateError %
+      arma::sum(gateError.rows(0, outSize - 1) %
       cell.cols(gradientStep - batchStep, gradientStep), 1);
   offset += cell2GateOutputWeight.n_elem;
 
@@ -427,12 +391,12 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
   if (gradientStep > batchStep)
   {
     gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        arma::sum(forgetGateError %
+        arma::sum(gateError.rows(outSize, 2 * outSize - 1) %
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
     gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
         cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        arma::sum(inputGateError %
+        arma::sum(gateError.rows(2 * outSize, 3 * outSize - 1) %
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
   }
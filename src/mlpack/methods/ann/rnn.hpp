@@ -33,6 +33,16 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * The network may be trained on sequences of different lengths, by padding
+ * them to the same number of slices and passing the length of each sequence to
+ * Train().  In this case the sequences are bucketed by length, so that each
+ * batch holds sequences of similar lengths, the forward and backward recursion
+ * of a batch stop after its longest sequence, and the steps past the end of
+ * each sequence are masked out of the objective and the gradient.  This
+ * requires that the recurrent layers in the network support ResetCell() (e.g.
+ * LSTM, FastLSTM and GRU); Train() throws if the network holds a Recurrent
+ * layer and some sequences are shorter than rho.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -128,6 +138,36 @@ class RNN
   template<typename OptimizerType = ens::StandardSGD>
   double Train(arma::cube predictors, arma::cube responses);
 
+  /**
+   * Train the recurrent neural network on sequences of different lengths using
+   * the given optimizer.  The sequences are padded to the same number of
+   * slices, and the length of each sequence is given; the padding is ignored.
+   * The sequences are sorted by length before training, so that each batch
+   * holds sequences of similar lengths and the recursion of each batch can
+   * stop after its longest sequence.  Shuffle() then shuffles the order of
+   * the batches (if the optimizer has a BatchSize()) and the order of the
+   * sequences of the same length.
+   *
+   * If the network predicts only the last element of each sequence (single is
+   * true), the output of each sequence is compared with the first slice of its
+   * responses after its last step.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param sequenceLengths Number of steps of each sequence (between 1 and
+   *     rho).
+   * @return The final objective of the trained model (NaN or Inf on error).
+   * @throw std::invalid_argument if the network holds a Recurrent layer and
+   *     some sequences are shorter than rho.
+   */
+  template<typename OptimizerType>
+  double Train(arma::cube predictors,
+               arma::cube responses,
+               OptimizerType& optimizer,
+               arma::Row<size_t> sequenceLengths);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -262,6 +302,12 @@ class RNN
   //! Modify the matrix of data points (predictors).
   arma::cube& Predictors() { return predictors; }
 
+  //! Get the length of each sequence (empty if all sequences have rho steps).
+  const arma::Row<size_t>& SequenceLengths() const { return sequenceLengths; }
+  //! Modify the length of each sequence (empty if all sequences have rho
+  //! steps).
+  arma::Row<size_t>& SequenceLengths() { return sequenceLengths; }
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -293,6 +339,54 @@ class RNN
    */
   void ResetCells();
 
+  /**
+   * Reset the state of RNN cells in the network for a new input sequence with
+   * the given number of steps.
+   *
+   * @param steps Number of steps of the sequence.
+   */
+  void ResetCells(const size_t steps);
+
+  /**
+   * Sort the sequences by length, in a random order among sequences of the
+   * same length.
+   *
+   * @param shuffleBatches Whether to shuffle the order of the batches of
+   *     bucketBatchSize sequences after sorting.
+   */
+  void BucketSequences(const bool shuffleBatches);
+
+  /**
+   * Get the number of steps of the given batch: the length of its longest
+   * sequence, or rho if the sequences have no lengths.
+   */
+  size_t BatchSteps(const size_t begin, const size_t batchSize) const;
+
+  /**
+   * Find the columns of the batch that contribute to the output of the given
+   * step, and store them in activeColumns.  Returns false if the sequences
+   * have no lengths, in which case every column contributes.
+   */
+  bool StepMask(const size_t begin, const size_t batchSize, const size_t step);
+
+  /**
+   * Evaluate the output layer on the current output of the network, for the
+   * given step of the batch.
+   */
+  double OutputLoss(const size_t begin,
+                    const size_t batchSize,
+                    const size_t step,
+                    const size_t responseSeq);
+
+  /**
+   * Compute the error of the output layer on the current output of the
+   * network for the given step of the batch, and store it in error.
+   */
+  void OutputError(const size_t begin,
+                   const size_t batchSize,
+                   const size_t step,
+                   const size_t responseSeq);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -351,12 +445,22 @@ class RNN
   //! The matrix of responses to the input data points.
   arma::cube responses;
 
+  //! The length of each sequence (empty if all sequences have rho steps).
+  arma::Row<size_t> sequenceLengths;
+
+  //! The columns of the current batch that contribute to the current step.
+  arma::uvec activeColumns;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
+  //! The number of sequences in each batch shuffled by Shuffle() (0 if the
+  //! optimizer has no batch size).
+  size_t bucketBatchSize;
+
   //! The current error for the backward pass.
   arma::mat error;
 
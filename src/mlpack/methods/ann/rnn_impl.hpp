@@ -25,11 +25,38 @@
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include <boost/serialization/variant.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
+/**
+ * This gives us a HasBatchSizeCheck object that we can use to tell whether or
+ * not an optimizer has a BatchSize() member.
+ */
+HAS_MEM_FUNC(BatchSize, HasBatchSizeCheck);
+
+//! Get the batch size of the given optimizer, if it has one.
+template<typename OptimizerType>
+size_t OptimizerBatchSize(
+    const OptimizerType& optimizer,
+    const typename std::enable_if_t<HasBatchSizeCheck<OptimizerType,
+        size_t(OptimizerType::*)() const>::value>* = 0)
+{
+  return optimizer.BatchSize();
+}
+
+//! Return 0 for optimizers without a batch size.
+template<typename OptimizerType>
+size_t OptimizerBatchSize(
+    const OptimizerType& /* optimizer */,
+    const typename std::enable_if_t<!HasBatchSizeCheck<OptimizerType,
+        size_t(OptimizerType::*)() const>::value>* = 0)
+{
+  return 0;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
@@ -46,6 +73,7 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     reset(false),
     single(single),
     numFunctions(0),
+    bucketBatchSize(0),
     deterministic(true)
 {
   /* Nothing to do here */
@@ -73,6 +101,78 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  this->sequenceLengths.clear();
+
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+  {
+    ResetParameters();
+  }
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::cube predictors,
+    arma::cube responses,
+    OptimizerType& optimizer,
+    arma::Row<size_t> sequenceLengths)
+{
+  if (sequenceLengths.n_elem != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RNN::Train(): number of sequence lengths ("
+        << sequenceLengths.n_elem << ") does not match number of sequences ("
+        << predictors.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t i = 0; i < sequenceLengths.n_elem; ++i)
+  {
+    if (sequenceLengths[i] == 0 || sequenceLengths[i] > rho ||
+        sequenceLengths[i] > predictors.n_slices)
+    {
+      std::ostringstream oss;
+      oss << "RNN::Train(): length of sequence " << i << " ("
+          << sequenceLengths[i] << ") must be between 1 and " << std::min(rho,
+          size_t(predictors.n_slices)) << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // A Recurrent layer has no ResetCell(), so its recursion can't stop before
+  // rho steps.
+  if (arma::min(sequenceLengths) < rho)
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      if (boost::get<Recurrent<arma::mat, arma::mat>*>(&network[i]) != NULL)
+      {
+        throw std::invalid_argument("RNN::Train(): sequences shorter than rho "
+            "are not supported by the Recurrent layer!");
+      }
+    }
+  }
+
+  numFunctions = responses.n_cols;
+
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->sequenceLengths = std::move(sequenceLengths);
+  bucketBatchSize = OptimizerBatchSize(optimizer);
+  BucketSequences(false);
 
   this->deterministic = true;
   ResetDeterministic();
@@ -96,13 +196,164 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetCells()
+{
+  ResetCells(rho);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetCells(const size_t steps)
 {
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ResetCellVisitor(rho), network[i]);
+    boost::apply_visitor(ResetCellVisitor(steps), network[i]);
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BucketSequences(const bool shuffleBatches)
+{
+  // Shuffle first, so that the stable sort keeps sequences of the same length
+  // in a random order.
+  const arma::uvec shuffled = arma::shuffle(arma::linspace<arma::uvec>(0,
+      sequenceLengths.n_elem - 1, sequenceLengths.n_elem));
+  const arma::Row<size_t> shuffledLengths = sequenceLengths.cols(shuffled);
+  arma::uvec order = shuffled(arma::stable_sort_index(shuffledLengths));
+
+  // Shuffle the order of the batches, so that the short sequences are not
+  // always visited first.  A smaller last batch is kept at the end, so that
+  // the other batches stay aligned with the batches of the optimizer.
+  const size_t numBatches = (bucketBatchSize == 0) ? 0 :
+      order.n_elem / bucketBatchSize;
+  if (shuffleBatches && numBatches > 1)
+  {
+    const arma::uvec batchOrder = arma::shuffle(
+        arma::linspace<arma::uvec>(0, numBatches - 1, numBatches));
+
+    arma::uvec newOrder(order);
+    for (size_t i = 0; i < numBatches; ++i)
+    {
+      newOrder.subvec(i * bucketBatchSize, (i + 1) * bucketBatchSize - 1) =
+          order.subvec(batchOrder[i] * bucketBatchSize,
+          (batchOrder[i] + 1) * bucketBatchSize - 1);
+    }
+    order = std::move(newOrder);
+  }
+
+  arma::cube newPredictors(predictors.n_rows, predictors.n_cols,
+      predictors.n_slices);
+  for (size_t s = 0; s < predictors.n_slices; ++s)
+    newPredictors.slice(s) = predictors.slice(s).cols(order);
+
+  arma::cube newResponses(responses.n_rows, responses.n_cols,
+      responses.n_slices);
+  for (size_t s = 0; s < responses.n_slices; ++s)
+    newResponses.slice(s) = responses.slice(s).cols(order);
+
+  predictors = std::move(newPredictors);
+  responses = std::move(newResponses);
+  sequenceLengths = arma::Row<size_t>(sequenceLengths.cols(order));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t RNN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::BatchSteps(const size_t begin,
+                                        const size_t batchSize) const
+{
+  if (sequenceLengths.is_empty())
+    return rho;
+
+  return std::min(rho, (size_t) arma::max(sequenceLengths.subvec(begin,
+      begin + batchSize - 1)));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::StepMask(
+    const size_t begin,
+    const size_t batchSize,
+    const size_t step)
+{
+  if (sequenceLengths.is_empty())
+    return false;
+
+  // If only the last element is predicted, a sequence contributes only at its
+  // last step; otherwise, it contributes at every step up to its length.
+  const arma::Row<size_t> lengths = sequenceLengths.subvec(begin,
+      begin + batchSize - 1);
+  if (single)
+    activeColumns = arma::find(lengths == (step + 1));
+  else
+    activeColumns = arma::find(lengths > step);
+
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+OutputLoss(const size_t begin,
+           const size_t batchSize,
+           const size_t step,
+           const size_t responseSeq)
+{
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  arma::mat target(responses.slice(responseSeq).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+
+  if (!StepMask(begin, batchSize, step) ||
+      activeColumns.n_elem == batchSize)
+  {
+    return outputLayer.Forward(std::move(output), std::move(target));
+  }
+  else if (activeColumns.is_empty())
+  {
+    return 0;
+  }
+
+  return outputLayer.Forward(std::move(arma::mat(output.cols(activeColumns))),
+      std::move(arma::mat(target.cols(activeColumns))));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+OutputError(const size_t begin,
+            const size_t batchSize,
+            const size_t step,
+            const size_t responseSeq)
+{
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  arma::mat target(responses.slice(responseSeq).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+
+  if (!StepMask(begin, batchSize, step) ||
+      activeColumns.n_elem == batchSize)
+  {
+    outputLayer.Backward(std::move(output), std::move(target),
+        std::move(error));
+    return;
+  }
+
+  // The columns of the sequences that do not contribute to this step get no
+  // error, so nothing is propagated through their padding.
+  error.zeros(output.n_rows, batchSize);
+  if (activeColumns.is_empty())
+    return;
+
+  arma::mat activeError;
+  outputLayer.Backward(std::move(arma::mat(output.cols(activeColumns))),
+      std::move(arma::mat(target.cols(activeColumns))),
+      std::move(activeError));
+  error.cols(activeColumns) = activeError;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
@@ -114,6 +365,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  this->sequenceLengths.clear();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -212,12 +464,14 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  // The recursion stops after the longest sequence of the batch.
+  const size_t steps = BatchSteps(begin, batchSize);
+  ResetCells(steps);
 
   double performance = 0;
   size_t responseSeq = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = 0; seqNum < steps; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
     arma::mat stepData(predictors.slice(seqNum).colptr(begin),
@@ -228,10 +482,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
       responseSeq = seqNum;
     }
 
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
+    performance += OutputLoss(begin, batchSize, seqNum, responseSeq);
   }
 
   if (outputSize == 0)
@@ -293,12 +544,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  // The recursion stops after the longest sequence of the batch.
+  const size_t steps = BatchSteps(begin, batchSize);
+  ResetCells(steps);
 
   double performance = 0;
   size_t responseSeq = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = 0; seqNum < steps; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
     arma::mat stepData(predictors.slice(seqNum).colptr(begin),
@@ -315,10 +568,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
           std::move(moduleOutputParameter)), network[l]);
     }
 
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
+    performance += OutputLoss(begin, batchSize, seqNum, responseSeq);
   }
 
   if (outputSize == 0)
@@ -336,7 +586,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   ResetGradients(currentGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = 0; seqNum < steps; ++seqNum)
   {
     currentGradient.zeros();
 
@@ -346,28 +596,22 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
           std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
     }
 
-    if (single && seqNum > 0)
+    if (single && seqNum > 0 && sequenceLengths.is_empty())
     {
       error.zeros();
     }
-    else if (single && seqNum == 0)
+    else if (single)
     {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(0).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
+      OutputError(begin, batchSize, steps - seqNum - 1, 0);
     }
     else
     {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(rho - seqNum - 1).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
+      OutputError(begin, batchSize, steps - seqNum - 1, steps - seqNum - 1);
     }
 
     Backward();
     Gradient(std::move(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
+        arma::mat(predictors.slice(steps - seqNum - 1).colptr(begin),
         predictors.n_rows, batchSize, false, true)));
     gradient += currentGradient;
   }
@@ -390,6 +634,14 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
+  // Sequences of different lengths are kept bucketed by length; only the
+  // order of the batches is shuffled.
+  if (!sequenceLengths.is_empty())
+  {
+    BucketSequences(true);
+    return;
+  }
+
   arma::cube newPredictors, newResponses;
   math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
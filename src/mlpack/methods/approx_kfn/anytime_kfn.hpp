@@ -0,0 +1,136 @@
+/**
+ * @file anytime_kfn.hpp
+ *
+ * An anytime tree-based furthest neighbor search: a best-first dual-tree
+ * traversal with a bounded queue that can be stopped after a given time, in
+ * which case the best furthest neighbors found so far are returned.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_APPROX_KFN_ANYTIME_KFN_HPP
+#define MLPACK_METHODS_APPROX_KFN_ANYTIME_KFN_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search_stat.hpp>
+#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The AnytimeKFN class searches for furthest neighbors with a kd-tree and the
+ * breadth-first dual-tree traverser, which visits the most promising node
+ * combinations first and holds at most a given number of them in its queues
+ * (the rest are traversed depth-first, see
+ * BinarySpaceTree::BreadthFirstDualTreeTraverser).  Without a time limit, the
+ * results are exact.  With a time limit, the traversal stops when the time is
+ * up; the neighbors found so far are then completed with the reference points
+ * that are furthest from the centroid of the reference set, so that k valid
+ * neighbors are always returned.
+ *
+ * @tparam MatType Type of the matrix to search.
+ */
+template<typename MatType = arma::mat>
+class AnytimeKFN
+{
+ public:
+  //! The type of tree that is used.
+  typedef tree::KDTree<metric::EuclideanDistance,
+                       NeighborSearchStat<FurthestNS>,
+                       MatType> Tree;
+
+  /**
+   * Construct the AnytimeKFN object but do not train it.  Be sure to call
+   * Train() before calling Search().
+   *
+   * @param maxQueueSize Maximum number of queued node combinations during the
+   *     traversal (0 means no limit).
+   * @param timeLimit Time limit of each search in seconds (0 means no limit).
+   */
+  AnytimeKFN(const size_t maxQueueSize = 1000000,
+             const double timeLimit = 0.0);
+
+  /**
+   * Construct the AnytimeKFN object with the given reference set (this is the
+   * set that will be searched).
+   *
+   * @param referenceSet Set of reference data.
+   * @param maxQueueSize Maximum number of queued node combinations during the
+   *     traversal (0 means no limit).
+   * @param timeLimit Time limit of each search in seconds (0 means no limit).
+   */
+  AnytimeKFN(const MatType& referenceSet,
+             const size_t maxQueueSize = 1000000,
+             const double timeLimit = 0.0);
+
+  //! Copy the given AnytimeKFN object.
+  AnytimeKFN(const AnytimeKFN& other);
+
+  //! Copy the given AnytimeKFN object.
+  AnytimeKFN& operator=(const AnytimeKFN& other);
+
+  //! Clean up the reference tree.
+  ~AnytimeKFN();
+
+  /**
+   * Build the reference tree on the given reference set.
+   *
+   * @param referenceSet Set of reference data.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Search for the k furthest neighbors of the given query set.  The results
+   * will be stored in the given neighbors and distances matrices, in the same
+   * format as the mlpack NeighborSearch class.  If the search was stopped by
+   * the time limit, TimedOut() will return true afterwards.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Get the maximum number of queued node combinations.
+  size_t MaxQueueSize() const { return maxQueueSize; }
+  //! Modify the maximum number of queued node combinations.
+  size_t& MaxQueueSize() { return maxQueueSize; }
+
+  //! Get the time limit of each search in seconds.
+  double TimeLimit() const { return timeLimit; }
+  //! Modify the time limit of each search in seconds.
+  double& TimeLimit() { return timeLimit; }
+
+  //! Get whether the last search was stopped by the time limit.
+  bool TimedOut() const { return timedOut; }
+
+  //! Get the reference tree.
+  const Tree* ReferenceTree() const { return referenceTree; }
+
+ private:
+  //! The maximum number of queued node combinations.
+  size_t maxQueueSize;
+  //! The time limit of each search in seconds.
+  double timeLimit;
+  //! The reference tree (NULL if the model is not trained).
+  Tree* referenceTree;
+  //! Mappings from the indices in the tree to the original reference indices.
+  std::vector<size_t> oldFromNewReferences;
+  //! Whether the last search was stopped by the time limit.
+  bool timedOut;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "anytime_kfn_impl.hpp"
+
+#endif
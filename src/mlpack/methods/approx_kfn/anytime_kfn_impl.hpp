@@ -0,0 +1,250 @@
+/**
+ * @file anytime_kfn_impl.hpp
+ *
+ * Implementation of AnytimeKFN class methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_APPROX_KFN_ANYTIME_KFN_IMPL_HPP
+#define MLPACK_METHODS_APPROX_KFN_ANYTIME_KFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "anytime_kfn.hpp"
+
+#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+// Non-training constructor.
+template<typename MatType>
+AnytimeKFN<MatType>::AnytimeKFN(const size_t maxQueueSize,
+                                const double timeLimit) :
+    maxQueueSize(maxQueueSize),
+    timeLimit(timeLimit),
+    referenceTree(NULL),
+    timedOut(false)
+{
+  if (timeLimit < 0.0)
+  {
+    throw std::invalid_argument("AnytimeKFN::AnytimeKFN(): time limit must "
+        "not be negative!");
+  }
+}
+
+// Constructor.
+template<typename MatType>
+AnytimeKFN<MatType>::AnytimeKFN(const MatType& referenceSet,
+                                const size_t maxQueueSize,
+                                const double timeLimit) :
+    maxQueueSize(maxQueueSize),
+    timeLimit(timeLimit),
+    referenceTree(NULL),
+    timedOut(false)
+{
+  if (timeLimit < 0.0)
+  {
+    throw std::invalid_argument("AnytimeKFN::AnytimeKFN(): time limit must "
+        "not be negative!");
+  }
+
+  Train(referenceSet);
+}
+
+// Copy constructor.
+template<typename MatType>
+AnytimeKFN<MatType>::AnytimeKFN(const AnytimeKFN& other) :
+    maxQueueSize(other.maxQueueSize),
+    timeLimit(other.timeLimit),
+    referenceTree(other.referenceTree ? new Tree(*other.referenceTree) : NULL),
+    oldFromNewReferences(other.oldFromNewReferences),
+    timedOut(other.timedOut)
+{
+  // Nothing to do.
+}
+
+// Copy operator.
+template<typename MatType>
+AnytimeKFN<MatType>& AnytimeKFN<MatType>::operator=(const AnytimeKFN& other)
+{
+  if (this == &other)
+    return *this;
+
+  delete referenceTree;
+
+  maxQueueSize = other.maxQueueSize;
+  timeLimit = other.timeLimit;
+  referenceTree = other.referenceTree ? new Tree(*other.referenceTree) : NULL;
+  oldFromNewReferences = other.oldFromNewReferences;
+  timedOut = other.timedOut;
+
+  return *this;
+}
+
+// Destructor.
+template<typename MatType>
+AnytimeKFN<MatType>::~AnytimeKFN()
+{
+  delete referenceTree;
+}
+
+// Build the reference tree.
+template<typename MatType>
+void AnytimeKFN<MatType>::Train(const MatType& referenceSet)
+{
+  if (referenceSet.n_cols == 0)
+  {
+    throw std::invalid_argument("AnytimeKFN::Train(): reference set must not "
+        "be empty!");
+  }
+
+  delete referenceTree;
+  oldFromNewReferences.clear();
+  referenceTree = new Tree(referenceSet, oldFromNewReferences);
+}
+
+// Search for furthest neighbors.
+template<typename MatType>
+void AnytimeKFN<MatType>::Search(const MatType& querySet,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances)
+{
+  if (!referenceTree)
+  {
+    throw std::invalid_argument("AnytimeKFN::Search(): model is not trained; "
+        "call Train() first!");
+  }
+
+  const MatType& referenceSet = referenceTree->Dataset();
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "AnytimeKFN::Search(): requested " << k << " furthest neighbors, "
+        << "but reference set has only " << referenceSet.n_cols << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "AnytimeKFN::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Build the query tree and run the best-first traversal.
+  std::vector<size_t> oldFromNewQueries;
+  Tree queryTree(querySet, oldFromNewQueries);
+
+  typedef NeighborSearchRules<FurthestNS, metric::EuclideanDistance, Tree>
+      RuleType;
+  metric::EuclideanDistance metric;
+  RuleType rules(referenceSet, queryTree.Dataset(), k, metric);
+
+  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+      traverser(rules, maxQueueSize, timeLimit);
+  traverser.Traverse(queryTree, *referenceTree);
+  timedOut = traverser.TimedOut();
+
+  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  if (traverser.NumSpills() > 0)
+  {
+    Log::Info << traverser.NumSpills() << " node combinations were traversed "
+        << "depth-first because the queue was full." << std::endl;
+  }
+
+  arma::Mat<size_t> neighborPtr;
+  arma::mat distancePtr;
+  rules.GetResults(neighborPtr, distancePtr);
+
+  // If the search was stopped early, some of the neighbors may be missing or
+  // far from the best.  The reference points furthest from the centroid are
+  // good candidates for any query point, so they are used to complete the
+  // results.
+  if (timedOut)
+  {
+    Log::Info << "The time limit was reached; the results are approximate."
+        << std::endl;
+
+    const arma::vec centroid = arma::mean(referenceSet, 1);
+    arma::vec centroidDistances(referenceSet.n_cols);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      centroidDistances[i] = metric.Evaluate(centroid, referenceSet.col(i));
+
+    const size_t numSeeds = std::min((size_t) referenceSet.n_cols, k + 32);
+    const arma::uvec seeds = arma::sort_index(centroidDistances, "descend");
+
+    std::vector<std::pair<double, size_t>> results;
+    for (size_t i = 0; i < queryTree.Dataset().n_cols; ++i)
+    {
+      results.clear();
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (neighborPtr(j, i) != size_t() - 1)
+        {
+          results.push_back(std::make_pair(distancePtr(j, i),
+              neighborPtr(j, i)));
+        }
+      }
+
+      for (size_t s = 0; s < numSeeds; ++s)
+      {
+        const size_t seed = seeds[s];
+        if (arma::any(neighborPtr.col(i) == seed))
+          continue;
+
+        results.push_back(std::make_pair(metric.Evaluate(
+            queryTree.Dataset().col(i), referenceSet.col(seed)), seed));
+      }
+
+      std::partial_sort(results.begin(), results.begin() + k, results.end(),
+          std::greater<std::pair<double, size_t>>());
+      for (size_t j = 0; j < k; ++j)
+      {
+        distancePtr(j, i) = results[j].first;
+        neighborPtr(j, i) = results[j].second;
+      }
+    }
+  }
+
+  // Map the results back to the original indices.
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  for (size_t i = 0; i < neighborPtr.n_cols; ++i)
+  {
+    const size_t queryIndex = oldFromNewQueries[i];
+    for (size_t j = 0; j < k; ++j)
+      neighbors(j, queryIndex) = oldFromNewReferences[neighborPtr(j, i)];
+    distances.col(queryIndex) = distancePtr.col(i);
+  }
+}
+
+// Serialize the model.
+template<typename MatType>
+template<typename Archive>
+void AnytimeKFN<MatType>::serialize(Archive& ar,
+                                    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxQueueSize);
+  ar & BOOST_SERIALIZATION_NVP(timeLimit);
+
+  // Delete the current reference tree, if necessary and if we are loading.
+  if (Archive::is_loading::value)
+  {
+    delete referenceTree;
+    referenceTree = NULL;
+    timedOut = false;
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(referenceTree);
+  ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 #include "drusilla_select.hpp"
 #include "qdafn.hpp"
+#include "anytime_kfn.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -23,12 +24,12 @@ using namespace std;
 
 PROGRAM_INFO("Approximate furthest neighbor search",
     // Short description.
-    "An implementation of two strategies for furthest neighbor search.  This "
+    "An implementation of three strategies for furthest neighbor search.  This "
     "can be used to compute the furthest neighbor of query point(s) from a set "
     "of points; furthest neighbor models can be saved and reused with future "
     "query point(s).",
     // Long description.
-    "This program implements two strategies for furthest neighbor search. "
+    "This program implements three strategies for furthest neighbor search. "
     "These strategies are:"
     "\n\n"
     " - The 'qdafn' algorithm from \"Approximate Furthest Neighbor in High "
@@ -38,23 +39,33 @@ PROGRAM_INFO("Approximate furthest neighbor search",
     " - The 'DrusillaSelect' algorithm from \"Fast approximate furthest "
     "neighbors with data-dependent candidate selection\", by R.R. Curtin and "
     "A.B. Gardner, in Similarity Search and Applications 2016 (SISAP)."
+    "\n"
+    " - The 'anytime' algorithm, a best-first dual-tree search with a kd-tree "
+    "that returns the best furthest neighbors found within a time limit."
     "\n\n"
-    "These two strategies give approximate results for the furthest neighbor "
-    "search problem and can be used as fast replacements for other furthest "
-    "neighbor techniques such as those found in the mlpack_kfn program.  Note "
-    "that typically, the 'ds' algorithm requires far fewer tables and "
-    "projections than the 'qdafn' algorithm."
+    "The 'ds' and 'qdafn' strategies give approximate results for the "
+    "furthest neighbor search problem and can be used as fast replacements for "
+    "other furthest neighbor techniques such as those found in the mlpack_kfn "
+    "program.  Note that typically, the 'ds' algorithm requires far fewer "
+    "tables and projections than the 'qdafn' algorithm."
     "\n\n"
     "Specify a reference set (set to search in) with " +
     PRINT_PARAM_STRING("reference") + ", specify a query set with " +
     PRINT_PARAM_STRING("query") + ", and specify algorithm parameters with " +
     PRINT_PARAM_STRING("num_tables") + " and " +
     PRINT_PARAM_STRING("num_projections") + " (or don't and defaults will be "
-    "used).  The algorithm to be used (either 'ds'---the default---or 'qdafn') "
-    " may be specified with " + PRINT_PARAM_STRING("algorithm") + ".  Also "
-    "specify the number of neighbors to search for with " +
+    "used).  The algorithm to be used ('ds'---the default---, 'qdafn', or "
+    "'anytime') may be specified with " + PRINT_PARAM_STRING("algorithm") +
+    ".  Also specify the number of neighbors to search for with " +
     PRINT_PARAM_STRING("k") + "."
     "\n\n"
+    "The 'anytime' algorithm gives exact results unless a time limit in "
+    "seconds is specified with " + PRINT_PARAM_STRING("time_limit") + "; the "
+    "search then stops when the time is up and returns the best neighbors "
+    "found so far.  The number of node combinations held in memory during the "
+    "search is bounded by " + PRINT_PARAM_STRING("max_queue_size") + "; "
+    "combinations beyond that budget are searched depth-first."
+    "\n\n"
     "If no query set is specified, the reference set will be used as the "
     "query set.  The " + PRINT_PARAM_STRING("output_model") + " output "
     "parameter may be used to store the built model, and an input model may be "
@@ -113,7 +124,13 @@ PARAM_INT_IN("k", "Number of furthest neighbors to search for.", "k", 0);
 PARAM_INT_IN("num_tables", "Number of hash tables to use.", "t", 5);
 PARAM_INT_IN("num_projections", "Number of projections to use in each hash "
     "table.", "p", 5);
-PARAM_STRING_IN("algorithm", "Algorithm to use: 'ds' or 'qdafn'.", "a", "ds");
+PARAM_STRING_IN("algorithm", "Algorithm to use: 'ds', 'qdafn', or 'anytime'.",
+    "a", "ds");
+
+PARAM_DOUBLE_IN("time_limit", "Time limit of the search in seconds for the "
+    "'anytime' algorithm (0 means no limit).", "L", 0.0);
+PARAM_INT_IN("max_queue_size", "Maximum number of node combinations held in "
+    "the queue by the 'anytime' algorithm (0 means no limit).", "Q", 1000000);
 
 PARAM_UMATRIX_OUT("neighbors", "Matrix to save neighbor indices to.", "n");
 PARAM_MATRIX_OUT("distances", "Matrix to save furthest neighbor distances to.",
@@ -132,6 +149,7 @@ class ApproxKFNModel
   int type;
   DrusillaSelect<> ds;
   QDAFN<> qdafn;
+  AnytimeKFN<> anytime;
 
   //! Constructor, which does nothing.
   ApproxKFNModel() : type(0), ds(1, 1), qdafn(1, 1) { }
@@ -145,10 +163,14 @@ class ApproxKFNModel
     {
       ar & BOOST_SERIALIZATION_NVP(ds);
     }
-    else
+    else if (type == 1)
     {
       ar & BOOST_SERIALIZATION_NVP(qdafn);
     }
+    else
+    {
+      ar & BOOST_SERIALIZATION_NVP(anytime);
+    }
   }
 };
 
@@ -172,7 +194,7 @@ static void mlpackMain()
       "no output will be saved");
 
   // Check that the user specified a valid algorithm.
-  RequireParamInSet<string>("algorithm", { "ds", "qdafn" }, true,
+  RequireParamInSet<string>("algorithm", { "ds", "qdafn", "anytime" }, true,
       "unknown algorithm");
 
   // If we are searching, we need a set to search in.
@@ -192,6 +214,10 @@ static void mlpackMain()
       "number of tables must be positive");
   RequireParamValue<int>("num_projections", [](int x) { return x > 0; }, true,
       "number of projections must be positive");
+  RequireParamValue<double>("time_limit", [](double x) { return x >= 0.0; },
+      true, "time limit must not be negative");
+  RequireParamValue<int>("max_queue_size", [](int x) { return x >= 0; }, true,
+      "maximum queue size must not be negative");
 
   ReportIgnoredParam({{ "input_model", true }}, "algorithm");
   ReportIgnoredParam({{ "input_model", true }}, "num_tables");
@@ -237,7 +263,7 @@ static void mlpackMain()
       m->ds = DrusillaSelect<>(referenceSet, numTables, numProjections);
       Timer::Stop("drusilla_select_construct");
     }
-    else
+    else if (algorithm == "qdafn")
     {
       Timer::Start("qdafn_construct");
       Log::Info << "Building QDAFN model..." << endl;
@@ -245,6 +271,17 @@ static void mlpackMain()
       m->qdafn = QDAFN<>(referenceSet, numTables, numProjections);
       Timer::Stop("qdafn_construct");
     }
+    else
+    {
+      Timer::Start("tree_building");
+      Log::Info << "Building reference tree..." << endl;
+      m->type = 2;
+      m->anytime.MaxQueueSize() =
+          (size_t) CLI::GetParam<int>("max_queue_size");
+      m->anytime.TimeLimit() = CLI::GetParam<double>("time_limit");
+      m->anytime.Train(referenceSet);
+      Timer::Stop("tree_building");
+    }
     Log::Info << "Model built." << endl;
   }
   else
@@ -274,7 +311,7 @@ static void mlpackMain()
       m->ds.Search(set, k, neighbors, distances);
       Timer::Stop("drusilla_select_search");
     }
-    else
+    else if (m->type == 1)
     {
       Timer::Start("qdafn_search");
       Log::Info << "Searching for " << k << " furthest neighbors with "
@@ -282,6 +319,29 @@ static void mlpackMain()
       m->qdafn.Search(set, k, neighbors, distances);
       Timer::Stop("qdafn_search");
     }
+    else
+    {
+      // The search budget stored in the model may be changed for this search.
+      if (CLI::HasParam("time_limit"))
+        m->anytime.TimeLimit() = CLI::GetParam<double>("time_limit");
+      if (CLI::HasParam("max_queue_size"))
+      {
+        m->anytime.MaxQueueSize() =
+            (size_t) CLI::GetParam<int>("max_queue_size");
+      }
+
+      Timer::Start("anytime_search");
+      Log::Info << "Searching for " << k << " furthest neighbors with "
+          << "the anytime tree search..." << endl;
+      m->anytime.Search(set, k, neighbors, distances);
+      Timer::Stop("anytime_search");
+
+      if (m->anytime.TimedOut())
+      {
+        Log::Warn << "The time limit was reached before the search finished; "
+            << "the results are approximate." << endl;
+      }
+    }
     Log::Info << "Search complete." << endl;
 
     // Should we calculate error?
@@ -68,6 +68,11 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * If mlpack is compiled with OpenMP, the search for the nearest neighbor of
+ * each component is run in parallel over disjoint query subtrees; the edges
+ * found are the same for any number of threads, since ties between candidate
+ * edges are broken by the point indices.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -111,6 +116,9 @@ class DualTreeBoruvka
   arma::Col<size_t> neighborsOutComponent;
   //! List of edge distances.
   arma::vec neighborsDistances;
+  //! Core distances of the points (in the order of data), if the mutual
+  //! reachability distance is used; otherwise, this is empty.
+  arma::vec coreDistances;
 
   //! Total distance of the tree.
   double totalDist;
@@ -176,7 +184,37 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  /**
+   * Compute the minimum spanning tree of the dataset under the mutual
+   * reachability distance
+   *
+   *   d_mreach(a, b) = max(core(a), core(b), d(a, b))
+   *
+   * where core(a) is the core distance of point a (usually the distance to its
+   * k-th nearest neighbor).  This is the tree that HDBSCAN works with.  The
+   * results have the same format as for ComputeMST(results), and the core
+   * distances are given in the order of the points of the original dataset.
+   *
+   * @param results Matrix which results will be stored in.
+   * @param coreDistances Core distance of each point.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec& coreDistances);
+
  private:
+  /**
+   * Compute the minimum spanning tree with the current core distances (if
+   * any).
+   */
+  void ComputeMSTInternal(arma::mat& results);
+
+  /**
+   * Split the tree into disjoint subtrees, which are used as the query nodes of
+   * the parallel traversals of each iteration.
+   *
+   * @param queryNodes Vector to store the subtrees in.
+   */
+  void GetQueryNodes(std::vector<Tree*>& queryNodes);
+
   /**
    * Adds a single edge to the edge list
    */
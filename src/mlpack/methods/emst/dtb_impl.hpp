@@ -118,27 +118,109 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     arma::mat& results)
+{
+  coreDistances.reset();
+  ComputeMSTInternal(results);
+}
+
+/**
+ * Find the minimum spanning tree under the mutual reachability distance.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec& coreDistances)
+{
+  if (coreDistances.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DualTreeBoruvka::ComputeMST(): number of core distances ("
+        << coreDistances.n_elem << ") does not match number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The core distances must be given in the order of the points in the tree.
+  if (!naive && ownTree && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    this->coreDistances.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      this->coreDistances[i] = coreDistances[oldFromNew[i]];
+  }
+  else
+  {
+    this->coreDistances = coreDistances;
+  }
+
+  ComputeMSTInternal(results);
+}
+
+/**
+ * Iteratively find the nearest neighbor of each component until the MST is
+ * complete.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMSTInternal(
+    arma::mat& results)
 {
   Timer::Start("emst/mst_computation");
 
   totalDist = 0; // Reset distance.
 
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+
+  // The query side of each traversal is split into disjoint subtrees, which
+  // are traversed in parallel against the whole reference tree.  Each thread
+  // only modifies the statistics of its own query nodes.
+  std::vector<Tree*> queryNodes;
+  if (!naive)
+    GetQueryNodes(queryNodes);
+
+  size_t baseCases = 0;
+  size_t scores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
     {
       // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      #pragma omp parallel reduction(+:baseCases)
+      {
+        RuleType rules(data, connections, neighborsDistances,
+            neighborsInComponent, neighborsOutComponent, metric,
+            coreDistances.is_empty() ? NULL : &coreDistances);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules.BaseCase(i, j);
+
+        baseCases += rules.BaseCases();
+      }
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+      for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+      {
+        RuleType rules(data, connections, neighborsDistances,
+            neighborsInComponent, neighborsOutComponent, metric,
+            coreDistances.is_empty() ? NULL : &coreDistances);
+        typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(*queryNodes[i], *tree);
+
+        baseCases += rules.BaseCases();
+        scores += rules.Scores();
+      }
     }
 
     AddAllEdges();
@@ -148,8 +230,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -161,6 +243,63 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   Log::Info << "Total spanning tree length: " << totalDist << std::endl;
 }
 
+/**
+ * Split the tree into disjoint subtrees that can be used as query nodes of
+ * parallel traversals.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::GetQueryNodes(
+    std::vector<Tree*>& queryNodes)
+{
+  queryNodes.clear();
+  queryNodes.push_back(tree);
+
+  // A node can only be replaced by its children if it holds no points itself
+  // and its descendants hold no points twice; otherwise, traverse the whole
+  // tree at once.
+  if (tree::TreeTraits<Tree>::HasSelfChildren ||
+      tree::TreeTraits<Tree>::HasDuplicatedPoints)
+    return;
+
+  #ifdef HAS_OPENMP
+  const size_t targetNodes = 8 * omp_get_max_threads();
+  #else
+  const size_t targetNodes = 1;
+  #endif
+
+  // Expand the largest nodes first, so that the subtrees have similar sizes.
+  bool expanded = true;
+  while (queryNodes.size() < targetNodes && expanded)
+  {
+    expanded = false;
+    size_t largest = 0;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      Tree* node = queryNodes[i];
+      if (node->NumChildren() > 0 && node->NumPoints() == 0 &&
+          (!expanded || node->NumDescendants() >
+              queryNodes[largest]->NumDescendants()))
+      {
+        largest = i;
+        expanded = true;
+      }
+    }
+
+    if (expanded)
+    {
+      Tree* node = queryNodes[largest];
+      queryNodes[largest] = &node->Child(0);
+      for (size_t i = 1; i < node->NumChildren(); ++i)
+        queryNodes.push_back(&node->Child(i));
+    }
+  }
+}
+
 /**
  * Adds a single edge to the edge list
  */
@@ -195,18 +334,19 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
+  // This is done sequentially, so that the edges (and the components they
+  // join) do not depend on the number of threads.
   for (size_t i = 0; i < data.n_cols; i++)
   {
     size_t component = connections.Find(i);
     size_t inEdge = neighborsInComponent[component];
     size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    if (connections.Union(inEdge, outEdge))
     {
       // totalDist = totalDist + dist;
       // changed to make this agree with the cover tree code
       totalDist += neighborsDistances[component];
       AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
     }
   }
 }
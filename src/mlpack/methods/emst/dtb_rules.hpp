@@ -28,7 +28,8 @@ class DTBRules
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
-           MetricType& metric);
+           MetricType& metric,
+           const arma::vec* coreDistances = NULL);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -118,6 +119,29 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! The core distances of the points, if the mutual reachability distance is
+  //! used (otherwise NULL).
+  const arma::vec* coreDistances;
+
+  /**
+   * Return whether the edge between the given points is a better candidate
+   * for the given component than the current one: its distance is smaller, or
+   * it is equal and the edge comes first in the order of the point indices.
+   * This must be called inside the critical section that updates the
+   * candidates.
+   */
+  bool IsBetterCandidate(const size_t component,
+                         const double distance,
+                         const size_t queryIndex,
+                         const size_t referenceIndex) const;
+
+  /**
+   * Return the distance to the candidate nearest neighbor of the given
+   * component.  The distance is read atomically, since other threads may be
+   * updating it.
+   */
+  double CandidateDistance(const size_t component) const;
+
   /**
    * Update the bound for the given query node.
    */
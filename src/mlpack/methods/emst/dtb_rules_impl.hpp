@@ -22,7 +22,8 @@ DTBRules(const arma::mat& dataSet,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
-         MetricType& metric)
+         MetricType& metric,
+         const arma::vec* coreDistances)
 :
   dataSet(dataSet),
   connections(connections),
@@ -30,6 +31,7 @@ DTBRules(const arma::mat& dataSet,
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
   metric(metric),
+  coreDistances(coreDistances),
   baseCases(0),
   scores(0)
 {
@@ -57,18 +59,41 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    // The mutual reachability distance is never smaller than the distance, so
+    // the bounds used for pruning stay valid.
+    if (coreDistances)
+    {
+      distance = std::max(distance, std::max((*coreDistances)[queryIndex],
+          (*coreDistances)[referenceIndex]));
+    }
+
+    // Several threads may be traversing query nodes with points in the same
+    // component, so the candidate is only compared and updated in a critical
+    // section.  The atomic check beforehand can only see a candidate distance
+    // that is too large, since the candidate distances never increase during
+    // an iteration.  Ties are broken by the point indices, so that the chosen
+    // edges do not depend on the order of the base cases.
+    if (distance <= CandidateDistance(queryComponentIndex))
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      #pragma omp critical(DTBRulesUpdateCandidate)
+      {
+        if (IsBetterCandidate(queryComponentIndex, distance, queryIndex,
+            referenceIndex))
+        {
+          #pragma omp atomic write
+          neighborsDistances[queryComponentIndex] = distance;
+          neighborsInComponent[queryComponentIndex] = queryIndex;
+          neighborsOutComponent[queryComponentIndex] = referenceIndex;
+        }
+      }
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  const double candidateDistance = CandidateDistance(queryComponentIndex);
+  if (newUpperBound < candidateDistance)
+    newUpperBound = candidateDistance;
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -93,7 +118,7 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  return CandidateDistance(queryComponentIndex) < distance
       ? DBL_MAX : distance;
 }
 
@@ -104,7 +129,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > CandidateDistance(connections.Find(queryIndex)))
       ? DBL_MAX : oldScore;
 }
 
@@ -137,6 +162,32 @@ double DTBRules<MetricType, TreeType>::Rescore(TreeType& queryNode,
   return (oldScore > bound) ? DBL_MAX : oldScore;
 }
 
+template<typename MetricType, typename TreeType>
+inline bool DTBRules<MetricType, TreeType>::IsBetterCandidate(
+    const size_t component,
+    const double distance,
+    const size_t queryIndex,
+    const size_t referenceIndex) const
+{
+  if (distance != neighborsDistances[component])
+    return (distance < neighborsDistances[component]);
+
+  if (queryIndex != neighborsInComponent[component])
+    return (queryIndex < neighborsInComponent[component]);
+
+  return (referenceIndex < neighborsOutComponent[component]);
+}
+
+template<typename MetricType, typename TreeType>
+inline double DTBRules<MetricType, TreeType>::CandidateDistance(
+    const size_t component) const
+{
+  double distance;
+  #pragma omp atomic read
+  distance = neighborsDistances[component];
+  return distance;
+}
+
 // Calculate the bound for a given query node in its current state and update
 // it.
 template<typename MetricType, typename TreeType>
@@ -153,7 +204,7 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const double bound = CandidateDistance(pointComponent);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
@@ -176,9 +227,11 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   // Now calculate the actual bounds.
   const double worstBound = std::max(worstPointBound, worstChildBound);
   const double bestBound = std::min(bestPointBound, bestChildBound);
-  // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.
-  const double bestAdjustedBound = (bestBound == DBL_MAX) ? DBL_MAX :
-      bestBound + 2 * queryNode.FurthestDescendantDistance();
+  // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.  The
+  // adjusted bound relies on the triangle inequality, which does not hold for
+  // the mutual reachability distance.
+  const double bestAdjustedBound = (bestBound == DBL_MAX || coreDistances) ?
+      DBL_MAX : bestBound + 2 * queryNode.FurthestDescendantDistance();
 
   // Update the relevant quantities in the node.
   queryNode.Stat().MaxNeighborDistance() = worstBound;
@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_EMST_UNION_FIND_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <atomic>
 
 namespace mlpack {
 namespace emst {
@@ -26,22 +27,35 @@ namespace emst {
  * initially in its own component.  Calling Union(x, y) unites the components
  * indexed by x and y.  Find(x) returns the index of the component containing
  * point x.
+ *
+ * The structure is lock-free: Find() and Union() may be called concurrently
+ * from several threads.  Find() compresses paths by path halving, where every
+ * write only makes a node point to one of its ancestors, and Union() links the
+ * root with the larger index below the other root with a compare-and-swap, so
+ * concurrent calls can never create a cycle.  See the following paper:
+ *
+ * @code
+ * @inproceedings{anderson1991wait,
+ *   title={Wait-free parallel algorithms for the union-find problem},
+ *   author={Anderson, R.J. and Woll, H.},
+ *   booktitle={Proceedings of the 23rd Annual ACM Symposium on Theory of
+ *       Computing (STOC '91)},
+ *   pages={370--380},
+ *   year={1991}
+ * }
+ * @endcode
  */
 class UnionFind
 {
  private:
-  arma::Col<size_t> parent;
-  arma::ivec rank;
+  std::vector<std::atomic<size_t>> parent;
 
  public:
   //! Construct the object with the given size.
-  UnionFind(const size_t size) : parent(size), rank(size)
+  UnionFind(const size_t size) : parent(size)
   {
     for (size_t i = 0; i < size; ++i)
-    {
-      parent[i] = i;
-      rank[i] = 0;
-    }
+      parent[i].store(i, std::memory_order_relaxed);
   }
 
   //! Destroy the object (nothing to do).
@@ -55,16 +69,26 @@ class UnionFind
    */
   size_t Find(const size_t x)
   {
-    if (parent[x] == x)
+    size_t current = x;
+    size_t next = parent[current].load(std::memory_order_acquire);
+    while (next != current)
     {
-      return x;
-    }
-    else
-    {
-      // This ensures that the tree has a small depth.
-      parent[x] = Find(parent[x]);
-      return parent[x];
+      // Make the current node point to its grandparent; this ensures that the
+      // tree has a small depth.  If another thread changed the parent in the
+      // meantime, it also pointed it to an ancestor, so we can skip the write.
+      const size_t grandparent = parent[next].load(std::memory_order_acquire);
+      if (grandparent != next)
+      {
+        size_t expected = next;
+        parent[current].compare_exchange_weak(expected, grandparent,
+            std::memory_order_release, std::memory_order_relaxed);
+      }
+
+      current = grandparent;
+      next = parent[current].load(std::memory_order_acquire);
     }
+
+    return current;
   }
 
   /**
@@ -72,28 +96,30 @@ class UnionFind
    *
    * @param x one component
    * @param y the other component
+   * @return Whether the components were different (and have been united).
    */
-  void Union(const size_t x, const size_t y)
+  bool Union(const size_t x, const size_t y)
   {
-    const size_t xRoot = Find(x);
-    const size_t yRoot = Find(y);
-
-    if (xRoot == yRoot)
+    size_t xRoot = x;
+    size_t yRoot = y;
+    while (true)
     {
-      return;
-    }
-    else if (rank[xRoot] == rank[yRoot])
-    {
-      parent[yRoot] = parent[xRoot];
-      rank[xRoot] = rank[xRoot] + 1;
-    }
-    else if (rank[xRoot] > rank[yRoot])
-    {
-      parent[yRoot] = xRoot;
-    }
-    else
-    {
-      parent[xRoot] = yRoot;
+      xRoot = Find(xRoot);
+      yRoot = Find(yRoot);
+
+      if (xRoot == yRoot)
+        return false;
+
+      // Always link the root with the larger index below the other one.
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      // This fails if another thread linked xRoot in the meantime; then we
+      // start again from the new roots.
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot,
+          std::memory_order_acq_rel, std::memory_order_acquire))
+        return true;
     }
   }
 }; // class UnionFind
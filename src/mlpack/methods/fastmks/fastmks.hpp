@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/ip_metric.hpp>
 #include "fastmks_stat.hpp"
+#include "kernel_block.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <queue>
 
@@ -42,6 +43,12 @@ namespace fastmks /** Fast max-kernel search. */ {
  * }
  * @endcode
  *
+ * Dual-tree search and brute-force search are parallelized with OpenMP: the
+ * query tree is split into disjoint subtrees that are traversed in parallel,
+ * and brute-force search evaluates the kernel on blocks of points (with matrix
+ * multiplications for the linear, polynomial and cosine kernels).  Single-tree
+ * search caches kernel values in the reference tree, so it runs on one thread.
+ *
  * This class allows specification of the type of kernel and also of the type of
  * tree.  FastMKS can be run on kernels that work on arbitrary objects --
  * however, this only works with cover trees and other trees that are built only
@@ -303,6 +310,33 @@ class FastMKS
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Run brute-force search.  The kernel values are computed for blocks of
+   * query and reference points at once with KernelBlock, and the blocks of
+   * query points are searched in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of max-kernel candidates to search for.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param monochromatic If true, the query set is the reference set, and
+   *     points are not returned as their own candidates.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool monochromatic);
+
+  /**
+   * Split the given query tree into disjoint subtrees, which are used as the
+   * query nodes of parallel dual-tree traversals.
+   *
+   * @param queryTree Query tree to split.
+   * @param queryNodes Vector to store the subtrees in.
+   */
+  static void GetQueryNodes(Tree* queryTree, std::vector<Tree*>& queryNodes);
+
   //! The reference dataset.  We never own this; only the tree or a higher level
   //! does.
   const MatType* referenceSet;
@@ -18,6 +18,7 @@
 #include "fastmks_rules.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/tree/parallel_single_tree_traversal.hpp>
 
 namespace mlpack {
 namespace fastmks {
@@ -426,33 +427,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
@@ -467,13 +442,15 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, querySet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Each thread traverses with its own rules object that shares the results.
+    size_t baseCases = 0;
+    size_t scores = 0;
+    tree::ParallelSingleTreeTraversal<Tree::template SingleTreeTraverser,
+        RuleType>(*referenceTree, querySet.n_cols,
+        [&rules]() { return new RuleType(rules); }, baseCases, scores);
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+    Log::Info << baseCases << " base cases." << std::endl;
+    Log::Info << scores << " scores." << std::endl;
 
     rules.GetResults(indices, kernels);
 
@@ -533,12 +510,29 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  // The query tree is split into disjoint subtrees, which are traversed in
+  // parallel.  The rules of each traversal share the candidate lists, but each
+  // query point belongs to only one subtree, and the reference tree is not
+  // modified by dual-tree traversals.
+  std::vector<Tree*> queryNodes;
+  GetQueryNodes(queryTree, queryNodes);
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+  for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+  {
+    RuleType nodeRules(rules);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(nodeRules);
 
-  traverser.Traverse(*queryTree, *referenceTree);
+    traverser.Traverse(*queryNodes[i], *referenceTree);
+
+    baseCases += nodeRules.BaseCases();
+    scores += nodeRules.Scores();
+  }
 
-  Log::Info << rules.BaseCases() << " base cases." << std::endl;
-  Log::Info << rules.Scores() << " scores." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
 
   rules.GetResults(indices, kernels);
 
@@ -563,36 +557,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -607,18 +572,19 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
+    // Each thread traverses with its own rules object that shares the results.
+    size_t baseCases = 0;
+    size_t scores = 0;
+    size_t numPrunes = 0;
+    tree::ParallelSingleTreeTraversal<Tree::template SingleTreeTraverser,
+        RuleType>(*referenceTree, referenceSet->n_cols,
+        [&rules]() { return new RuleType(rules); }, baseCases, scores,
+        numPrunes);
 
     Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+    Log::Info << baseCases << " base cases." << std::endl;
+    Log::Info << scores << " scores." << std::endl;
 
     rules.GetResults(indices, kernels);
 
@@ -632,6 +598,137 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool monochromatic)
+{
+  // The blocks are small enough that the kernel values of a block fit in the
+  // cache.
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 1024;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel
+  {
+    arma::mat products;
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+    {
+      const size_t queryBegin = b * queryBlockSize;
+      const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+          (size_t) querySet.n_cols);
+
+      std::vector<CandidateList> pqueues(queryEnd - queryBegin,
+          CandidateList(CandidateCmp(), std::vector<Candidate>(k, def)));
+
+      for (size_t r = 0; r < referenceSet->n_cols; r += referenceBlockSize)
+      {
+        const size_t referenceEnd = std::min(r + referenceBlockSize,
+            (size_t) referenceSet->n_cols);
+        KernelBlock<KernelType>::Evaluate(metric.Kernel(),
+            querySet.cols(queryBegin, queryEnd - 1),
+            referenceSet->cols(r, referenceEnd - 1), products);
+
+        for (size_t q = queryBegin; q < queryEnd; ++q)
+        {
+          CandidateList& pqueue = pqueues[q - queryBegin];
+          for (size_t i = 0; i < products.n_rows; ++i)
+          {
+            // Don't return the point as its own candidate.
+            if (monochromatic && (q == r + i))
+              continue;
+
+            const double eval = products(i, q - queryBegin);
+            if (eval > pqueue.top().first)
+            {
+              Candidate c = std::make_pair(eval, r + i);
+              pqueue.pop();
+              pqueue.push(c);
+            }
+          }
+        }
+      }
+
+      for (size_t q = queryBegin; q < queryEnd; ++q)
+      {
+        CandidateList& pqueue = pqueues[q - queryBegin];
+        for (size_t j = 1; j <= k; j++)
+        {
+          indices(k - j, q) = pqueue.top().second;
+          kernels(k - j, q) = pqueue.top().first;
+          pqueue.pop();
+        }
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::GetQueryNodes(
+    Tree* queryTree,
+    std::vector<Tree*>& queryNodes)
+{
+  queryNodes.clear();
+  queryNodes.push_back(queryTree);
+
+  // Each point must belong to only one subtree, so a node can only be
+  // replaced by its children if its own points are also held by them.
+  if (tree::TreeTraits<Tree>::HasDuplicatedPoints)
+    return;
+
+  #ifdef HAS_OPENMP
+  const size_t targetNodes = 8 * omp_get_max_threads();
+  #else
+  const size_t targetNodes = 1;
+  #endif
+
+  // Expand the largest nodes first, so that the subtrees have similar sizes.
+  bool expanded = true;
+  while (queryNodes.size() < targetNodes && expanded)
+  {
+    expanded = false;
+    size_t largest = 0;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      Tree* node = queryNodes[i];
+      if (node->NumChildren() > 0 && (node->NumPoints() == 0 ||
+          tree::TreeTraits<Tree>::HasSelfChildren) &&
+          (!expanded || node->NumDescendants() >
+              queryNodes[largest]->NumDescendants()))
+      {
+        largest = i;
+        expanded = true;
+      }
+    }
+
+    if (expanded)
+    {
+      // The expanded node is not traversed, so its bound (which its children
+      // use) must not be left over from an earlier search.
+      Tree* node = queryNodes[largest];
+      node->Stat().Bound() = -DBL_MAX;
+      queryNodes[largest] = &node->Child(0);
+      for (size_t i = 1; i < node->NumChildren(); ++i)
+        queryNodes.push_back(&node->Child(i));
+    }
+  }
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
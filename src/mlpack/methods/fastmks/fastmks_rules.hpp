@@ -48,6 +48,18 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object that shares the candidate lists and the
+   * cached self-kernels of the given one, but has its own traversal state.
+   * This is used for parallel search, where each traversal works on a disjoint
+   * set of query points.  Single-tree scores with the new object don't cache
+   * kernel evaluations in the reference nodes, so several objects can traverse
+   * the same reference tree at once.  The given object must outlive this one.
+   *
+   * @param other Rules object to share the candidates of.
+   */
+  explicit FastMKSRules(FastMKSRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -148,15 +160,19 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
-  //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidates for each point, if this object owns them.
+  std::vector<CandidateList> ownCandidates;
+  //! Set of candidates for each point (possibly shared with other rules).
+  std::vector<CandidateList>& candidates;
 
   //! Number of points to search for.
   const size_t k;
 
-  //! Cached query set self-kernels (|| q || for each q).
+  //! Cached query set self-kernels (|| q || for each q).  This may be an alias
+  //! of the self-kernels of another rules object.
   arma::vec queryKernels;
-  //! Cached reference set self-kernels (|| r || for each r).
+  //! Cached reference set self-kernels (|| r || for each r).  This may be an
+  //! alias of the self-kernels of another rules object.
   arma::vec referenceKernels;
 
   //! The instantiated kernel.
@@ -169,6 +185,10 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! Whether single-tree scores cache the kernel evaluations in the reference
+  //! nodes (and use the cached evaluations of the parents).
+  bool cacheKernels;
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
@@ -26,22 +26,26 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(ownCandidates),
     k(k),
     kernel(kernel),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
+    cacheKernels(true),
     baseCases(0),
     scores(0)
 {
   // Precompute each self-kernel.
   queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
     queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
                                            querySet.col(i)));
 
   referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
     referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
                                                referenceSet.col(i)));
 
@@ -64,6 +68,30 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   candidates.swap(tmp);
 }
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(FastMKSRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    queryKernels(other.queryKernels.memptr(), other.queryKernels.n_elem, false,
+        true),
+    referenceKernels(other.referenceKernels.memptr(),
+        other.referenceKernels.n_elem, false, true),
+    kernel(other.kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    cacheKernels(false),
+    baseCases(0),
+    scores(0)
+{
+  // Set to invalid memory, so that the first node combination does not try to
+  // dereference null pointers.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename KernelType, typename TreeType>
 void FastMKSRules<KernelType, TreeType>::GetResults(
     arma::Mat<size_t>& indices,
@@ -133,7 +161,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
 
   // See if we can perform a parent-child prune.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
-  if (referenceNode.Parent() != NULL)
+  if (cacheKernels && referenceNode.Parent() != NULL)
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
@@ -175,7 +203,13 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      // Without the cache, the kernel is evaluated again; the base case of the
+      // point has been done already, so it must not be done twice.
+      if (cacheKernels)
+        kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      else
+        kernelEval = kernel.Evaluate(querySet.col(queryIndex),
+            referenceSet.col(referenceNode.Point(0)));
     }
     else
     {
@@ -190,7 +224,8 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  if (cacheKernels)
+    referenceNode.Stat().LastKernel() = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -0,0 +1,116 @@
+/**
+ * @file kernel_block.hpp
+ *
+ * Evaluation of all the kernel values between two sets of points at once.  For
+ * kernels that are functions of the inner product, this is done with one
+ * matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_KERNEL_BLOCK_HPP
+#define MLPACK_METHODS_FASTMKS_KERNEL_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+#include <mlpack/core/kernels/cosine_distance.hpp>
+
+namespace mlpack {
+namespace fastmks {
+
+/**
+ * Compute the kernel values between every reference point and every query
+ * point; after the call, products(i, j) holds K(queries.col(j),
+ * references.col(i)).  By default, each kernel value is evaluated separately;
+ * the specializations for the linear, polynomial and cosine kernels use one
+ * matrix multiplication.
+ *
+ * @tparam KernelType Type of kernel.
+ */
+template<typename KernelType>
+struct KernelBlock
+{
+  template<typename QueryMatType, typename ReferenceMatType>
+  static void Evaluate(KernelType& kernel,
+                       const QueryMatType& queries,
+                       const ReferenceMatType& references,
+                       arma::mat& products)
+  {
+    products.set_size(references.n_cols, queries.n_cols);
+    for (size_t j = 0; j < queries.n_cols; ++j)
+      for (size_t i = 0; i < references.n_cols; ++i)
+        products(i, j) = kernel.Evaluate(queries.col(j), references.col(i));
+  }
+};
+
+//! The linear kernel is the inner product.
+template<>
+struct KernelBlock<kernel::LinearKernel>
+{
+  template<typename QueryMatType, typename ReferenceMatType>
+  static void Evaluate(kernel::LinearKernel& /* kernel */,
+                       const QueryMatType& queries,
+                       const ReferenceMatType& references,
+                       arma::mat& products)
+  {
+    products = references.t() * queries;
+  }
+};
+
+//! The polynomial kernel is a power of the shifted inner product.
+template<>
+struct KernelBlock<kernel::PolynomialKernel>
+{
+  template<typename QueryMatType, typename ReferenceMatType>
+  static void Evaluate(kernel::PolynomialKernel& kernel,
+                       const QueryMatType& queries,
+                       const ReferenceMatType& references,
+                       arma::mat& products)
+  {
+    products = references.t() * queries;
+    products = arma::pow(products + kernel.Offset(), kernel.Degree());
+  }
+};
+
+//! The cosine kernel is the inner product divided by the norms.
+template<>
+struct KernelBlock<kernel::CosineDistance>
+{
+  template<typename QueryMatType, typename ReferenceMatType>
+  static void Evaluate(kernel::CosineDistance& /* kernel */,
+                       const QueryMatType& queries,
+                       const ReferenceMatType& references,
+                       arma::mat& products)
+  {
+    products = references.t() * queries;
+
+    // Points with a norm of zero have a kernel value of zero (see
+    // CosineDistance::Evaluate()).
+    arma::rowvec queryScales(queries.n_cols);
+    for (size_t j = 0; j < queries.n_cols; ++j)
+      queryScales[j] = InverseNorm(queries.col(j));
+    arma::vec referenceScales(references.n_cols);
+    for (size_t i = 0; i < references.n_cols; ++i)
+      referenceScales[i] = InverseNorm(references.col(i));
+
+    products.each_col() %= referenceScales;
+    products.each_row() %= queryScales;
+  }
+
+ private:
+  //! Get 1 / ||x||, or 0 if x is zero.
+  template<typename VecType>
+  static double InverseNorm(const VecType& x)
+  {
+    const double norm = arma::norm(x, 2);
+    return (norm == 0.0) ? 0.0 : 1.0 / norm;
+  }
+};
+
+} // namespace fastmks
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,300 @@
+/**
+ * @file dendrogram.cpp
+ *
+ * Implementation of the Dendrogram class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "dendrogram.hpp"
+
+#include <mlpack/methods/emst/union_find.hpp>
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::emst;
+
+Dendrogram::Dendrogram(const arma::mat& spanningTree) :
+    numPoints(spanningTree.n_cols + 1)
+{
+  if (spanningTree.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "Dendrogram::Dendrogram(): spanning tree must have 3 rows (has "
+        << spanningTree.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numMerges = spanningTree.n_cols;
+  linkage.set_size(4, numMerges);
+  edges.set_size(2, numMerges);
+
+  const arma::uvec order = arma::stable_sort_index(spanningTree.row(2));
+
+  // The cluster of the dendrogram and the number of points of each component.
+  UnionFind components(numPoints);
+  std::vector<size_t> clusters(numPoints);
+  std::vector<size_t> sizes(numPoints, 1);
+  for (size_t i = 0; i < numPoints; ++i)
+    clusters[i] = i;
+
+  for (size_t i = 0; i < numMerges; ++i)
+  {
+    const size_t a = (size_t) spanningTree(0, order[i]);
+    const size_t b = (size_t) spanningTree(1, order[i]);
+    if (a >= numPoints || b >= numPoints)
+    {
+      throw std::invalid_argument("Dendrogram::Dendrogram(): spanning tree "
+          "has an invalid point index!");
+    }
+
+    const size_t aRoot = components.Find(a);
+    const size_t bRoot = components.Find(b);
+    if (aRoot == bRoot)
+    {
+      throw std::invalid_argument("Dendrogram::Dendrogram(): edges do not "
+          "form a spanning tree!");
+    }
+
+    linkage(0, i) = std::min(clusters[aRoot], clusters[bRoot]);
+    linkage(1, i) = std::max(clusters[aRoot], clusters[bRoot]);
+    linkage(2, i) = spanningTree(2, order[i]);
+    linkage(3, i) = sizes[aRoot] + sizes[bRoot];
+    edges(0, i) = a;
+    edges(1, i) = b;
+
+    components.Union(aRoot, bRoot);
+    const size_t root = components.Find(aRoot);
+    clusters[root] = numPoints + i;
+    sizes[root] = (size_t) linkage(3, i);
+  }
+}
+
+size_t Dendrogram::Cut(const double distance,
+                       arma::Row<size_t>& assignments,
+                       const size_t minClusterSize) const
+{
+  // The merges are sorted by distance, so only the first ones are used.
+  UnionFind components(numPoints);
+  for (size_t i = 0; i < linkage.n_cols && linkage(2, i) <= distance; ++i)
+    components.Union(edges(0, i), edges(1, i));
+
+  std::vector<size_t> sizes(numPoints, 0);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++sizes[components.Find(i)];
+
+  // Number the clusters in order of their first point.
+  std::vector<size_t> labels(numPoints, SIZE_MAX);
+  assignments.set_size(numPoints);
+  size_t numClusters = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t root = components.Find(i);
+    if (sizes[root] < minClusterSize)
+    {
+      assignments[i] = SIZE_MAX;
+      continue;
+    }
+
+    if (labels[root] == SIZE_MAX)
+      labels[root] = numClusters++;
+    assignments[i] = labels[root];
+  }
+
+  return numClusters;
+}
+
+void Dendrogram::Condense(const size_t minClusterSize,
+                          arma::mat& condensedTree) const
+{
+  if (minClusterSize < 2)
+  {
+    throw std::invalid_argument("Dendrogram::Condense(): minClusterSize must "
+        "be at least 2!");
+  }
+
+  if (numPoints < 2)
+  {
+    condensedTree.set_size(4, 0);
+    return;
+  }
+
+  std::vector<double> parents, children, lambdas, childSizes;
+  const auto addRow = [&](const size_t parent,
+                          const size_t child,
+                          const double lambda,
+                          const size_t size)
+  {
+    parents.push_back(parent);
+    children.push_back(child);
+    lambdas.push_back(lambda);
+    childSizes.push_back(size);
+  };
+
+  // The label of each node of the dendrogram in the condensed tree, and
+  // whether the node has fallen out of its cluster.
+  const size_t numNodes = 2 * numPoints - 1;
+  std::vector<size_t> labels(numNodes, SIZE_MAX);
+  std::vector<bool> fallen(numNodes, false);
+  std::vector<size_t> stack;
+
+  size_t nextLabel = numPoints;
+  labels[numNodes - 1] = nextLabel++;
+
+  // Children always have smaller indices than their parents, so walking the
+  // merges backwards visits every parent before its children.
+  for (size_t node = numNodes - 1; node >= numPoints; --node)
+  {
+    if (fallen[node])
+      continue;
+
+    const size_t merge = node - numPoints;
+    const size_t left = (size_t) linkage(0, merge);
+    const size_t right = (size_t) linkage(1, merge);
+    const double distance = linkage(2, merge);
+    const double lambda = (distance > 0.0) ? 1.0 / distance : DBL_MAX;
+
+    const bool leftIsCluster = (Size(left) >= minClusterSize);
+    const bool rightIsCluster = (Size(right) >= minClusterSize);
+
+    if (leftIsCluster && rightIsCluster)
+    {
+      // A true split: both sides become new clusters.
+      labels[left] = nextLabel++;
+      addRow(labels[node], labels[left], lambda, Size(left));
+      labels[right] = nextLabel++;
+      addRow(labels[node], labels[right], lambda, Size(right));
+      continue;
+    }
+
+    // The larger side (if large enough) carries on the cluster, and the points
+    // of the other sides fall out of it.
+    stack.clear();
+    if (leftIsCluster)
+      labels[left] = labels[node];
+    else
+      stack.push_back(left);
+
+    if (rightIsCluster)
+      labels[right] = labels[node];
+    else
+      stack.push_back(right);
+
+    while (!stack.empty())
+    {
+      const size_t child = stack.back();
+      stack.pop_back();
+      if (child < numPoints)
+      {
+        addRow(labels[node], child, lambda, 1);
+      }
+      else
+      {
+        fallen[child] = true;
+        stack.push_back((size_t) linkage(0, child - numPoints));
+        stack.push_back((size_t) linkage(1, child - numPoints));
+      }
+    }
+  }
+
+  condensedTree.set_size(4, parents.size());
+  for (size_t i = 0; i < parents.size(); ++i)
+  {
+    condensedTree(0, i) = parents[i];
+    condensedTree(1, i) = children[i];
+    condensedTree(2, i) = lambdas[i];
+    condensedTree(3, i) = childSizes[i];
+  }
+}
+
+size_t Dendrogram::ExtractClusters(const size_t minClusterSize,
+                                   arma::Row<size_t>& assignments) const
+{
+  arma::mat condensedTree;
+  Condense(minClusterSize, condensedTree);
+
+  assignments.set_size(numPoints);
+  assignments.fill(SIZE_MAX);
+  if (condensedTree.n_cols == 0)
+    return 0;
+
+  // Clusters are indexed from numPoints on; the root is the first one.
+  const size_t numLabels = (size_t) std::max(arma::max(condensedTree.row(0)),
+      arma::max(condensedTree.row(1))) - numPoints + 1;
+
+  // Find the lambda each cluster was born at and its parent.
+  std::vector<double> birth(numLabels, 0.0);
+  std::vector<size_t> parent(numLabels, SIZE_MAX);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    const size_t child = (size_t) condensedTree(1, i);
+    if (child >= numPoints)
+    {
+      birth[child - numPoints] = condensedTree(2, i);
+      parent[child - numPoints] = (size_t) condensedTree(0, i) - numPoints;
+    }
+  }
+
+  // The stability of a cluster is the sum of (lambda - birth) over its points,
+  // where lambda is the value at which each point left the cluster.
+  std::vector<double> stability(numLabels, 0.0);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    const size_t p = (size_t) condensedTree(0, i) - numPoints;
+    stability[p] += (condensedTree(2, i) - birth[p]) * condensedTree(3, i);
+  }
+
+  // Select clusters bottom-up: a cluster is kept if it is more stable than its
+  // selected descendants together.  Children always have larger labels than
+  // their parents.  The root is never selected.
+  std::vector<bool> selected(numLabels, false);
+  std::vector<double> childStability(numLabels, 0.0);
+  std::vector<bool> hasChildren(numLabels, false);
+  for (size_t c = numLabels - 1; c > 0; --c)
+  {
+    if (hasChildren[c] && childStability[c] > stability[c])
+      stability[c] = childStability[c];
+    else
+      selected[c] = true;
+
+    childStability[parent[c]] += stability[c];
+    hasChildren[parent[c]] = true;
+  }
+
+  // Only keep the topmost selected clusters, and find the selected cluster
+  // each cluster belongs to.
+  std::vector<size_t> owner(numLabels, SIZE_MAX);
+  for (size_t c = 1; c < numLabels; ++c)
+  {
+    if (owner[parent[c]] != SIZE_MAX)
+      owner[c] = owner[parent[c]];
+    else if (selected[c])
+      owner[c] = c;
+  }
+
+  std::vector<size_t> pointOwner(numPoints, SIZE_MAX);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    const size_t child = (size_t) condensedTree(1, i);
+    if (child < numPoints)
+      pointOwner[child] = owner[(size_t) condensedTree(0, i) - numPoints];
+  }
+
+  // Number the selected clusters in order of their first point.
+  std::vector<size_t> labels(numLabels, SIZE_MAX);
+  size_t numSelected = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t c = pointOwner[i];
+    if (c == SIZE_MAX)
+      continue;
+
+    if (labels[c] == SIZE_MAX)
+      labels[c] = numSelected++;
+    assignments[i] = labels[c];
+  }
+
+  return numSelected;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file dendrogram.hpp
+ *
+ * Definition of the Dendrogram class, which holds the single-linkage
+ * hierarchical clustering of a dataset built from its minimum spanning tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_DENDROGRAM_HPP
+#define MLPACK_METHODS_HDBSCAN_DENDROGRAM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace hdbscan /** HDBSCAN and single-linkage clustering. */ {
+
+/**
+ * The Dendrogram class holds a single-linkage hierarchical clustering.  It is
+ * built from a minimum spanning tree (for instance, the output of
+ * emst::DualTreeBoruvka::ComputeMST()) by merging the components joined by
+ * the edges in order of increasing distance, which takes O(n log n) time.
+ *
+ * The merges are stored in the same format as the linkage matrices of SciPy:
+ * column i of Linkage() holds the two clusters merged at step i, the distance
+ * they were merged at, and the number of points in the merged cluster.  The
+ * clusters 0, ..., (n - 1) are the points themselves, and cluster (n + i) is
+ * the cluster created at step i.
+ *
+ * The dendrogram can be cut at any distance with Cut(), which gives the
+ * clusters of DBSCAN* for every epsilon from one minimum spanning tree, or
+ * condensed with Condense() to extract the most stable clusters, as HDBSCAN
+ * does:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density
+ *       estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data
+ *       Mining (PAKDD 2013)},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ */
+class Dendrogram
+{
+ public:
+  /**
+   * Create an empty dendrogram.
+   */
+  Dendrogram() : numPoints(0) { }
+
+  /**
+   * Build the dendrogram from the given minimum spanning tree.  The spanning
+   * tree must be given as a 3 x (n - 1) matrix, where each column holds the
+   * indices of the two points joined by an edge and the length of the edge.
+   * The edges do not need to be sorted.
+   *
+   * @param spanningTree Minimum spanning tree of the dataset.
+   */
+  Dendrogram(const arma::mat& spanningTree);
+
+  /**
+   * Cut the dendrogram at the given distance: two points are in the same
+   * cluster if they are joined by a path of edges no longer than the distance.
+   * Clusters with fewer than minClusterSize points are labeled as noise (with
+   * the label SIZE_MAX).  The clusters are numbered in order of their first
+   * point.
+   *
+   * @param distance Distance to cut the dendrogram at.
+   * @param assignments Vector to store the cluster of each point in.
+   * @param minClusterSize Minimum number of points in a cluster.
+   * @return The number of clusters.
+   */
+  size_t Cut(const double distance,
+             arma::Row<size_t>& assignments,
+             const size_t minClusterSize = 1) const;
+
+  /**
+   * Condense the dendrogram: walking down from the root, a split is only a
+   * real split if both sides have at least minClusterSize points; otherwise,
+   * the points on the smaller side fall out of the cluster.  The condensed
+   * tree is stored as a 4 x m matrix, where each column holds a parent cluster,
+   * a child (a cluster if the index is at least n, or a point otherwise), the
+   * value of lambda = 1 / distance where the child left the parent, and the
+   * number of points in the child.  The root cluster has the index n.
+   *
+   * @param minClusterSize Minimum number of points in a cluster (at least 2).
+   * @param condensedTree Matrix to store the condensed tree in.
+   */
+  void Condense(const size_t minClusterSize, arma::mat& condensedTree) const;
+
+  /**
+   * Extract the flat clustering with the most stable clusters of the condensed
+   * tree (the "excess of mass" criterion of HDBSCAN).  Points that are not in
+   * any selected cluster are labeled as noise (with the label SIZE_MAX).
+   *
+   * @param minClusterSize Minimum number of points in a cluster (at least 2).
+   * @param assignments Vector to store the cluster of each point in.
+   * @return The number of clusters.
+   */
+  size_t ExtractClusters(const size_t minClusterSize,
+                         arma::Row<size_t>& assignments) const;
+
+  //! Get the number of points in the dendrogram.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the merges of the dendrogram, as a 4 x (n - 1) matrix.
+  const arma::mat& Linkage() const { return linkage; }
+
+  //! Serialize the dendrogram.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numPoints);
+    ar & BOOST_SERIALIZATION_NVP(linkage);
+    ar & BOOST_SERIALIZATION_NVP(edges);
+  }
+
+ private:
+  //! Number of points.
+  size_t numPoints;
+  //! The merges, in the format of SciPy linkage matrices.
+  arma::mat linkage;
+  //! For each merge, the two points of the edge that caused it.
+  arma::Mat<size_t> edges;
+
+  //! Get the number of points in the given cluster of the dendrogram.
+  size_t Size(const size_t cluster) const
+  {
+    return (cluster < numPoints) ? 1 : (size_t) linkage(3, cluster - numPoints);
+  }
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file hdbscan.hpp
+ *
+ * An implementation of HDBSCAN clustering on top of the dual-tree Boruvka
+ * minimum spanning tree algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "dendrogram.hpp"
+
+namespace mlpack {
+namespace hdbscan {
+
+/**
+ * HDBSCAN (Hierarchical DBSCAN) clusters a dataset for all density thresholds
+ * at once, and extracts the most stable clusters of the hierarchy.  The core
+ * distance of each point is the distance to its minPoints-th nearest neighbor
+ * (counting the point itself), and is computed with one nearest neighbor
+ * search.  The minimum spanning tree of the dataset under the mutual
+ * reachability distance
+ *
+ *   d_mreach(a, b) = max(core(a), core(b), d(a, b))
+ *
+ * is then computed with the dual-tree Boruvka algorithm, and turned into a
+ * single-linkage Dendrogram.  Cutting that dendrogram at a distance epsilon
+ * gives the clusters of DBSCAN* with that epsilon, so every value of epsilon
+ * can be explored without running another range search.  For more
+ * information, see the following paper:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density
+ *       estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data
+ *       Mining (PAKDD 2013)},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * With minPoints = 1, the core distances are all zero, and the dendrogram is
+ * the plain single-linkage hierarchical clustering of the dataset.
+ *
+ * @tparam MetricType The metric to use.
+ * @tparam MatType The type of data matrix to use.
+ * @tparam TreeType Type of tree to use for the nearest neighbor search and the
+ *     minimum spanning tree.
+ */
+template<
+    typename MetricType = metric::EuclideanDistance,
+    typename MatType = arma::mat,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType = tree::KDTree
+>
+class HDBSCAN
+{
+ public:
+  /**
+   * Construct the HDBSCAN object with the given parameters.
+   *
+   * @param minClusterSize Minimum number of points in a cluster (at least 2).
+   * @param minPoints Number of neighbors (counting the point itself) used for
+   *     the core distances; if 0, minClusterSize is used.
+   */
+  HDBSCAN(const size_t minClusterSize = 5, const size_t minPoints = 0);
+
+  /**
+   * Cluster the given dataset, returning the number of clusters.  Points that
+   * are not in any cluster are labeled as noise (with the label SIZE_MAX).
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store the cluster of each point in.
+   * @return The number of clusters.
+   */
+  size_t Cluster(const MatType& data, arma::Row<size_t>& assignments);
+
+  /**
+   * Cluster the given dataset, returning the number of clusters and also the
+   * dendrogram, which can be used to get the DBSCAN* clustering for any
+   * epsilon with Dendrogram::Cut().
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store the cluster of each point in.
+   * @param dendrogram Dendrogram to store the hierarchy in.
+   * @return The number of clusters.
+   */
+  size_t Cluster(const MatType& data,
+                 arma::Row<size_t>& assignments,
+                 Dendrogram& dendrogram);
+
+  /**
+   * Compute the mutual reachability dendrogram of the dataset.
+   *
+   * @param data Dataset to build the dendrogram of.
+   * @param dendrogram Dendrogram to store the hierarchy in.
+   */
+  void ComputeDendrogram(const MatType& data, Dendrogram& dendrogram);
+
+  /**
+   * Compute the core distance of each point: the distance to its minPoints-th
+   * nearest neighbor, counting the point itself.
+   *
+   * @param data Dataset to compute the core distances of.
+   * @param minPoints Number of neighbors (counting the point itself).
+   * @param coreDistances Vector to store the core distances in.
+   */
+  static void CoreDistances(const MatType& data,
+                            const size_t minPoints,
+                            arma::vec& coreDistances);
+
+  //! Get the minimum number of points in a cluster.
+  size_t MinClusterSize() const { return minClusterSize; }
+  //! Modify the minimum number of points in a cluster.
+  size_t& MinClusterSize() { return minClusterSize; }
+
+  //! Get the number of neighbors used for the core distances (0 means
+  //! MinClusterSize()).
+  size_t MinPoints() const { return minPoints; }
+  //! Modify the number of neighbors used for the core distances (0 means
+  //! MinClusterSize()).
+  size_t& MinPoints() { return minPoints; }
+
+ private:
+  //! Minimum number of points in a cluster.
+  size_t minClusterSize;
+  //! Number of neighbors used for the core distances.
+  size_t minPoints;
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "hdbscan_impl.hpp"
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file hdbscan_impl.hpp
+ *
+ * Implementation of HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hdbscan.hpp"
+
+namespace mlpack {
+namespace hdbscan {
+
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+HDBSCAN<MetricType, MatType, TreeType>::HDBSCAN(const size_t minClusterSize,
+                                                const size_t minPoints) :
+    minClusterSize(minClusterSize),
+    minPoints(minPoints)
+{
+  if (minClusterSize < 2)
+  {
+    throw std::invalid_argument("HDBSCAN::HDBSCAN(): minClusterSize must be at "
+        "least 2!");
+  }
+}
+
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, MatType, TreeType>::Cluster(
+    const MatType& data,
+    arma::Row<size_t>& assignments)
+{
+  Dendrogram dendrogram;
+  return Cluster(data, assignments, dendrogram);
+}
+
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, MatType, TreeType>::Cluster(
+    const MatType& data,
+    arma::Row<size_t>& assignments,
+    Dendrogram& dendrogram)
+{
+  ComputeDendrogram(data, dendrogram);
+
+  Timer::Start("hdbscan/extract_clusters");
+  const size_t numClusters = dendrogram.ExtractClusters(minClusterSize,
+      assignments);
+  Timer::Stop("hdbscan/extract_clusters");
+
+  Log::Info << numClusters << " clusters found." << std::endl;
+  return numClusters;
+}
+
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void HDBSCAN<MetricType, MatType, TreeType>::ComputeDendrogram(
+    const MatType& data,
+    Dendrogram& dendrogram)
+{
+  if (data.n_cols < 2)
+  {
+    throw std::invalid_argument("HDBSCAN::ComputeDendrogram(): dataset must "
+        "have at least 2 points!");
+  }
+
+  arma::vec coreDistances;
+  CoreDistances(data, (minPoints == 0) ? minClusterSize : minPoints,
+      coreDistances);
+
+  emst::DualTreeBoruvka<MetricType, MatType, TreeType> dtb(data);
+  arma::mat spanningTree;
+  dtb.ComputeMST(spanningTree, coreDistances);
+
+  dendrogram = Dendrogram(spanningTree);
+}
+
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void HDBSCAN<MetricType, MatType, TreeType>::CoreDistances(
+    const MatType& data,
+    const size_t minPoints,
+    arma::vec& coreDistances)
+{
+  coreDistances.zeros(data.n_cols);
+  if (minPoints <= 1)
+    return;
+
+  if (minPoints > data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::CoreDistances(): minPoints (" << minPoints << ") is "
+        << "greater than the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("hdbscan/core_distances");
+
+  // The point itself is not returned by the search, so it counts as the first
+  // neighbor.
+  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
+      TreeType> knn(data);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(minPoints - 1, neighbors, distances);
+  coreDistances = distances.row(minPoints - 2).t();
+
+  Timer::Stop("hdbscan/core_distances");
+}
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
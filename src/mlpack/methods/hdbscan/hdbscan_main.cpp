@@ -0,0 +1,124 @@
+/**
+ * @file hdbscan_main.cpp
+ *
+ * Implementation of program to run HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "hdbscan.hpp"
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("HDBSCAN clustering",
+    // Short description.
+    "An implementation of HDBSCAN hierarchical density-based clustering.  "
+    "Given a dataset, this can compute the single-linkage hierarchy of its "
+    "mutual reachability distances, and return the most stable clusters or the "
+    "DBSCAN* clusters for a given radius.",
+    // Long description.
+    "This program implements the HDBSCAN algorithm for clustering.  The core "
+    "distance of each point (the distance to its k-th nearest neighbor) is "
+    "computed with one nearest neighbor search, and the minimum spanning tree "
+    "of the mutual reachability distances is computed with the dual-tree "
+    "Boruvka algorithm; this tree holds the clusterings for every density "
+    "threshold."
+    "\n\n"
+    "The input dataset to be clustered may be specified with the " +
+    PRINT_PARAM_STRING("input") + " parameter; the minimum number of points in "
+    "a cluster may be specified with the " +
+    PRINT_PARAM_STRING("min_cluster_size") + " parameter, and the number of "
+    "neighbors used for the core distances (counting the point itself) may be "
+    "specified with the " + PRINT_PARAM_STRING("min_points") + " parameter.  "
+    "If " + PRINT_PARAM_STRING("min_points") + " is 0, the minimum cluster "
+    "size is used.  If " + PRINT_PARAM_STRING("min_points") + " is 1, the "
+    "hierarchy is the single-linkage clustering of the dataset."
+    "\n\n"
+    "By default, the most stable clusters of the hierarchy are returned in "
+    "the " + PRINT_PARAM_STRING("assignments") + " output parameter.  If a "
+    "radius is given with the " + PRINT_PARAM_STRING("cut_distance") +
+    " parameter, the hierarchy is instead cut at that distance, which gives "
+    "the same clusters as DBSCAN* with that radius.  Points that are not in "
+    "any cluster are labeled as noise with the largest possible label."
+    "\n\n"
+    "The hierarchy may be saved with the " + PRINT_PARAM_STRING("dendrogram") +
+    " output parameter, as a matrix with four rows where each column is a "
+    "merge: the two merged clusters (clusters below the number of points are "
+    "the points themselves, and cluster n + i is the cluster created by merge "
+    "i), the distance of the merge, and the number of points in the merged "
+    "cluster."
+    "\n\n"
+    "An example usage to run HDBSCAN on the dataset in " +
+    PRINT_DATASET("input") + " with a minimum cluster size of 10 is given "
+    "below:"
+    "\n\n" +
+    PRINT_CALL("hdbscan", "input", "input", "min_cluster_size", 10,
+        "assignments", "assignments"),
+    SEE_ALSO("Density-based clustering based on hierarchical density "
+        "estimates", "https://doi.org/10.1007/978-3-642-37456-2_14"),
+    SEE_ALSO("@dbscan", "#dbscan"),
+    SEE_ALSO("@emst", "#emst"),
+    SEE_ALSO("mlpack::hdbscan::HDBSCAN class documentation",
+        "@doxygen/classmlpack_1_1hdbscan_1_1HDBSCAN.html"));
+
+PARAM_MATRIX_IN_REQ("input", "Input dataset to cluster.", "i");
+PARAM_UROW_OUT("assignments", "Output matrix for assignments of each "
+    "point.", "a");
+PARAM_MATRIX_OUT("dendrogram", "Matrix to save the single-linkage hierarchy "
+    "of the mutual reachability distances to.", "d");
+
+PARAM_INT_IN("min_cluster_size", "Minimum number of points for a cluster.",
+    "m", 5);
+PARAM_INT_IN("min_points", "Number of neighbors (counting the point itself) "
+    "used to compute the core distances; 0 means the minimum cluster size.",
+    "k", 0);
+PARAM_DOUBLE_IN("cut_distance", "If given, cut the hierarchy at this distance "
+    "instead of extracting the most stable clusters.", "e", 0.0);
+
+static void mlpackMain()
+{
+  RequireAtLeastOnePassed({ "assignments", "dendrogram" }, false,
+      "no output will be saved");
+
+  RequireParamValue<int>("min_cluster_size", [](int x) { return x >= 2; },
+      true, "minimum cluster size must be at least 2");
+  RequireParamValue<int>("min_points", [](int x) { return x >= 0; },
+      true, "number of neighbors must be nonnegative");
+  if (CLI::HasParam("cut_distance"))
+  {
+    RequireParamValue<double>("cut_distance", [](double x) { return x >= 0; },
+        true, "cut distance must be nonnegative");
+  }
+
+  arma::mat dataset = std::move(CLI::GetParam<arma::mat>("input"));
+  const size_t minClusterSize = (size_t) CLI::GetParam<int>("min_cluster_size");
+  const size_t minPoints = (size_t) CLI::GetParam<int>("min_points");
+
+  HDBSCAN<> h(minClusterSize, minPoints);
+  Dendrogram dendrogram;
+  arma::Row<size_t> assignments;
+  if (CLI::HasParam("cut_distance"))
+  {
+    h.ComputeDendrogram(dataset, dendrogram);
+    const size_t numClusters = dendrogram.Cut(
+        CLI::GetParam<double>("cut_distance"), assignments, minClusterSize);
+    Log::Info << numClusters << " clusters found." << endl;
+  }
+  else
+  {
+    h.Cluster(dataset, assignments, dendrogram);
+  }
+
+  if (CLI::HasParam("assignments"))
+    CLI::GetParam<arma::Row<size_t>>("assignments") = std::move(assignments);
+  if (CLI::HasParam("dendrogram"))
+    CLI::GetParam<arma::mat>("dendrogram") = dendrogram.Linkage();
+}
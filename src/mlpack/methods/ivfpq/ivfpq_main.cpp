@@ -0,0 +1,249 @@
+/**
+ * @file ivfpq_main.cpp
+ *
+ * This file computes the approximate nearest neighbors with a compressed
+ * inverted-file, product-quantized (IVF-PQ) index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include <mlpack/methods/lsh/lsh_search.hpp>
+#include "ivfpq_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with IVF-PQ",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search on a "
+    "compressed index built with an inverted file and product quantization "
+    "(IVF-PQ).  Given a set of reference points and a set of query points, "
+    "this will compute the k approximate nearest neighbors of each query point "
+    "in the reference set; models can be saved for future use.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a compressed IVF-PQ index.  The reference points are "
+    "split into " + PRINT_PARAM_STRING("lists") + " cells with k-means, and "
+    "the difference between each point and the centroid of its cell is split "
+    "into " + PRINT_PARAM_STRING("subspaces") + " blocks of dimensions, each "
+    "of which is replaced by the index of the nearest of " +
+    PRINT_PARAM_STRING("centroids") + " centroids of that block; a point "
+    "therefore only takes one byte per subspace."
+    "\n\n"
+    "A search visits the " + PRINT_PARAM_STRING("probes") + " cells closest "
+    "to each query point and computes approximate distances to their points "
+    "with lookup tables.  If " + PRINT_PARAM_STRING("rerank") + " is positive, "
+    "the reference points are also kept in the model, and the best " +
+    PRINT_PARAM_STRING("rerank") + " candidates are re-ranked with their exact "
+    "distances.  To speed up training, the quantizers can be learned on a "
+    "random sample of " + PRINT_PARAM_STRING("training_size") + " reference "
+    "points."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("ivfpq", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points.  Unless the candidates are re-ranked, "
+    "the distances are approximate.",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("Product quantization for nearest neighbor search (pdf)",
+        "https://hal.inria.fr/inria-00514462/document"),
+    SEE_ALSO("mlpack::neighbor::IVFPQSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1IVFPQSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(IVFPQSearch<>, "input_model", "Input IVF-PQ model.", "m");
+PARAM_MODEL_OUT(IVFPQSearch<>, "output_model", "Output for trained IVF-PQ "
+    "model.", "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points.", "q");
+
+PARAM_INT_IN("lists", "Number of cells of the coarse quantizer.", "l", 64);
+PARAM_INT_IN("subspaces", "Number of subspaces; each point is encoded with "
+    "one byte per subspace.", "S", 8);
+PARAM_INT_IN("centroids", "Number of centroids of each subspace (at most "
+    "256).", "C", 256);
+PARAM_INT_IN("probes", "Number of cells visited for each query point.", "p",
+    1);
+PARAM_INT_IN("rerank", "Number of candidates re-ranked with their exact "
+    "distances; if 0, no re-ranking is done and the reference points are not "
+    "kept in the model.", "R", 0);
+PARAM_INT_IN("training_size", "Number of reference points the quantizers are "
+    "learned on; if 0, all the reference points are used.", "T", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+    RequireAtLeastOnePassed({ "query", "reference" }, true, "must pass set to "
+        "search");
+  }
+
+  RequireParamValue<int>("lists", [](int x) { return x > 0; }, true,
+      "number of lists must be greater than 0");
+  RequireParamValue<int>("subspaces", [](int x) { return x > 0; }, true,
+      "number of subspaces must be greater than 0");
+  RequireParamValue<int>("centroids", [](int x) { return x > 0 && x <= 256; },
+      true, "number of centroids must be between 1 and 256");
+  RequireParamValue<int>("probes", [](int x) { return x > 0; }, true,
+      "number of probes must be greater than 0");
+  RequireParamValue<int>("rerank", [](int x) { return x >= 0; }, true,
+      "number of re-ranked candidates must be non-negative");
+  RequireParamValue<int>("training_size", [](int x) { return x >= 0; }, true,
+      "training size must be non-negative");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+
+  ReportIgnoredParam({{ "reference", false }}, "lists");
+  ReportIgnoredParam({{ "reference", false }}, "subspaces");
+  ReportIgnoredParam({{ "reference", false }}, "centroids");
+  ReportIgnoredParam({{ "reference", false }}, "training_size");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  const size_t k = (size_t) CLI::GetParam<int>("k");
+
+  IVFPQSearch<>* ivfpq;
+  if (CLI::HasParam("reference"))
+  {
+    const size_t numLists = (size_t) CLI::GetParam<int>("lists");
+    const size_t numSubspaces = (size_t) CLI::GetParam<int>("subspaces");
+    const size_t numCentroids = (size_t) CLI::GetParam<int>("centroids");
+    const size_t rerank = (size_t) CLI::GetParam<int>("rerank");
+
+    arma::mat& referenceData = CLI::GetParam<arma::mat>("reference");
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    Log::Info << "Using IVF-PQ with " << numLists << " lists and "
+        << numSubspaces << " subspaces of " << numCentroids << " centroids."
+        << endl;
+
+    ivfpq = new IVFPQSearch<>(numLists, numSubspaces, numCentroids,
+        rerank > 0);
+
+    // Learn the quantizers, possibly on a sample of the reference set.
+    const size_t trainingSize = (size_t) CLI::GetParam<int>("training_size");
+    Timer::Start("training");
+    if (trainingSize > 0 && trainingSize < referenceData.n_cols)
+    {
+      const arma::uvec sample = arma::randperm(referenceData.n_cols,
+          trainingSize);
+      ivfpq->Train(referenceData.cols(sample));
+    }
+    else
+    {
+      ivfpq->Train(referenceData);
+    }
+    Timer::Stop("training");
+
+    Timer::Start("encoding");
+    ivfpq->Add(referenceData);
+    Timer::Stop("encoding");
+  }
+  else // We must have an input model.
+  {
+    ivfpq = CLI::GetParam<IVFPQSearch<>*>("input_model");
+    if (CLI::HasParam("rerank") && !ivfpq->KeepPoints())
+    {
+      Log::Warn << "The model does not keep the reference points; "
+          << PRINT_PARAM_STRING("rerank") << " is ignored." << endl;
+    }
+  }
+
+  if (CLI::HasParam("reference") || CLI::HasParam("probes"))
+    ivfpq->NumProbes() = (size_t) CLI::GetParam<int>("probes");
+  if (CLI::HasParam("reference") || CLI::HasParam("rerank"))
+    ivfpq->Rerank() = (size_t) CLI::GetParam<int>("rerank");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  if (CLI::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " distance approximate nearest neighbors."
+        << endl;
+
+    const arma::mat& queryData = CLI::HasParam("query") ?
+        CLI::GetParam<arma::mat>("query") :
+        CLI::GetParam<arma::mat>("reference");
+
+    Timer::Start("computing_neighbors");
+    ivfpq->Search(queryData, k, neighbors, distances);
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed." << endl;
+  }
+
+  // Compute recall, if desired.
+  if (CLI::HasParam("true_neighbors"))
+  {
+    // Load the true neighbors.
+    const arma::Mat<size_t>& trueNeighbors =
+        CLI::GetParam<arma::Mat<size_t>>("true_neighbors");
+
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+    {
+      Log::Fatal << "The true neighbors file must have the same number of "
+          << "values as the set of neighbors being queried!" << endl;
+    }
+
+    const double recallPercentage = 100 * LSHSearch<>::ComputeRecall(
+        neighbors, trueNeighbors);
+    Log::Info << "Recall: " << recallPercentage << endl;
+  }
+
+  // Save output, if we did a search.
+  if (CLI::HasParam("k"))
+  {
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+  CLI::GetParam<IVFPQSearch<>*>("output_model") = ivfpq;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file ivfpq_search.hpp
+ *
+ * Defines the IVFPQSearch class, which performs approximate nearest neighbor
+ * search on a compressed index: an inverted file of product-quantized codes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVFPQ_IVFPQ_SEARCH_HPP
+#define MLPACK_METHODS_IVFPQ_IVFPQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The IVFPQSearch class performs approximate nearest neighbor search (with the
+ * Euclidean distance) on a compressed representation of the reference set, so
+ * that reference sets much larger than the available memory can be searched.
+ *
+ * A coarse quantizer (the centroids of a k-means clustering) splits the space
+ * into numLists cells, and each reference point is stored in the inverted list
+ * of its cell.  The residual of the point (its difference with the centroid of
+ * the cell) is then split into numSubspaces blocks of dimensions, and each
+ * block is replaced by the index of the nearest of numCentroids centroids of
+ * that subspace (also found with k-means), so that a point only takes
+ * numSubspaces bytes.
+ *
+ * A search visits the numProbes lists whose centroids are closest to the query
+ * point.  For each visited list, the squared distances between the residual of
+ * the query and every centroid of every subspace are computed once into a
+ * lookup table; the distance to each code of the list is then the sum of
+ * numSubspaces entries of the table ("asymmetric distance computation").  If
+ * the original points are kept, the best candidates may be re-ranked with
+ * their exact distances.
+ *
+ * The quantizers are learned with Train() (typically on a sample of the
+ * reference set), and the points are encoded with Add(), which may be called
+ * several times on successive chunks of the reference set, so that the whole
+ * reference set never has to be held in memory.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, Herv{\'e} and Douze, Matthijs and Schmid, Cordelia},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * @tparam KMeansType The type of k-means clustering used to learn the coarse
+ *     quantizer and the codebooks.
+ */
+template<typename KMeansType = kmeans::KMeans<>>
+class IVFPQSearch
+{
+ public:
+  /**
+   * Create the IVFPQSearch object without training it; Train() and Add() must
+   * be called before searching.
+   *
+   * @param numLists Number of cells of the coarse quantizer.
+   * @param numSubspaces Number of blocks of dimensions quantized separately
+   *     (the size of a code in bytes).
+   * @param numCentroids Number of centroids of each subspace (at most 256).
+   * @param keepPoints Whether to keep the added points to re-rank candidates
+   *     with their exact distances.
+   * @param kmeans An optional instance of the KMeansType class.
+   */
+  IVFPQSearch(const size_t numLists = 64,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const bool keepPoints = false,
+              const KMeansType& kmeans = KMeansType());
+
+  /**
+   * Create the IVFPQSearch object, train the quantizers on the given reference
+   * set and add all its points to the index.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of cells of the coarse quantizer.
+   * @param numSubspaces Number of blocks of dimensions quantized separately.
+   * @param numCentroids Number of centroids of each subspace (at most 256).
+   * @param keepPoints Whether to keep the reference points for re-ranking.
+   * @param kmeans An optional instance of the KMeansType class.
+   */
+  IVFPQSearch(const arma::mat& referenceSet,
+              const size_t numLists = 64,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const bool keepPoints = false,
+              const KMeansType& kmeans = KMeansType());
+
+  /**
+   * Learn the coarse quantizer and the codebooks of the subspaces on the given
+   * training set.  This empties the index.
+   *
+   * @param trainingSet Set of points to learn the quantizers on; it must have
+   *     at least as many points as numLists and numCentroids.
+   */
+  void Train(const arma::mat& trainingSet);
+
+  /**
+   * Encode the given points and add them to the index.  The index of the first
+   * point is the number of points already in the index, so that a large
+   * reference set can be added in consecutive chunks.
+   *
+   * @param newPoints Set of points to add.
+   */
+  void Add(const arma::mat& newPoints);
+
+  /**
+   * Search for the k approximate nearest neighbors of each query point.  The
+   * distances are approximate unless the points are kept and re-ranked.  If
+   * fewer than k points are found in the visited lists, the remaining
+   * neighbors are set to SIZE_MAX and their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing the neighbors of each query point.
+   * @param distances Matrix storing the distances to the neighbors.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of cells of the coarse quantizer.
+  size_t NumLists() const { return numLists; }
+  //! Get the number of subspaces.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids of each subspace.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get whether the added points are kept for re-ranking.
+  bool KeepPoints() const { return keepPoints; }
+
+  //! Get the number of lists visited by a search.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the number of lists visited by a search.
+  size_t& NumProbes() { return numProbes; }
+
+  //! Get the number of candidates re-ranked with their exact distances (0 to
+  //! disable re-ranking).
+  size_t Rerank() const { return rerank; }
+  //! Modify the number of candidates re-ranked with their exact distances.
+  size_t& Rerank() { return rerank; }
+
+  //! Get the number of points in the index.
+  size_t Size() const { return size; }
+
+  //! Get the centroids of the coarse quantizer.
+  const arma::mat& Centroids() const { return centroids; }
+  //! Get the codebooks; the rows of a subspace hold its centroids as columns.
+  const arma::mat& Codebooks() const { return codebooks; }
+
+  //! Get the indices of the points of the given list.
+  const std::vector<size_t>& ListIndices(const size_t list) const
+  { return listIndices[list]; }
+  //! Get the codes of the points of the given list, one after the other.
+  const std::vector<unsigned char>& ListCodes(const size_t list) const
+  { return listCodes[list]; }
+
+  //! Get the kept points (empty unless KeepPoints() is true).
+  const arma::mat& Points() const { return points; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A point and its (squared) distance to the query point.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Get the first dimension of the given subspace.
+  size_t SubspaceBegin(const size_t subspace) const
+  { return subspace * centroids.n_rows / numSubspaces; }
+
+  //! Get the index of the column of the given centroids nearest to the given
+  //! point.
+  template<typename VecType, typename CentroidsType>
+  static size_t Nearest(const VecType& point, const CentroidsType& centroids);
+
+  /**
+   * Fill the lookup table of the given residual: table(j, m) is the squared
+   * distance between the m'th block of the residual and the j'th centroid of
+   * subspace m.
+   */
+  void ComputeTable(const arma::vec& residual, arma::fmat& table) const;
+
+  //! Number of cells of the coarse quantizer.
+  size_t numLists;
+  //! Number of subspaces.
+  size_t numSubspaces;
+  //! Number of centroids of each subspace.
+  size_t numCentroids;
+  //! Whether the added points are kept.
+  bool keepPoints;
+  //! Number of lists visited by a search.
+  size_t numProbes;
+  //! Number of candidates re-ranked with their exact distances.
+  size_t rerank;
+  //! The k-means object used for training.
+  KMeansType kmeans;
+
+  //! Number of points in the index.
+  size_t size;
+  //! Centroids of the coarse quantizer.
+  arma::mat centroids;
+  //! Centroids of the subspaces, stacked along the dimensions.
+  arma::mat codebooks;
+  //! Indices of the points of each list.
+  std::vector<std::vector<size_t>> listIndices;
+  //! Codes of the points of each list, numSubspaces bytes per point.
+  std::vector<std::vector<unsigned char>> listCodes;
+  //! The added points, if they are kept.
+  arma::mat points;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivfpq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,357 @@
+/**
+ * @file ivfpq_search_impl.hpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVFPQ_IVFPQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_IVFPQ_IVFPQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivfpq_search.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <numeric>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename KMeansType>
+IVFPQSearch<KMeansType>::IVFPQSearch(const size_t numLists,
+                                     const size_t numSubspaces,
+                                     const size_t numCentroids,
+                                     const bool keepPoints,
+                                     const KMeansType& kmeans) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    keepPoints(keepPoints),
+    numProbes(1),
+    rerank(0),
+    kmeans(kmeans),
+    size(0)
+{
+  if (numLists == 0 || numSubspaces == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::IVFPQSearch(): the number of "
+        "lists and the number of subspaces must be positive!");
+  }
+
+  // The codes are stored on one byte.
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::IVFPQSearch(): the number of centroids of a subspace "
+        << "must be between 1 and 256 (" << numCentroids << " given)!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename KMeansType>
+IVFPQSearch<KMeansType>::IVFPQSearch(const arma::mat& referenceSet,
+                                     const size_t numLists,
+                                     const size_t numSubspaces,
+                                     const size_t numCentroids,
+                                     const bool keepPoints,
+                                     const KMeansType& kmeans) :
+    IVFPQSearch(numLists, numSubspaces, numCentroids, keepPoints, kmeans)
+{
+  Train(referenceSet);
+  Add(referenceSet);
+}
+
+template<typename KMeansType>
+void IVFPQSearch<KMeansType>::Train(const arma::mat& trainingSet)
+{
+  if (trainingSet.n_cols < numLists || trainingSet.n_cols < numCentroids)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): the training set has " << trainingSet.n_cols
+        << " points, but at least " << std::max(numLists, numCentroids)
+        << " are needed!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (trainingSet.n_rows < numSubspaces)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): cannot split " << trainingSet.n_rows
+        << " dimensions into " << numSubspaces << " subspaces!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Learn the coarse quantizer.
+  kmeans.Cluster(trainingSet, numLists, centroids);
+
+  // The codebooks quantize the residuals of the points.
+  arma::mat residuals(trainingSet.n_rows, trainingSet.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) trainingSet.n_cols; ++i)
+  {
+    const size_t list = Nearest(trainingSet.col(i), centroids);
+    residuals.col(i) = trainingSet.col(i) - centroids.col(list);
+  }
+
+  codebooks.set_size(trainingSet.n_rows, numCentroids);
+  for (size_t m = 0; m < numSubspaces; ++m)
+  {
+    const size_t begin = SubspaceBegin(m);
+    const size_t end = SubspaceBegin(m + 1);
+
+    arma::mat subspace = residuals.rows(begin, end - 1);
+    arma::mat subspaceCentroids;
+    kmeans.Cluster(subspace, numCentroids, subspaceCentroids);
+    codebooks.rows(begin, end - 1) = subspaceCentroids;
+  }
+
+  // Any previously added point was encoded with other quantizers.
+  size = 0;
+  listIndices.assign(numLists, std::vector<size_t>());
+  listCodes.assign(numLists, std::vector<unsigned char>());
+  points.reset();
+}
+
+template<typename KMeansType>
+void IVFPQSearch<KMeansType>::Add(const arma::mat& newPoints)
+{
+  if (centroids.is_empty())
+  {
+    throw std::invalid_argument("IVFPQSearch::Add(): the quantizers must be "
+        "trained before adding points!");
+  }
+
+  if (newPoints.n_rows != centroids.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Add(): dimensionality of the points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality of the "
+        << "index (" << centroids.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Encode the points in parallel.
+  arma::Row<size_t> assignments(newPoints.n_cols);
+  arma::Mat<unsigned char> codes(numSubspaces, newPoints.n_cols);
+  #pragma omp parallel
+  {
+    arma::vec residual;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) newPoints.n_cols; ++i)
+    {
+      const size_t list = Nearest(newPoints.col(i), centroids);
+      assignments[i] = list;
+      residual = newPoints.col(i) - centroids.col(list);
+
+      for (size_t m = 0; m < numSubspaces; ++m)
+      {
+        const size_t begin = SubspaceBegin(m);
+        const size_t end = SubspaceBegin(m + 1);
+        codes(m, i) = (unsigned char) Nearest(residual.subvec(begin, end - 1),
+            codebooks.rows(begin, end - 1));
+      }
+    }
+  }
+
+  // Append the codes to their lists.
+  for (size_t i = 0; i < newPoints.n_cols; ++i)
+  {
+    const size_t list = assignments[i];
+    listIndices[list].push_back(size + i);
+    listCodes[list].insert(listCodes[list].end(), codes.colptr(i),
+        codes.colptr(i) + numSubspaces);
+  }
+  size += newPoints.n_cols;
+
+  if (keepPoints)
+    points.insert_cols(points.n_cols, newPoints);
+}
+
+template<typename KMeansType>
+void IVFPQSearch<KMeansType>::Search(const arma::mat& querySet,
+                                     const size_t k,
+                                     arma::Mat<size_t>& neighbors,
+                                     arma::mat& distances) const
+{
+  if (k > size)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): requested value of k (" << k << ") is "
+        << "greater than the number of points in the index (" << size << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != centroids.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "index (" << centroids.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), numLists);
+  const bool exact = keepPoints && rerank > 0;
+  const size_t numCandidates = exact ? std::max(k, rerank) : k;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel
+  {
+    // Scratch space of each thread.
+    arma::vec coarseDistances(numLists);
+    std::vector<size_t> order(numLists);
+    arma::vec residual;
+    arma::fmat table(numCentroids, numSubspaces);
+    std::vector<Candidate> candidates;
+    candidates.reserve(numCandidates);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      // Find the lists to visit.
+      for (size_t l = 0; l < numLists; ++l)
+      {
+        coarseDistances[l] = metric::SquaredEuclideanDistance::Evaluate(
+            querySet.col(q), centroids.col(l));
+      }
+      std::iota(order.begin(), order.end(), 0);
+      std::partial_sort(order.begin(), order.begin() + probes, order.end(),
+          [&](const size_t a, const size_t b)
+          { return coarseDistances[a] < coarseDistances[b]; });
+
+      // The candidates are kept in a heap with the worst one on top.
+      candidates.clear();
+      for (size_t p = 0; p < probes; ++p)
+      {
+        const size_t list = order[p];
+        const std::vector<size_t>& indices = listIndices[list];
+        if (indices.empty())
+          continue;
+
+        residual = querySet.col(q) - centroids.col(list);
+        ComputeTable(residual, table);
+
+        // Scan the codes of the list; each distance is a sum of lookups.
+        const float* t = table.memptr();
+        const unsigned char* code = listCodes[list].data();
+        for (size_t i = 0; i < indices.size(); ++i, code += numSubspaces)
+        {
+          float distance = 0;
+          for (size_t m = 0; m < numSubspaces; ++m)
+            distance += t[m * numCentroids + code[m]];
+
+          if (candidates.size() < numCandidates)
+          {
+            candidates.push_back(Candidate(distance, indices[i]));
+            std::push_heap(candidates.begin(), candidates.end());
+          }
+          else if (distance < candidates.front().first)
+          {
+            std::pop_heap(candidates.begin(), candidates.end());
+            candidates.back() = Candidate(distance, indices[i]);
+            std::push_heap(candidates.begin(), candidates.end());
+          }
+        }
+      }
+
+      // Re-rank the candidates with their exact distances.
+      if (exact)
+      {
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+          candidates[i].first = metric::SquaredEuclideanDistance::Evaluate(
+              querySet.col(q), points.col(candidates[i].second));
+        }
+      }
+      std::sort(candidates.begin(), candidates.end());
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (j < candidates.size())
+        {
+          neighbors(j, q) = candidates[j].second;
+          distances(j, q) = std::sqrt(std::max(candidates[j].first, 0.0));
+        }
+        else
+        {
+          neighbors(j, q) = SIZE_MAX;
+          distances(j, q) = DBL_MAX;
+        }
+      }
+    }
+  }
+}
+
+template<typename KMeansType>
+template<typename VecType, typename CentroidsType>
+size_t IVFPQSearch<KMeansType>::Nearest(const VecType& point,
+                                        const CentroidsType& centroids)
+{
+  size_t best = 0;
+  double bestDistance = DBL_MAX;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    const double distance = metric::SquaredEuclideanDistance::Evaluate(point,
+        centroids.col(j));
+    if (distance < bestDistance)
+    {
+      bestDistance = distance;
+      best = j;
+    }
+  }
+
+  return best;
+}
+
+template<typename KMeansType>
+void IVFPQSearch<KMeansType>::ComputeTable(const arma::vec& residual,
+                                           arma::fmat& table) const
+{
+  for (size_t m = 0; m < numSubspaces; ++m)
+  {
+    const size_t begin = SubspaceBegin(m);
+    const size_t end = SubspaceBegin(m + 1);
+    float* column = table.colptr(m);
+    for (size_t j = 0; j < numCentroids; ++j)
+    {
+      const double* centroid = codebooks.colptr(j);
+      double distance = 0.0;
+      for (size_t d = begin; d < end; ++d)
+      {
+        const double diff = residual[d] - centroid[d];
+        distance += diff * diff;
+      }
+      column[j] = (float) distance;
+    }
+  }
+}
+
+template<typename KMeansType>
+template<typename Archive>
+void IVFPQSearch<KMeansType>::serialize(Archive& ar,
+                                        const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numLists);
+  ar & BOOST_SERIALIZATION_NVP(numSubspaces);
+  ar & BOOST_SERIALIZATION_NVP(numCentroids);
+  ar & BOOST_SERIALIZATION_NVP(keepPoints);
+  ar & BOOST_SERIALIZATION_NVP(numProbes);
+  ar & BOOST_SERIALIZATION_NVP(rerank);
+  ar & BOOST_SERIALIZATION_NVP(size);
+  ar & BOOST_SERIALIZATION_NVP(centroids);
+  ar & BOOST_SERIALIZATION_NVP(codebooks);
+  ar & BOOST_SERIALIZATION_NVP(listIndices);
+  ar & BOOST_SERIALIZATION_NVP(listCodes);
+  ar & BOOST_SERIALIZATION_NVP(points);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,8 @@
 #include "kde.hpp"
 #include "kde_rules.hpp"
 
+#include <mlpack/core/tree/parallel_single_tree_traversal.hpp>
+
 namespace mlpack {
 namespace kde {
 
@@ -337,31 +339,32 @@ Evaluate(MatType querySet, arma::vec& estimations)
 
     Timer::Start("computing_kde");
 
-    // Evaluate.
+    // Evaluate.  The query points are traversed in parallel, each thread with
+    // its own rules; the rules only add to the estimations of their query
+    // points.
     typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              metric,
-                              kernel,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    auto createRules = [&]()
+    {
+      return new RuleType(referenceTree->Dataset(),
+                          querySet,
+                          estimations,
+                          relError,
+                          absError,
+                          metric,
+                          kernel,
+                          false);
+    };
+
+    size_t baseCases = 0;
+    size_t scores = 0;
+    tree::ParallelSingleTreeTraversal<SingleTreeTraversalType, RuleType>(
+        *referenceTree, querySet.n_cols, createRules, baseCases, scores);
 
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
 
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
+    Log::Info << scores << " node combinations were scored." << std::endl;
+    Log::Info << baseCases << " base cases were calculated." << std::endl;
   }
 }
 
@@ -476,26 +479,36 @@ Evaluate(arma::vec& estimations)
 
   // Evaluate.
   typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            metric,
-                            kernel,
-                            true);
-
+  auto createRules = [&]()
+  {
+    return new RuleType(referenceTree->Dataset(),
+                        referenceTree->Dataset(),
+                        estimations,
+                        relError,
+                        absError,
+                        metric,
+                        kernel,
+                        true);
+  };
+
+  size_t baseCases = 0;
+  size_t scores = 0;
   if (mode == DUAL_TREE_MODE)
   {
     // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
+    RuleType* rules = createRules();
+    DualTreeTraversalType<RuleType> traverser(*rules);
     traverser.Traverse(*referenceTree, *referenceTree);
+    baseCases = rules->BaseCases();
+    scores = rules->Scores();
+    delete rules;
   }
   else if (mode == SINGLE_TREE_MODE)
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // The points are traversed in parallel, each thread with its own rules.
+    tree::ParallelSingleTreeTraversal<SingleTreeTraversalType, RuleType>(
+        *referenceTree, referenceTree->Dataset().n_cols, createRules,
+        baseCases, scores);
   }
 
   estimations /= referenceTree->Dataset().n_cols;
@@ -503,8 +516,8 @@ Evaluate(arma::vec& estimations)
   RearrangeEstimations(*oldFromNewReferences, estimations);
   Timer::Stop("computing_kde");
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/distance_block.hpp>
 
 namespace mlpack {
 namespace kde {
@@ -51,6 +52,22 @@ class KDERules
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the given query points and a range of
+   * reference points (the points of a leaf).  For the Euclidean distance, all
+   * the distances are computed with one matrix product.  A kernel value whose
+   * error, given the rounding error of the distance, could exceed the error
+   * tolerances is computed from the exact distance instead; if both
+   * tolerances are 0, BaseCase() is used for every pair.
+   *
+   * @param queryIndices Indices of the query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   //! SingleTree Rescore.
   double Score(const size_t queryIndex, TreeType& referenceNode);
 
@@ -128,6 +145,12 @@ class KDERules
 
   //! The number of scores.
   size_t scores;
+
+  //! Computes the distances of the blocked base cases.
+  metric::DistanceBlock<MetricType> distanceBlock;
+
+  //! The distances of the last blocked base case.
+  arma::mat blockDistances;
 };
 
 } // namespace kde
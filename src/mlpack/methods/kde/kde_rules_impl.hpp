@@ -40,7 +40,8 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    distanceBlock(metric, querySet, referenceSet)
 {
   // Nothing to do.
 }
@@ -72,6 +73,71 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   return distance;
 }
 
+//! The blocked base case.
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::BaseCaseBlock(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  // An exact estimate has no room for the rounding errors of the blocked
+  // distances.
+  if (absError == 0.0 && relError == 0.0)
+  {
+    for (size_t j = 0; j < queryIndices.size(); ++j)
+      for (size_t i = 0; i < referenceCount; ++i)
+        BaseCase(queryIndices[j], referenceBegin + i);
+    return;
+  }
+
+  const double error = distanceBlock.Evaluate(queryIndices, referenceBegin,
+      referenceCount, blockDistances);
+
+  for (size_t j = 0; j < queryIndices.size(); ++j)
+  {
+    const size_t queryIndex = queryIndices[j];
+    const double* blockColumn = blockDistances.colptr(j);
+    double density = 0.0;
+    for (size_t i = 0; i < referenceCount; ++i)
+    {
+      const size_t referenceIndex = referenceBegin + i;
+
+      // Don't compute the estimation of a point with itself.
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+      if (error == 0.0)
+      {
+        density += kernel.Evaluate(blockColumn[i]);
+        continue;
+      }
+
+      // The blocked distance may be off by the error bound.  The kernel value
+      // is accepted if its possible error fits in the same per-point budget
+      // as the pruning in Score(); otherwise the distance is computed exactly.
+      const double maxKernel = kernel.Evaluate(
+          std::max(blockColumn[i] - error, 0.0));
+      const double minKernel = kernel.Evaluate(blockColumn[i] + error);
+      if (maxKernel - minKernel <=
+          (absError + relError * minKernel) / referenceSet.n_cols)
+      {
+        density += (maxKernel + minKernel) / 2;
+      }
+      else
+      {
+        density += kernel.Evaluate(metric.Evaluate(querySet.col(queryIndex),
+            referenceSet.col(referenceIndex)));
+      }
+    }
+    densities(queryIndex) += density;
+  }
+
+  // The last pair of BaseCase() was not computed.
+  lastQueryIndex = querySet.n_cols;
+  lastReferenceIndex = referenceSet.n_cols;
+}
+
 //! Single-tree scoring function.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline double KDERules<MetricType, KernelType, TreeType>::
@@ -72,6 +72,31 @@ double LARS::Train(const arma::mat& matX,
                    const arma::rowvec& y,
                    arma::vec& beta,
                    const bool transposeData)
+{
+  return TrainInternal(matX, y, beta, transposeData);
+}
+
+double LARS::Train(const arma::sp_mat& matX,
+                   const arma::rowvec& y,
+                   arma::vec& beta,
+                   const bool transposeData)
+{
+  return TrainInternal(matX, y, beta, transposeData);
+}
+
+double LARS::Train(const arma::sp_mat& data,
+                   const arma::rowvec& responses,
+                   const bool transposeData)
+{
+  arma::vec beta;
+  return Train(data, responses, beta, transposeData);
+}
+
+template<typename MatType>
+double LARS::TrainInternal(const MatType& matX,
+                           const arma::rowvec& y,
+                           arma::vec& beta,
+                           const bool transposeData)
 {
   Timer::Start("lars_regression");
 
@@ -85,9 +110,9 @@ double LARS::Train(const arma::mat& matX,
   matUtriCholFactor.reset();
 
   // This matrix may end up holding the transpose -- if necessary.
-  arma::mat dataTrans;
+  MatType dataTrans;
   // dataRef is row-major.
-  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  const MatType& dataRef = (transposeData ? dataTrans : matX);
   if (transposeData)
     dataTrans = trans(matX);
 
@@ -136,8 +161,10 @@ double LARS::Train(const arma::mat& matX,
   // lambda2 * I_n to the matrix.
   if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
   {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
+    // In this case, matGram should reference matGramInternal.  For sparse
+    // data the product is sparse, but we store it densely since the active
+    // set lookups below index into it directly.
+    matGramInternal = arma::mat(trans(dataRef) * dataRef);
 
     if (elasticNet && !useCholesky)
       matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
@@ -383,6 +410,16 @@ void LARS::Predict(const arma::mat& points,
     predictions = betaPath.back().t() * points;
 }
 
+void LARS::Predict(const arma::sp_mat& points,
+                   arma::rowvec& predictions,
+                   const bool rowMajor) const
+{
+  if (rowMajor)
+    predictions = trans(points * betaPath.back());
+  else
+    predictions = betaPath.back().t() * points;
+}
+
 // Private functions.
 void LARS::Deactivate(const size_t activeVarInd)
 {
@@ -402,7 +439,8 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
+template<typename MatType>
+void LARS::ComputeYHatDirection(const MatType& matX,
                                 const arma::vec& betaDirection,
                                 arma::vec& yHatDirection)
 {
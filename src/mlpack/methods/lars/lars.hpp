@@ -208,6 +208,37 @@ class LARS
                const arma::rowvec& responses,
                const bool transposeData = true);
 
+  /**
+   * Run LARS on sparse data.  This behaves identically to the dense version of
+   * Train(), but X' y and (if it was not passed to the constructor) the Gram
+   * matrix are computed with sparse products, so the data is never densified.
+   * The Gram matrix itself is stored densely.
+   *
+   * @param data Column-major input data (or row-major input data if rowMajor =
+   *     true).
+   * @param responses A vector of targets.
+   * @param beta Vector to store the solution (the coefficients) in.
+   * @param transposeData Set to false if the data is row-major.
+   * @return The final absolute maximum correlation.
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses,
+               arma::vec& beta,
+               const bool transposeData = true);
+
+  /**
+   * Run LARS on sparse data.  See the overload above for details.
+   *
+   * @param data Input data.
+   * @param responses A vector of targets.
+   * @param transposeData Should be true if the input data is column-major and
+   *     false otherwise.
+   * @return The final absolute maximum correlation.
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses,
+               const bool transposeData = true);
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -221,6 +252,19 @@ class LARS
                arma::rowvec& predictions,
                const bool rowMajor = false) const;
 
+  /**
+   * Predict y_i for each data point in the given sparse data matrix using the
+   * currently-trained LARS model.
+   *
+   * @param points The data points to regress on.
+   * @param predictions y, which will contained calculated values on completion.
+   * @param rowMajor Should be true if the data points matrix is row-major and
+   *     false otherwise.
+   */
+  void Predict(const arma::sp_mat& points,
+               arma::rowvec& predictions,
+               const bool rowMajor = false) const;
+
   //! Access the set of active dimensions.
   const std::vector<size_t>& ActiveSet() const { return activeSet; }
 
@@ -311,8 +355,19 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
+  /**
+   * Run LARS on either dense or sparse data; this holds the actual
+   * implementation of every Train() overload.
+   */
+  template<typename MatType>
+  double TrainInternal(const MatType& data,
+                       const arma::rowvec& responses,
+                       arma::vec& beta,
+                       const bool transposeData);
+
   // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
+  template<typename MatType>
+  void ComputeYHatDirection(const MatType& matX,
                             const arma::vec& betaDirection,
                             arma::vec& yHatDirection);
 
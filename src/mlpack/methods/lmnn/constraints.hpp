@@ -15,6 +15,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
+#include "impostor_rules.hpp"
+
 namespace mlpack {
 namespace lmnn {
 /**
@@ -26,6 +28,12 @@ namespace lmnn {
  * of each data point), Impostors() (used for calculating impostors of each
  * data point) and Triplets() (Generates sets of {dataset, target neighbors,
  * impostors} tripltets.)
+ *
+ * Impostors are found with a single kd-tree built on the whole dataset, which
+ * is shared by all classes: the search rules simply ignore reference points of
+ * the same class as the query point.  Query points are searched in parallel
+ * with OpenMP.  As with the KNN search for target neighbors, the distances to
+ * impostors are Euclidean distances.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class Constraints
@@ -212,6 +220,25 @@ class Constraints
   inline void ReorderResults(const arma::mat& distances,
                              arma::Mat<size_t>& neighbors,
                              const arma::vec& norms);
+
+  /**
+   * Calculate the k differently labeled nearest neighbors of the given query
+   * points, and the distances to them.  Column i of the outputs corresponds to
+   * the query point queries[i].
+   *
+   * @param neighbors Matrix to store impostors.
+   * @param distances Matrix to store distances to impostors.
+   * @param dataset Input dataset.
+   * @param labels Input dataset labels.
+   * @param norms Norms of the input points, used to break ties.
+   * @param queries Indices of the query points.
+   */
+  void ComputeImpostors(arma::Mat<size_t>& neighbors,
+                        arma::mat& distances,
+                        const arma::mat& dataset,
+                        const arma::Row<size_t>& labels,
+                        const arma::vec& norms,
+                        const arma::uvec& queries);
 };
 
 } // namespace lmnn
@@ -168,33 +168,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
                                         const arma::Row<size_t>& labels,
                                         const arma::vec& norms)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
   arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(indexSame[i]) = neighbors;
-  }
+  ComputeImpostors(outputMatrix, distances, dataset, labels, norms,
+      arma::regspace<arma::uvec>(0, dataset.n_cols - 1));
 }
 
 // Calculates k differently labeled nearest neighbors. The function
@@ -206,34 +182,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::Row<size_t>& labels,
                                         const arma::vec& norms)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(indexSame[i]) = neighbors;
-    outputDistance.cols(indexSame[i]) = distances;
-  }
+  ComputeImpostors(outputNeighbors, outputDistance, dataset, labels, norms,
+      arma::regspace<arma::uvec>(0, dataset.n_cols - 1));
 }
 
 // Calculates k differently labeled nearest neighbors on a
@@ -246,42 +196,13 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
                                         const size_t begin,
                                         const size_t batchSize)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
+  ComputeImpostors(neighbors, distances, dataset, labels, norms,
+      arma::regspace<arma::uvec>(begin, begin + batchSize - 1));
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(begin + subIndexSame) = neighbors;
-  }
+  // Store impostors.
+  outputMatrix.cols(begin, begin + batchSize - 1) = neighbors;
 }
 
 // Calculates k differently labeled nearest neighbors & distances on a
@@ -295,43 +216,14 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const size_t begin,
                                         const size_t batchSize)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
   arma::Mat<size_t> neighbors;
   arma::mat distances;
+  ComputeImpostors(neighbors, distances, dataset, labels, norms,
+      arma::regspace<arma::uvec>(begin, begin + batchSize - 1));
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(begin + subIndexSame) = neighbors;
-    outputDistance.cols(begin + subIndexSame) = distances;
-  }
+  // Store impostors.
+  outputNeighbors.cols(begin, begin + batchSize - 1) = neighbors;
+  outputDistance.cols(begin, begin + batchSize - 1) = distances;
 }
 
 // Calculates k differently labeled nearest neighbors & distances over some
@@ -345,41 +237,97 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::uvec& points,
                                         const size_t numPoints)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
+  // Nothing to do if no point can have new impostors.
+  if (numPoints == 0)
+    return;
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
+  const arma::uvec queries = points.head(numPoints);
+  ComputeImpostors(neighbors, distances, dataset, labels, norms, queries);
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+  // Store impostors.
+  outputNeighbors.cols(queries) = neighbors;
+  outputDistance.cols(queries) = distances;
+}
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+// Calculates k differently labeled nearest neighbors of the given points, with
+// a single tree shared by all classes.
+template<typename MetricType>
+void Constraints<MetricType>::ComputeImpostors(arma::Mat<size_t>& neighbors,
+                                               arma::mat& distances,
+                                               const arma::mat& dataset,
+                                               const arma::Row<size_t>& labels,
+                                               const arma::vec& norms,
+                                               const arma::uvec& queries)
+{
+  // Perform pre-calculation. If neccesary.
+  Precalculate(labels);
+
+  for (size_t i = 0; i < uniqueLabels.n_elem; ++i)
+  {
+    if (indexDiff[i].n_elem < k)
+    {
+      Log::Fatal << "Constraints::Impostors(): class " << uniqueLabels[i]
+          << " has only " << indexDiff[i].n_elem << " differently labeled "
+          << "points, but value of k is " << k << "!" << std::endl;
+    }
+  }
+
+  // The impostor distances are Euclidean, like those of the KNN searches for
+  // target neighbors; LMNNFunction bounds them with the triangle inequality.
+  typedef tree::KDTree<metric::EuclideanDistance,
+      neighbor::NeighborSearchStat<neighbor::NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef ImpostorRules<metric::EuclideanDistance, TreeType> RuleType;
+
+  // Build one tree on the whole dataset.  The rules ignore points of the same
+  // class, so this tree can be used for the queries of every class.
+  std::vector<size_t> oldFromNew;
+  TreeType referenceTree(dataset, oldFromNew);
+  arma::Row<size_t> referenceLabels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    referenceLabels[i] = labels[oldFromNew[i]];
+
+  neighbors.set_size(k, queries.n_elem);
+  distances.set_size(k, queries.n_elem);
+
+  // Search for blocks of query points in parallel.  Each block has its own
+  // rules (and candidate lists); single-tree traversals of a kd-tree don't
+  // modify the tree, so it can be shared.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (queries.n_elem + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) queries.n_elem);
+    const arma::uvec blockQueries = queries.subvec(begin, end - 1);
+    const arma::mat querySet = dataset.cols(blockQueries);
+    const arma::Row<size_t> queryLabels = labels.cols(blockQueries);
+
+    metric::EuclideanDistance metric;
+    RuleType rules(referenceTree.Dataset(), referenceLabels, querySet,
+        queryLabels, k, metric);
+    typename TreeType::template SingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, referenceTree);
+
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    rules.GetResults(blockNeighbors, blockDistances);
 
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
+    // Re-map neighbors to their index.
+    for (size_t j = 0; j < blockNeighbors.n_elem; ++j)
+      blockNeighbors[j] = oldFromNew[blockNeighbors[j]];
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+    ReorderResults(blockDistances, blockNeighbors, norms);
 
-    // Store impostors.
-    outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
-    outputDistance.cols(points.elem(subIndexSame)) = distances;
+    neighbors.cols(begin, end - 1) = blockNeighbors;
+    distances.cols(begin, end - 1) = blockDistances;
   }
 }
 
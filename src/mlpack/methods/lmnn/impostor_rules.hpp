@@ -0,0 +1,92 @@
+/**
+ * @file impostor_rules.hpp
+ *
+ * Defines the pruning rules and base case for the impostor search of LMNN: a
+ * nearest neighbor search that ignores reference points with the same label as
+ * the query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LMNN_IMPOSTOR_RULES_HPP
+#define MLPACK_METHODS_LMNN_IMPOSTOR_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
+
+namespace mlpack {
+namespace lmnn {
+
+/**
+ * The ImpostorRules class is the nearest neighbor search rules class with a
+ * base case that only keeps reference points whose label differs from the
+ * label of the query point.  The bounds of the nearest neighbor search are
+ * still valid (they only get looser), so a single tree built on the whole
+ * dataset can be used to find the impostors of every class, instead of one
+ * tree per class built on the points of the other classes.
+ *
+ * Only trees whose Score() does not call BaseCase() (i.e. trees without the
+ * FirstPointIsCentroid trait, like the kd-tree) should be used, since the
+ * base class would otherwise call its own BaseCase().
+ *
+ * @tparam MetricType Metric to use for the search.
+ * @tparam TreeType Type of the reference tree.
+ */
+template<typename MetricType, typename TreeType>
+class ImpostorRules : public neighbor::NeighborSearchRules<
+    neighbor::NearestNeighborSort, MetricType, TreeType>
+{
+ public:
+  //! Convenience typedef.
+  typedef neighbor::NeighborSearchRules<neighbor::NearestNeighborSort,
+      MetricType, TreeType> BaseType;
+
+  /**
+   * Construct the rules for the given reference and query sets.
+   *
+   * @param referenceSet Set of reference data.
+   * @param referenceLabels Labels of the reference points.
+   * @param querySet Set of query data.
+   * @param queryLabels Labels of the query points.
+   * @param k Number of impostors to search for.
+   * @param metric Instantiated metric.
+   */
+  ImpostorRules(const typename TreeType::Mat& referenceSet,
+                const arma::Row<size_t>& referenceLabels,
+                const typename TreeType::Mat& querySet,
+                const arma::Row<size_t>& queryLabels,
+                const size_t k,
+                MetricType& metric) :
+      BaseType(referenceSet, querySet, k, metric),
+      referenceLabels(referenceLabels),
+      queryLabels(queryLabels)
+  { }
+
+  /**
+   * Get the distance from the query point to the reference point, and add the
+   * reference point to the candidate impostors of the query point if it has a
+   * different label.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    if (queryLabels[queryIndex] != referenceLabels[referenceIndex])
+      return BaseType::BaseCase(queryIndex, referenceIndex);
+
+    // A point of the same class can't be an impostor.
+    return this->metric.Evaluate(this->querySet.col(queryIndex),
+        this->referenceSet.col(referenceIndex));
+  }
+
+ private:
+  //! The labels of the reference points.
+  const arma::Row<size_t>& referenceLabels;
+  //! The labels of the query points.
+  const arma::Row<size_t>& queryLabels;
+};
+
+} // namespace lmnn
+} // namespace mlpack
+
+#endif
@@ -247,7 +247,7 @@ class LMNNFunction
                           const size_t begin,
                           const size_t batchSize);
   //! Calculate norm of change in transformation.
-  inline void TransDiff(std::map<size_t, double>& transformationDiffs,
+  inline void TransDiff(std::vector<double>& transformationDiffs,
                         const arma::mat& transformation,
                         const size_t begin,
                         const size_t batchSize);
@@ -185,24 +185,26 @@ inline void LMNNFunction<MetricType>::UpdateCache(
 // Calculate norm of change in transformation.
 template<typename MetricType>
 inline void LMNNFunction<MetricType>::TransDiff(
-                                std::map<size_t, double>& transformationDiffs,
+                                std::vector<double>& transformationDiffs,
                                 const arma::mat& transformation,
                                 const size_t begin,
                                 const size_t batchSize)
 {
+  // Negative values mark matrices that aren't used by the batch.
+  transformationDiffs.assign(oldTransformationMatrices.size(), -1.0);
   for (size_t i = begin; i < begin + batchSize; ++i)
   {
-    if (transformationDiffs.count(lastTransformationIndices[i]) == 0)
+    const size_t index = (size_t) lastTransformationIndices(i);
+    if (transformationDiffs[index] < 0.0)
     {
-      if (lastTransformationIndices[i] == 0)
+      if (index == 0)
       {
         transformationDiffs[0] = 0.0; // This won't be used anyway...
       }
       else
       {
-        transformationDiffs[lastTransformationIndices[i]] =
-            arma::norm(transformation -
-            oldTransformationMatrices[lastTransformationIndices(i)]);
+        transformationDiffs[index] = arma::norm(transformation -
+            oldTransformationMatrices[index]);
       }
     }
   }
@@ -345,7 +347,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
   double cost = 0;
 
   // Calculate norm of change in transformation.
-  std::map<size_t, double> transformationDiffs;
+  std::vector<double> transformationDiffs;
   TransDiff(transformationDiffs, transformation, begin, batchSize);
 
   // Apply metric over dataset.
@@ -360,7 +362,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
     {
       if (lastTransformationIndices(i))
       {
-        if (transformationDiffs[lastTransformationIndices[i]] *
+        if (transformationDiffs[(size_t) lastTransformationIndices(i)] *
             (2 * norm(i) + norm(impostors(k - 1, i)) +
             norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
         {
@@ -411,7 +413,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs[(size_t) lastTransformationIndices(i)] *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -608,7 +610,7 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
   transformedDataset = transformation * dataset;
 
   // Calculate norm of change in transformation.
-  std::map<size_t, double> transformationDiffs;
+  std::vector<double> transformationDiffs;
   TransDiff(transformationDiffs, transformation, begin, batchSize);
 
   if (impBounds && iteration++ % range == 0)
@@ -620,7 +622,7 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
     {
       if (lastTransformationIndices(i))
       {
-        if (transformationDiffs[lastTransformationIndices[i]] *
+        if (transformationDiffs[(size_t) lastTransformationIndices(i)] *
             (2 * norm(i) + norm(impostors(k - 1, i)) +
             norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
         {
@@ -674,7 +676,7 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs[(size_t) lastTransformationIndices(i)] *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -887,7 +889,7 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
   double cost = 0;
 
   // Calculate norm of change in transformation.
-  std::map<size_t, double> transformationDiffs;
+  std::vector<double> transformationDiffs;
   TransDiff(transformationDiffs, transformation, begin, batchSize);
 
   // Apply metric over dataset.
@@ -902,7 +904,7 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
     {
       if (lastTransformationIndices(i))
       {
-        if (transformationDiffs[lastTransformationIndices[i]] *
+        if (transformationDiffs[(size_t) lastTransformationIndices(i)] *
             (2 * norm(i) + norm(impostors(k - 1, i)) +
             norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
         {
@@ -961,7 +963,7 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs[(size_t) lastTransformationIndices(i)] *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -82,6 +82,12 @@ class NCA
   //! Get the labels reference.
   const arma::Row<size_t>& Labels() const { return labels; }
 
+  //! Get the error function (to set the number of neighbors, for instance).
+  const SoftmaxErrorFunction<MetricType>& ErrorFunction() const
+  { return errorFunction; }
+  //! Modify the error function.
+  SoftmaxErrorFunction<MetricType>& ErrorFunction() { return errorFunction; }
+
   //! Get the optimizer.
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
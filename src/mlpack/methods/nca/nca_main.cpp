@@ -88,7 +88,13 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.",
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "For large datasets, the softmax of each point can be restricted to its "
+    "nearest neighbors in the projected space with the " +
+    PRINT_PARAM_STRING("num_neighbors") + " parameter; the neighbors are "
+    "recomputed every " + PRINT_PARAM_STRING("recompute_interval") +
+    " passes over the dataset.",
     SEE_ALSO("@lmnn", "#lmnn"),
     SEE_ALSO("Neighbourhood components analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Neighbourhood_components_analysis"),
@@ -129,6 +135,13 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "If nonzero, restrict the softmax of each point "
+    "to this many nearest neighbors in the projected space, which makes NCA "
+    "scale to large datasets.", "K", 0);
+PARAM_INT_IN("recompute_interval", "Number of passes over the dataset after "
+    "which the nearest neighbors are recomputed, if --num_neighbors is "
+    "specified.", "R", 10);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -182,6 +195,19 @@ static void mlpackMain()
   const double maxStep = CLI::GetParam<double>("max_step");
   const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
 
+  RequireParamValue<int>("num_neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be non-negative");
+  RequireParamValue<int>("recompute_interval", [](int x) { return x > 0; },
+      true, "recompute interval must be positive");
+  const size_t numNeighbors = (size_t) CLI::GetParam<int>("num_neighbors");
+  const size_t recomputeInterval =
+      (size_t) CLI::GetParam<int>("recompute_interval");
+  if (numNeighbors == 0)
+  {
+    ReportIgnoredParam("recompute_interval",
+        "the softmax is not restricted to nearest neighbors");
+  }
+
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
 
@@ -235,6 +261,8 @@ static void mlpackMain()
   if (optimizerType == "sgd")
   {
     NCA<LMetric<2> > nca(data, labels);
+    nca.ErrorFunction().NumNeighbors() = numNeighbors;
+    nca.ErrorFunction().RecomputeInterval() = recomputeInterval;
     nca.Optimizer().StepSize() = stepSize;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().Tolerance() = tolerance;
@@ -246,6 +274,8 @@ static void mlpackMain()
   else if (optimizerType == "lbfgs")
   {
     NCA<LMetric<2>, ens::L_BFGS> nca(data, labels);
+    nca.ErrorFunction().NumNeighbors() = numNeighbors;
+    nca.ErrorFunction().RecomputeInterval() = recomputeInterval;
     nca.Optimizer().NumBasis() = numBasis;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().ArmijoConstant() = armijoConstant;
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -38,6 +39,18 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * By default, the sums in p_ij run over all points, which costs O(n^2) per
+ * evaluation.  If a number of neighbors K is given, the sums for each point i
+ * are restricted to the K nearest neighbors of A x_i in the projected space,
+ * which are recomputed with NeighborSearch every few projections of the
+ * dataset; this makes NCA usable on large datasets, since points far away from
+ * x_i contribute almost nothing to p_ij.
+ *
+ * All evaluations are parallelized over points with OpenMP.  When the metric
+ * is the (squared) Euclidean distance, the kernel values of the exact
+ * computation are evaluated for blocks of points at once with matrix
+ * multiplications.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -52,13 +65,22 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param kernel Instantiated kernel (optional).
+   * @param numNeighbors Number of nearest neighbors the softmax of each point
+   *     is restricted to (0 means all points are used).
+   * @param recomputeInterval Number of passes over the dataset (gradients of
+   *     the whole dataset, or of the batch starting at the first point) after
+   *     which the nearest neighbors are recomputed (only used if
+   *     numNeighbors > 0).
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t numNeighbors = 0,
+                       const size_t recomputeInterval = 10);
 
   /**
-   * Shuffle the dataset.
+   * Shuffle the dataset.  The nearest neighbors of the points, if they are
+   * used, are mapped to the new order of the points.
    */
   void Shuffle();
 
@@ -129,6 +151,16 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors the softmax is restricted to (0 for all).
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of neighbors the softmax is restricted to (0 for all).
+  size_t& NumNeighbors() { return numNeighbors; }
+
+  //! Get the number of projections after which neighbors are recomputed.
+  size_t RecomputeInterval() const { return recomputeInterval; }
+  //! Modify the number of projections after which neighbors are recomputed.
+  size_t& RecomputeInterval() { return recomputeInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -148,6 +180,18 @@ class SoftmaxErrorFunction
   //! Holds denominators for calculation of p_ij, for the non-separable
   //! Evaluate() and Gradient().
   arma::vec denominators;
+  //! Squared norms of the points of the stretched dataset.
+  arma::vec squaredNorms;
+
+  //! Number of neighbors the softmax is restricted to (0 for all points).
+  size_t numNeighbors;
+  //! Number of passes over the dataset after which neighbors are recomputed.
+  size_t recomputeInterval;
+  //! Number of passes over the dataset since the neighbors were last computed.
+  size_t passesSinceSearch;
+  //! Nearest neighbors of each point in the projected space, if numNeighbors
+  //! is not 0.
+  arma::Mat<size_t> neighbors;
 
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
@@ -156,16 +200,60 @@ class SoftmaxErrorFunction
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
    * the Precalculate() method was run with.  This method is only called by the
-   * non-separable Evaluate() and Gradient().
+   * non-separable Evaluate().
    *
    * This will update last_coordinates_ and stretched_dataset_, and also
    * calculate the p_i and denominators_ which are used in the calculation of
-   * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * p_i or p_ij.  The calculation will be O(n^2), or O(n K) if the softmax is
+   * restricted to K neighbors.
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Compute the stretched dataset for the given coordinates, and recompute the
+   * nearest neighbors of the points if needed.
+   *
+   * @param coordinates Coordinates matrix to project the dataset with.
+   * @param newPass Whether this projection starts a new pass over the
+   *     dataset.
+   */
+  void Project(const arma::mat& coordinates, const bool newPass);
+
+  /**
+   * Recompute the nearest neighbors of each point of the stretched dataset.
+   */
+  void UpdateNeighbors();
+
+  /**
+   * Compute exp(-D(A x_i, A x_k)) for the points i in [begin, end) and every
+   * candidate k (all points, or the nearest neighbors of i), storing the
+   * values for point i in column (i - begin) of evals.  The value for k = i is
+   * 0.  Project() must have been called.
+   */
+  void KernelBlock(const size_t begin, const size_t end, arma::mat& evals);
+
+  /**
+   * Compute p_i and the denominators of p_ij for the given range of points,
+   * in parallel.  If sum is not NULL, it is set to
+   *
+   *   sum_i sum_k (p_i p_ik - [class of i is class of k] p_ik) x_ik x_ik^T
+   *
+   * over the range, from which the gradient is computed.  Project() must have
+   * been called.
+   *
+   * @param begin Index of the first point.
+   * @param count Number of points.
+   * @param pOut Will hold p_i for the points.
+   * @param denominatorsOut Will hold the denominators for the points.
+   * @param sum If not NULL, will hold the sum for the gradient.
+   */
+  void ComputeTerms(const size_t begin,
+                    const size_t count,
+                    arma::vec& pOut,
+                    arma::vec& denominatorsOut,
+                    arma::mat* sum);
 };
 
 } // namespace nca
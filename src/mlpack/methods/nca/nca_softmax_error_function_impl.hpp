@@ -23,10 +23,15 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t numNeighbors,
+    const size_t recomputeInterval) :
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
+    numNeighbors(numNeighbors),
+    recomputeInterval(recomputeInterval),
+    passesSinceSearch(0),
     precalculated(false)
 { /* nothing to do */ }
 
@@ -34,16 +39,33 @@ SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
 template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Shuffle()
 {
-  arma::mat newDataset;
-  arma::Row<size_t> newLabels;
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      dataset.n_cols - 1, dataset.n_cols));
 
-  math::ShuffleData(dataset, labels, newDataset, newLabels);
+  arma::mat newDataset = dataset.cols(ordering);
+  arma::Row<size_t> newLabels = labels.cols(ordering);
 
   math::ClearAlias(dataset);
   math::ClearAlias(labels);
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // Map the neighbors to the new indices of the points, so that they don't
+  // have to be recomputed.
+  if (neighbors.n_cols == dataset.n_cols)
+  {
+    arma::uvec newIndices(ordering.n_elem);
+    newIndices.elem(ordering) = arma::linspace<arma::uvec>(0,
+        ordering.n_elem - 1, ordering.n_elem);
+
+    arma::Mat<size_t> newNeighbors(neighbors.n_rows, neighbors.n_cols);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+        newNeighbors(j, i) = newIndices[neighbors(j, ordering[i])];
+    neighbors = std::move(newNeighbors);
+  }
+  precalculated = false;
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -64,91 +86,47 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
-  // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
-  double result = 0;
-
   // It's quicker to do this now than one point at a time later.
-  stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; i++)
-  {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (k == i)
-        continue;
+  Project(coordinates, false);
 
-      // We want to evaluate exp(-D(A x_i, A x_k)).
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                              stretchedDataset.unsafe_col(k)));
+  // Our objective is to compute p_i for each point in the batch.
+  arma::vec batchP, batchDenominators;
+  ComputeTerms(begin, batchSize, batchP, batchDenominators, NULL);
 
-      // If they are in the same class, update the numerator.
-      if (labels[i] == labels[k])
-        numerator += eval;
-
-      denominator += eval;
-    }
-
-    // Now the result is just a simple division, but we have to be sure that the
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    // The result is just a simple division, but we have to be sure that the
     // denominator is not 0.
-    if (denominator == 0.0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      continue;
-    }
-
-    result += -(numerator / denominator); // Negate because the optimizer is a
-                                          // minimizer.
+    if (batchDenominators[i] == 0.0)
+      Log::Warn << "Denominator of p_" << (begin + i) << " is 0!" << std::endl;
   }
-  return result;
+
+  return -accu(batchP); // Negate because the optimizer is a minimizer.
 }
 
-//! The non-separable implementation, where Precalculate() is used.
+//! The non-separable implementation.
 template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 arma::mat& gradient)
 {
-  // Calculate the denominators and numerators, if necessary.
-  Precalculate(coordinates);
-
   // Now, we handle the summation over i:
   //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
   //       sum_{j in class of i} (p_ij x_ij x_ij^T)
-  // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
-  //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  // which is computed by ComputeTerms(), together with p_i and the
+  // denominators, so we can update the precalculated values too.
+  Project(coordinates, true);
+
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  ComputeTerms(0, dataset.n_cols, p, denominators, &sum);
+  for (size_t i = 0; i < dataset.n_cols; i++)
   {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
-    {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
-    }
+    if (denominators[i] == 0.0)
+      denominators[i] = std::numeric_limits<double>::infinity();
   }
 
+  lastCoordinates = coordinates;
+  precalculated = true;
+
   // Assemble the final gradient.
   gradient = -2 * coordinates * sum;
 }
@@ -161,72 +139,25 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
-  // The gradient involves two matrix terms which are eventually combined into
-  // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
-
-  gradient.zeros(coordinates.n_rows, coordinates.n_rows);
+  // Compute the stretched dataset; a gradient from the first point starts a
+  // new pass over the dataset.
+  Project(coordinates, begin == 0);
+
+  // The gradient is -2 A sum_i (p_i sum_k p_ik x_ik x_ik^T -
+  //     sum_{j in class of i} p_ij x_ij x_ij^T); points whose denominator is
+  // zero have all p_ik zero, so they don't contribute.
+  arma::vec batchP, batchDenominators;
+  arma::mat sum;
+  ComputeTerms(begin, batchSize, batchP, batchDenominators, &sum);
 
-  // Compute the stretched dataset.
-  stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; i++)
+  for (size_t i = 0; i < batchSize; ++i)
   {
-    numerator = 0;
-    denominator = 0;
-
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
-
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
-      {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
-      }
-
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
-    }
-
-    // Calculate p_i.
-    double p = 0;
-    if (denominator == 0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      // If the denominator is zero, then all p_ik should be zero and there is
-      // no gradient contribution from this point.
-      continue;
-    }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
-    }
-
-    // Now multiply the first term by p_i, and add the two together and multiply
-    // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
-    gradient += -2 * coordinates * (p * firstTerm - secondTerm);
+    if (batchDenominators[i] == 0.0)
+      Log::Warn << "Denominator of p_" << (begin + i) << " is 0!" << std::endl;
   }
+
+  // We negate it, because our optimizer is a minimizer.
+  gradient = -2 * coordinates * sum;
 }
 
 template<typename MetricType>
@@ -253,55 +184,247 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
 
   // Coordinates are different; save the new ones, and stretch the dataset.
   lastCoordinates = coordinates;
-  stretchedDataset = coordinates * dataset;
+  Project(coordinates, false);
 
   // For each point i, we must evaluate the softmax function:
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
-  // We will do this by keeping track of the denominators for each i as well as
-  // the numerators (the sum for all j in class of i).  This will be on the
-  // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
+  // where the sums run over all points, or over the neighbors of i.
+  ComputeTerms(0, dataset.n_cols, p, denominators, NULL);
+
+  // Clean up any bad values.
   for (size_t i = 0; i < stretchedDataset.n_cols; i++)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
+    if (denominators[i] == 0.0)
     {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
+      Log::Debug << "Denominator of p_{" << i << ", j} is 0." << std::endl;
+
+      // Set to usable values.
+      denominators[i] = std::numeric_limits<double>::infinity();
+      p[i] = 0;
+    }
+  }
+
+  // We've done a precalculation.  Mark it as done.
+  precalculated = true;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::Project(const arma::mat& coordinates,
+                                               const bool newPass)
+{
+  stretchedDataset = coordinates * dataset;
+  squaredNorms = arma::trans(arma::sum(arma::square(stretchedDataset), 0));
+
+  // The neighbors don't change much between two passes over the dataset, so
+  // they are only recomputed every recomputeInterval passes.
+  if (newPass)
+    ++passesSinceSearch;
+
+  if (numNeighbors > 0 && (neighbors.n_rows != numNeighbors ||
+      neighbors.n_cols != dataset.n_cols ||
+      passesSinceSearch >= recomputeInterval))
+  {
+    UpdateNeighbors();
+  }
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighbors()
+{
+  if (numNeighbors >= dataset.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxErrorFunction: number of neighbors (" << numNeighbors
+        << ") must be less than the number of points (" << dataset.n_cols
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType> knn(
+      stretchedDataset, neighbor::DUAL_TREE_MODE, 0.0, metric);
+  arma::mat distances;
+  knn.Search(numNeighbors, neighbors, distances);
 
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
+  passesSinceSearch = 0;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::KernelBlock(const size_t begin,
+                                                   const size_t end,
+                                                   arma::mat& evals)
+{
+  const bool squared =
+      std::is_same<MetricType, metric::SquaredEuclideanDistance>::value;
+  const bool euclidean =
+      std::is_same<MetricType, metric::EuclideanDistance>::value;
 
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+  if (numNeighbors > 0)
+  {
+    evals.set_size(numNeighbors, end - begin);
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t j = 0; j < numNeighbors; ++j)
+      {
+        evals(j, i - begin) = std::exp(-metric.Evaluate(
+            stretchedDataset.unsafe_col(i),
+            stretchedDataset.unsafe_col(neighbors(j, i))));
+      }
+    }
+  }
+  else if (squared || euclidean)
+  {
+    // Use ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a^T b, so that all the distances
+    // of the block come from one matrix multiplication.
+    evals = -2.0 * (stretchedDataset.t() * stretchedDataset.cols(begin,
+        end - 1));
+    evals.each_col() += squaredNorms;
+    evals.each_row() += squaredNorms.subvec(begin, end - 1).t();
+
+    // Rounding can give slightly negative distances.
+    evals = arma::clamp(evals, 0.0, arma::datum::inf);
+    if (euclidean)
+      evals = arma::sqrt(evals);
+    evals = arma::exp(-evals);
+
+    // Don't consider the case where the points are the same.
+    for (size_t i = begin; i < end; ++i)
+      evals(i, i - begin) = 0.0;
+  }
+  else
+  {
+    evals.set_size(stretchedDataset.n_cols, end - begin);
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t k = 0; k < stretchedDataset.n_cols; ++k)
       {
-        p[i] += eval;
-        p[j] += eval;
+        // Don't consider the case where the points are the same.
+        evals(k, i - begin) = (k == i) ? 0.0 :
+            std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                      stretchedDataset.unsafe_col(k)));
       }
     }
   }
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::ComputeTerms(const size_t begin,
+                                                    const size_t count,
+                                                    arma::vec& pOut,
+                                                    arma::vec& denominatorsOut,
+                                                    arma::mat* sum)
+{
+  pOut.zeros(count);
+  denominatorsOut.zeros(count);
+
+  // When all points are used, the sum over k of w_ik x_k x_k^T is accumulated
+  // as a weight per point k and computed once at the end.
+  arma::vec pointWeights;
+  if (sum)
+  {
+    sum->zeros(dataset.n_rows, dataset.n_rows);
+    if (numNeighbors == 0)
+      pointWeights.zeros(dataset.n_cols);
+  }
 
-  // Divide p_i by their denominators.
-  p /= denominators;
+  const size_t blockSize = 64;
+  const size_t numBlocks = (count + blockSize - 1) / blockSize;
 
-  // Clean up any bad values.
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  #pragma omp parallel
   {
-    if (denominators[i] == 0.0)
+    arma::mat localSum;
+    arma::vec localPointWeights;
+    if (sum)
     {
-      Log::Debug << "Denominator of p_{" << i << ", j} is 0." << std::endl;
+      localSum.zeros(dataset.n_rows, dataset.n_rows);
+      localPointWeights.zeros(pointWeights.n_elem);
+    }
+    arma::mat evals;
 
-      // Set to usable values.
-      denominators[i] = std::numeric_limits<double>::infinity();
-      p[i] = 0;
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t blockBegin = begin + b * blockSize;
+      const size_t blockEnd = std::min(blockBegin + blockSize, begin + count);
+      KernelBlock(blockBegin, blockEnd, evals);
+
+      for (size_t i = blockBegin; i < blockEnd; ++i)
+      {
+        const size_t col = i - blockBegin;
+        double numerator = 0.0;
+        double denominator = 0.0;
+        for (size_t j = 0; j < evals.n_rows; ++j)
+        {
+          const size_t k = (numNeighbors == 0) ? j : neighbors(j, i);
+          if (labels[i] == labels[k])
+            numerator += evals(j, col);
+          denominator += evals(j, col);
+        }
+
+        denominatorsOut[i - begin] = denominator;
+        if (denominator == 0.0)
+          continue; // All p_ik are zero.
+
+        const double pi = numerator / denominator;
+        pOut[i - begin] = pi;
+
+        // Turn the kernel values into the weights of x_ik x_ik^T.
+        if (sum)
+        {
+          for (size_t j = 0; j < evals.n_rows; ++j)
+          {
+            const size_t k = (numNeighbors == 0) ? j : neighbors(j, i);
+            const double pik = evals(j, col) / denominator;
+            evals(j, col) = (labels[i] == labels[k]) ? (pi - 1) * pik :
+                pi * pik;
+          }
+        }
+      }
+
+      if (!sum)
+        continue;
+
+      if (numNeighbors == 0)
+      {
+        // With W the weights of the block (one column per point i), the sum
+        // of w_ik (x_i - x_k)(x_i - x_k)^T is
+        //   X_B diag(colsum(W)) X_B^T + X diag(rowsum(W)) X^T - C - C^T
+        // with C = X W X_B^T.
+        const arma::mat block = dataset.cols(blockBegin, blockEnd - 1);
+        const arma::mat cross = (dataset * evals) * block.t();
+        const arma::rowvec blockWeights = arma::sum(evals, 0);
+        localSum += (block.each_row() % blockWeights) * block.t() - cross -
+            cross.t();
+        localPointWeights += arma::sum(evals, 1);
+      }
+      else
+      {
+        arma::mat diffs(dataset.n_rows, numNeighbors);
+        for (size_t i = blockBegin; i < blockEnd; ++i)
+        {
+          // Subtract x_i from x_k.  We are not using stretched points here.
+          for (size_t j = 0; j < numNeighbors; ++j)
+            diffs.col(j) = dataset.col(i) - dataset.col(neighbors(j, i));
+
+          localSum += (diffs.each_row() % evals.col(i - blockBegin).t()) *
+              diffs.t();
+        }
+      }
+    }
+
+    if (sum)
+    {
+      #pragma omp critical(SoftmaxErrorFunctionSum)
+      {
+        *sum += localSum;
+        if (numNeighbors == 0)
+          pointWeights += localPointWeights;
+      }
     }
   }
 
-  // We've done a precalculation.  Mark it as done.
-  precalculated = true;
+  if (sum && numNeighbors == 0)
+    *sum += (dataset.each_row() % pointWeights.t()) * dataset.t();
 }
 
 } // namespace nca
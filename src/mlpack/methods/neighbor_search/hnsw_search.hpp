@@ -0,0 +1,333 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world (HNSW) graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <queue>
+
+#include "neighbor_search.hpp"
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class performs approximate neighbor search with a hierarchical
+ * navigable small world graph.  Each reference point is a node of the graph,
+ * linked to (at most) a fixed number of its neighbors; the nodes are also
+ * assigned to a random number of levels, with exponentially fewer nodes on
+ * each level, so that the upper levels act as an express route to the region
+ * of the query.  A search greedily descends the upper levels, then explores
+ * the bottom level with a best-first search that keeps the efSearch best
+ * points seen so far; a larger efSearch gives a higher recall at a higher
+ * cost.
+ *
+ * Unlike the trees of NeighborSearch, the graph gives no guarantee on the
+ * results, but in high dimension it is usually much faster for the same
+ * recall.  The graph is built in parallel with OpenMP: the points are inserted
+ * in batches that are searched for concurrently in the graph built so far,
+ * and then linked into it.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Create the HNSWSearch object without a reference set; Train() must be
+   * called before searching.
+   *
+   * @param degree Number of neighbors each point is linked to on each level
+   *     (points may have up to twice as many on the bottom level).
+   * @param efConstruction Number of candidates considered when inserting a
+   *     point.
+   * @param efSearch Number of candidates considered when searching.
+   * @param mode Search mode; NAIVE_MODE performs brute-force search, any other
+   *     mode searches the graph.
+   * @param epsilon Relative approximation error allowed when exploring the
+   *     graph; candidates that can't improve the results by more than this
+   *     are not explored.
+   * @param metric An optional instance of the MetricType class.
+   */
+  HNSWSearch(const size_t degree = 16,
+             const size_t efConstruction = 100,
+             const size_t efSearch = 50,
+             const NeighborSearchMode mode = SINGLE_TREE_MODE,
+             const double epsilon = 0,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create the HNSWSearch object and build the graph on the given reference
+   * set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param degree Number of neighbors each point is linked to on each level.
+   * @param efConstruction Number of candidates considered when inserting a
+   *     point.
+   * @param efSearch Number of candidates considered when searching.
+   * @param mode Search mode.
+   * @param epsilon Relative approximation error allowed when exploring the
+   *     graph.
+   * @param metric An optional instance of the MetricType class.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t degree = 16,
+             const size_t efConstruction = 100,
+             const size_t efSearch = 50,
+             const NeighborSearchMode mode = SINGLE_TREE_MODE,
+             const double epsilon = 0,
+             const MetricType metric = MetricType());
+
+  /**
+   * Set the reference set to the given matrix, and build the graph on it
+   * (unless naive search is used, in which case the graph is built on the
+   * first graph search).
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Search for the k approximate neighbors of each query point.  If fewer than
+   * k neighbors are found for a query point, the remaining neighbors are set
+   * to SIZE_MAX and their distances to SortPolicy::WorstDistance().
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing the neighbors of each query point.
+   * @param distances Matrix storing the distances to the neighbors.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Search for the k approximate neighbors of each reference point, not
+   * counting the point itself.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing the neighbors of each reference point.
+   * @param distances Matrix storing the distances to the neighbors.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the number of neighbors of each point on each level.
+  size_t Degree() const { return degree; }
+  //! Modify the number of neighbors of each point on each level (this only
+  //! takes effect when the graph is next built).
+  size_t& Degree() { return degree; }
+
+  //! Get the number of candidates considered when inserting a point.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the number of candidates considered when inserting a point (this
+  //! only takes effect when the graph is next built).
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the number of candidates considered when searching.
+  size_t EfSearch() const { return efSearch; }
+  //! Modify the number of candidates considered when searching.
+  size_t& EfSearch() { return efSearch; }
+
+  //! Access the search mode.
+  NeighborSearchMode SearchMode() const { return searchMode; }
+  //! Modify the search mode.
+  NeighborSearchMode& SearchMode() { return searchMode; }
+
+  //! Access the relative error allowed when exploring the graph.
+  double Epsilon() const { return epsilon; }
+  //! Modify the relative error allowed when exploring the graph.
+  double& Epsilon() { return epsilon; }
+
+  //! Access the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of levels of the graph.
+  size_t NumLevels() const { return levels.is_empty() ? 0 : maxLevel + 1; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A point and its distance to the query point.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Order candidates so that the best one is on top of a priority queue.
+  struct BestOnTop
+  {
+    bool operator()(const Candidate& a, const Candidate& b) const
+    { return SortPolicy::IsBetter(b.first, a.first); }
+  };
+
+  //! Order candidates so that the worst one is on top of a priority queue.
+  struct WorstOnTop
+  {
+    bool operator()(const Candidate& a, const Candidate& b) const
+    { return SortPolicy::IsBetter(a.first, b.first); }
+  };
+
+  /**
+   * The set of visited points of a search.  Marking points with the number of
+   * the search avoids clearing the whole set before each search.
+   */
+  class VisitedSet
+  {
+   public:
+    VisitedSet() : tag(0) { }
+
+    //! Start a new search over the given number of points.
+    void Reset(const size_t numPoints)
+    {
+      if (marks.size() != numPoints || tag == SIZE_MAX)
+      {
+        marks.assign(numPoints, 0);
+        tag = 0;
+      }
+      ++tag;
+    }
+
+    //! Mark the given point as visited; return false if it already was.
+    bool Visit(const size_t point)
+    {
+      if (marks[point] == tag)
+        return false;
+      marks[point] = tag;
+      return true;
+    }
+
+   private:
+    //! The number of the search that last visited each point.
+    std::vector<size_t> marks;
+    //! The number of the current search.
+    size_t tag;
+  };
+
+  //! Build the graph on the reference set.
+  void BuildGraph();
+
+  //! Get the maximum number of links of a point on the given level.
+  size_t MaxLinks(const size_t level) const
+  { return (level == 0) ? 2 * degree : degree; }
+
+  //! Get the links of the given point on the given level; unused links are
+  //! SIZE_MAX.
+  size_t* Links(const size_t point, const size_t level)
+  {
+    return (level == 0) ? baseLinks.colptr(point) :
+        upperLinks.colptr(upperOffsets[point] + level - 1);
+  }
+
+  /**
+   * Walk greedily from the given point towards the query point on the given
+   * level, and return the best point found.
+   */
+  template<typename VecType>
+  size_t GreedyBest(const VecType& point,
+                    size_t entry,
+                    const size_t level,
+                    double& distance);
+
+  /**
+   * Best-first search of the given level from the given entry points, keeping
+   * the ef best points found; they are stored in results, best first.
+   */
+  template<typename VecType>
+  void SearchLevel(const VecType& point,
+                   const std::vector<Candidate>& entries,
+                   const size_t ef,
+                   const size_t level,
+                   VisitedSet& visited,
+                   std::vector<Candidate>& results);
+
+  /**
+   * Select at most maxLinks neighbors among the given candidates (sorted best
+   * first), preferring candidates that are closer to the point than to the
+   * neighbors already selected, so that the links point in diverse directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxLinks,
+                       std::vector<size_t>& selected);
+
+  /**
+   * Search for the k neighbors of the given point, skipping the reference
+   * point with index skip (SIZE_MAX to skip none).
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& point,
+                   const size_t k,
+                   const size_t skip,
+                   VisitedSet& visited,
+                   std::vector<Candidate>& results,
+                   size_t* neighbors,
+                   double* distances);
+
+  //! The reference set.
+  MatType referenceSet;
+  //! Number of neighbors of each point on each level.
+  size_t degree;
+  //! Number of candidates considered when inserting a point.
+  size_t efConstruction;
+  //! Number of candidates considered when searching.
+  size_t efSearch;
+  //! Search mode.
+  NeighborSearchMode searchMode;
+  //! Relative error allowed when exploring the graph.
+  double epsilon;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! Highest level of each point.
+  arma::Col<size_t> levels;
+  //! Column of the level 1 links of each point in upperLinks.
+  arma::Col<size_t> upperOffsets;
+  //! Links of each point on the bottom level.
+  arma::Mat<size_t> baseLinks;
+  //! Links of the points on the upper levels.
+  arma::Mat<size_t> upperLinks;
+  //! The point where searches start (a point of the highest level).
+  size_t entryPoint;
+  //! The highest level of the graph.
+  size_t maxLevel;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
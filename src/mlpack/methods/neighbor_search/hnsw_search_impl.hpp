@@ -0,0 +1,517 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+HNSWSearch<SortPolicy, MetricType, MatType>::HNSWSearch(
+    const size_t degree,
+    const size_t efConstruction,
+    const size_t efSearch,
+    const NeighborSearchMode mode,
+    const double epsilon,
+    const MetricType metric) :
+    degree(degree),
+    efConstruction(efConstruction),
+    efSearch(efSearch),
+    searchMode(mode),
+    epsilon(epsilon),
+    metric(metric),
+    entryPoint(0),
+    maxLevel(0)
+{
+  if (degree < 2)
+    throw std::invalid_argument("HNSWSearch::HNSWSearch(): degree must be at "
+        "least 2!");
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+HNSWSearch<SortPolicy, MetricType, MatType>::HNSWSearch(
+    MatType referenceSet,
+    const size_t degree,
+    const size_t efConstruction,
+    const size_t efSearch,
+    const NeighborSearchMode mode,
+    const double epsilon,
+    const MetricType metric) :
+    HNSWSearch(degree, efConstruction, efSearch, mode, epsilon, metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::Train(MatType referenceSet)
+{
+  this->referenceSet = std::move(referenceSet);
+
+  levels.reset();
+  upperOffsets.reset();
+  baseLinks.reset();
+  upperLinks.reset();
+  entryPoint = 0;
+  maxLevel = 0;
+
+  if (searchMode != NAIVE_MODE)
+    BuildGraph();
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::BuildGraph()
+{
+  if (degree < 2)
+    throw std::invalid_argument("HNSWSearch::BuildGraph(): degree must be at "
+        "least 2!");
+
+  const size_t numPoints = referenceSet.n_cols;
+  if (numPoints == 0)
+    return;
+
+  Timer::Start("hnsw_graph_building");
+
+  // Draw the level of each point; the number of points on each level decreases
+  // geometrically with ratio 1 / degree.
+  const double levelScale = 1.0 / std::log((double) degree);
+  levels.set_size(numPoints);
+  upperOffsets.set_size(numPoints);
+  size_t numUpperLinks = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    levels[i] = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelScale);
+    upperOffsets[i] = numUpperLinks;
+    numUpperLinks += levels[i];
+  }
+
+  baseLinks.set_size(2 * degree, numPoints);
+  baseLinks.fill(SIZE_MAX);
+  upperLinks.set_size(degree, numUpperLinks);
+  upperLinks.fill(SIZE_MAX);
+
+  entryPoint = 0;
+  maxLevel = levels[0];
+
+  // The points are inserted in batches.  The points of a batch are searched
+  // for in parallel in the graph built so far, which they are not part of yet,
+  // so each one only writes its own links.  Then the reverse links are added,
+  // in parallel over the points they are added to.  A batch is never larger
+  // than the graph it is inserted into (nor than 2% of the points), so that the
+  // graph stays close to the one sequential insertion would build.
+  const size_t maxBatchSize = std::max(size_t(1), numPoints / 50);
+  size_t numInserted = 1;
+  while (numInserted < numPoints)
+  {
+    const size_t batchBegin = numInserted;
+    const size_t batchEnd = std::min(numPoints,
+        batchBegin + std::min(numInserted, maxBatchSize));
+    const size_t graphMaxLevel = maxLevel;
+    const size_t graphEntryPoint = entryPoint;
+
+    #pragma omp parallel
+    {
+      VisitedSet visited;
+      std::vector<Candidate> entries, results;
+      std::vector<size_t> selected;
+
+      #pragma omp for schedule(dynamic, 4)
+      for (omp_size_t p = (omp_size_t) batchBegin; p < (omp_size_t) batchEnd;
+          ++p)
+      {
+        const size_t point = (size_t) p;
+        size_t entry = graphEntryPoint;
+        double distance = metric.Evaluate(referenceSet.col(point),
+            referenceSet.col(entry));
+        for (size_t l = graphMaxLevel; l > levels[point]; --l)
+          entry = GreedyBest(referenceSet.col(point), entry, l, distance);
+
+        entries.assign(1, Candidate(distance, entry));
+        for (size_t l = std::min(levels[point], graphMaxLevel) + 1; l-- > 0; )
+        {
+          SearchLevel(referenceSet.col(point), entries, efConstruction, l,
+              visited, results);
+          SelectNeighbors(results, degree, selected);
+          size_t* links = Links(point, l);
+          for (size_t j = 0; j < selected.size(); ++j)
+            links[j] = selected[j];
+
+          entries.swap(results);
+        }
+      }
+    }
+
+    // Collect the reverse links (point, level, new neighbor), grouped by point
+    // and level.
+    std::vector<std::pair<std::pair<size_t, size_t>, size_t>> reverseLinks;
+    for (size_t p = batchBegin; p < batchEnd; ++p)
+    {
+      for (size_t l = 0; l <= std::min(levels[p], graphMaxLevel); ++l)
+      {
+        const size_t* links = Links(p, l);
+        for (size_t j = 0; j < MaxLinks(l) && links[j] != SIZE_MAX; ++j)
+        {
+          reverseLinks.push_back(std::make_pair(std::make_pair(links[j], l),
+              p));
+        }
+      }
+    }
+    std::sort(reverseLinks.begin(), reverseLinks.end());
+
+    std::vector<size_t> groupBegins;
+    for (size_t i = 0; i < reverseLinks.size(); ++i)
+    {
+      if (i == 0 || reverseLinks[i].first != reverseLinks[i - 1].first)
+        groupBegins.push_back(i);
+    }
+    groupBegins.push_back(reverseLinks.size());
+
+    #pragma omp parallel
+    {
+      std::vector<Candidate> candidates;
+      std::vector<size_t> selected;
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t g = 0; g < (omp_size_t) groupBegins.size() - 1; ++g)
+      {
+        const size_t point = reverseLinks[groupBegins[g]].first.first;
+        const size_t level = reverseLinks[groupBegins[g]].first.second;
+        const size_t maxLinks = MaxLinks(level);
+        size_t* links = Links(point, level);
+
+        size_t numLinks = 0;
+        while (numLinks < maxLinks && links[numLinks] != SIZE_MAX)
+          ++numLinks;
+
+        // If there is room, just append the new links; otherwise select the
+        // best of the old and new ones.
+        const size_t numNew = groupBegins[g + 1] - groupBegins[g];
+        if (numLinks + numNew <= maxLinks)
+        {
+          for (size_t i = groupBegins[g]; i < groupBegins[g + 1]; ++i)
+            links[numLinks++] = reverseLinks[i].second;
+          continue;
+        }
+
+        candidates.clear();
+        for (size_t j = 0; j < numLinks; ++j)
+        {
+          candidates.push_back(Candidate(metric.Evaluate(
+              referenceSet.col(point), referenceSet.col(links[j])), links[j]));
+        }
+        for (size_t i = groupBegins[g]; i < groupBegins[g + 1]; ++i)
+        {
+          const size_t neighbor = reverseLinks[i].second;
+          candidates.push_back(Candidate(metric.Evaluate(
+              referenceSet.col(point), referenceSet.col(neighbor)), neighbor));
+        }
+        std::sort(candidates.begin(), candidates.end(), WorstOnTop());
+
+        SelectNeighbors(candidates, maxLinks, selected);
+        for (size_t j = 0; j < maxLinks; ++j)
+          links[j] = (j < selected.size()) ? selected[j] : SIZE_MAX;
+      }
+    }
+
+    for (size_t p = batchBegin; p < batchEnd; ++p)
+    {
+      if (levels[p] > maxLevel)
+      {
+        maxLevel = levels[p];
+        entryPoint = p;
+      }
+    }
+
+    numInserted = batchEnd;
+  }
+
+  Timer::Stop("hnsw_graph_building");
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename VecType>
+size_t HNSWSearch<SortPolicy, MetricType, MatType>::GreedyBest(
+    const VecType& point,
+    size_t entry,
+    const size_t level,
+    double& distance)
+{
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    const size_t* links = Links(entry, level);
+    for (size_t j = 0; j < MaxLinks(level) && links[j] != SIZE_MAX; ++j)
+    {
+      const double d = metric.Evaluate(point, referenceSet.col(links[j]));
+      if (SortPolicy::IsBetter(d, distance))
+      {
+        distance = d;
+        entry = links[j];
+        changed = true;
+      }
+    }
+  }
+
+  return entry;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::SearchLevel(
+    const VecType& point,
+    const std::vector<Candidate>& entries,
+    const size_t ef,
+    const size_t level,
+    VisitedSet& visited,
+    std::vector<Candidate>& results)
+{
+  visited.Reset(referenceSet.n_cols);
+
+  std::priority_queue<Candidate, std::vector<Candidate>, BestOnTop> candidates;
+  std::priority_queue<Candidate, std::vector<Candidate>, WorstOnTop> found;
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    visited.Visit(entries[i].second);
+    candidates.push(entries[i]);
+    found.push(entries[i]);
+    if (found.size() > ef)
+      found.pop();
+  }
+
+  while (!candidates.empty())
+  {
+    // Stop when the best candidate left can't improve the results (by more
+    // than the allowed relative error).
+    const Candidate candidate = candidates.top();
+    if (found.size() >= ef && SortPolicy::IsBetter(
+        SortPolicy::Relax(found.top().first, epsilon), candidate.first))
+      break;
+    candidates.pop();
+
+    const size_t* links = Links(candidate.second, level);
+    for (size_t j = 0; j < MaxLinks(level) && links[j] != SIZE_MAX; ++j)
+    {
+      if (!visited.Visit(links[j]))
+        continue;
+
+      const double d = metric.Evaluate(point, referenceSet.col(links[j]));
+      if (found.size() < ef || SortPolicy::IsBetter(d, found.top().first))
+      {
+        candidates.push(Candidate(d, links[j]));
+        found.push(Candidate(d, links[j]));
+        if (found.size() > ef)
+          found.pop();
+      }
+    }
+  }
+
+  results.resize(found.size());
+  for (size_t i = found.size(); i > 0; --i)
+  {
+    results[i - 1] = found.top();
+    found.pop();
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxLinks,
+    std::vector<size_t>& selected)
+{
+  selected.clear();
+  std::vector<size_t> skipped;
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxLinks; ++i)
+  {
+    bool diverse = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      const double d = metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j]));
+      if (!SortPolicy::IsBetter(candidates[i].first, d))
+      {
+        diverse = false;
+        break;
+      }
+    }
+
+    if (diverse)
+      selected.push_back(candidates[i].second);
+    else
+      skipped.push_back(candidates[i].second);
+  }
+
+  // Fill the remaining links with the best skipped candidates.
+  for (size_t i = 0; i < skipped.size() && selected.size() < maxLinks; ++i)
+    selected.push_back(skipped[i]);
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::SearchPoint(
+    const VecType& point,
+    const size_t k,
+    const size_t skip,
+    VisitedSet& visited,
+    std::vector<Candidate>& results,
+    size_t* neighbors,
+    double* distances)
+{
+  const size_t numResults = (skip == SIZE_MAX) ? k : k + 1;
+  if (searchMode == NAIVE_MODE)
+  {
+    results.resize(referenceSet.n_cols);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      results[i] = Candidate(metric.Evaluate(point, referenceSet.col(i)), i);
+    std::partial_sort(results.begin(), results.begin() + numResults,
+        results.end(), WorstOnTop());
+  }
+  else
+  {
+    size_t entry = entryPoint;
+    double distance = metric.Evaluate(point, referenceSet.col(entry));
+    for (size_t l = maxLevel; l > 0; --l)
+      entry = GreedyBest(point, entry, l, distance);
+
+    const std::vector<Candidate> entries(1, Candidate(distance, entry));
+    SearchLevel(point, entries, std::max(efSearch, numResults), 0, visited,
+        results);
+  }
+
+  size_t j = 0;
+  for (size_t i = 0; i < results.size() && j < k; ++i)
+  {
+    if (results[i].second == skip)
+      continue;
+
+    neighbors[j] = results[i].second;
+    distances[j] = results[i].first;
+    ++j;
+  }
+
+  for (; j < k; ++j)
+  {
+    neighbors[j] = SIZE_MAX;
+    distances[j] = SortPolicy::WorstDistance();
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (k > referenceSet.n_cols)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << referenceSet.n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (searchMode != NAIVE_MODE && levels.n_elem != referenceSet.n_cols)
+    BuildGraph();
+
+  Timer::Start("computing_neighbors");
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel
+  {
+    VisitedSet visited;
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.col(i), k, SIZE_MAX, visited, results,
+          neighbors.colptr(i), distances.colptr(i));
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSWSearch<SortPolicy, MetricType, MatType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is not less than the number of "
+        << "points in the reference set (" << referenceSet.n_cols << ") and "
+        << "no query set has been provided.";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (searchMode != NAIVE_MODE && levels.n_elem != referenceSet.n_cols)
+    BuildGraph();
+
+  Timer::Start("computing_neighbors");
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+
+  #pragma omp parallel
+  {
+    VisitedSet visited;
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      SearchPoint(referenceSet.col(i), k, (size_t) i, visited, results,
+          neighbors.colptr(i), distances.colptr(i));
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<SortPolicy, MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(degree);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(efSearch);
+  ar & BOOST_SERIALIZATION_NVP(searchMode);
+  ar & BOOST_SERIALIZATION_NVP(epsilon);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(levels);
+  ar & BOOST_SERIALIZATION_NVP(upperOffsets);
+  ar & BOOST_SERIALIZATION_NVP(baseLinks);
+  ar & BOOST_SERIALIZATION_NVP(upperLinks);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -59,7 +59,15 @@ PROGRAM_INFO("k-Nearest-Neighbors Search",
     "output matrix corresponds to the index of the point in the reference set "
     "which is the j'th nearest neighbor from the point in the query set with "
     "index i.  Row j and column i in the distances output matrix corresponds to"
-    " the distance between those two points.",
+    " the distance between those two points."
+    "\n\n"
+    "For high-dimensional data, the 'hnsw' tree type builds a hierarchical "
+    "navigable small world graph instead of a tree.  The search on the graph "
+    "is approximate; each point is linked to " + PRINT_PARAM_STRING("degree") +
+    " neighbors, and the recall of the search is controlled by " +
+    PRINT_PARAM_STRING("ef_search") + ", the number of candidates kept during "
+    "the search (and " + PRINT_PARAM_STRING("ef_construction") + " during the "
+    "construction of the graph).",
     SEE_ALSO("@lsh", "#lsh"),
     SEE_ALSO("@krann", "#krann"),
     SEE_ALSO("@kfn", "#kfn"),
@@ -94,7 +102,7 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'spill', 'oct', 'hnsw'.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
@@ -103,6 +111,12 @@ PARAM_DOUBLE_IN("tau", "Overlapping size (only valid for spill trees).", "u",
     0);
 PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
     0.7);
+PARAM_INT_IN("degree", "Number of neighbors of each point in the graph (only "
+    "valid for HNSW graphs).", "g", 16);
+PARAM_INT_IN("ef_construction", "Number of candidates considered when "
+    "inserting a point into the graph (only valid for HNSW graphs).", "c", 100);
+PARAM_INT_IN("ef_search", "Number of candidates considered when searching the "
+    "graph (only valid for HNSW graphs).", "f", 50);
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
@@ -128,6 +142,8 @@ static void mlpackMain()
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
+  ReportIgnoredParam({{ "input_model", true }}, "degree");
+  ReportIgnoredParam({{ "input_model", true }}, "ef_construction");
   if (CLI::HasParam("input_model") && CLI::HasParam("leaf_size"))
   {
     Log::Warn << PRINT_PARAM_STRING("leaf_size") << " will only be considered"
@@ -175,6 +191,21 @@ static void mlpackMain()
     ReportIgnoredParam("rho", "spill trees are not being used");
   }
 
+  // Sanity check on the graph parameters.
+  RequireParamValue<int>("degree", [](int x) { return x >= 2; }, true,
+      "degree must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be positive");
+  RequireParamValue<int>("ef_search", [](int x) { return x > 0; }, true,
+      "ef_search must be positive");
+  if (CLI::HasParam("reference") &&
+      CLI::GetParam<string>("tree_type") != "hnsw")
+  {
+    ReportIgnoredParam("degree", "HNSW graphs are not being used");
+    ReportIgnoredParam("ef_construction", "HNSW graphs are not being used");
+    ReportIgnoredParam("ef_search", "HNSW graphs are not being used");
+  }
+
   // Sanity check on epsilon.
   const double epsilon = CLI::GetParam<double>("epsilon");
   RequireParamValue<double>("epsilon", [](double x) { return x >= 0.0; }, true,
@@ -208,7 +239,7 @@ static void mlpackMain()
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "hnsw" }, true, "unknown tree type");
     if (treeType == "kd")
       tree = KNNModel::KD_TREE;
     else if (treeType == "cover")
@@ -239,12 +270,17 @@ static void mlpackMain()
       tree = KNNModel::UB_TREE;
     else if (treeType == "oct")
       tree = KNNModel::OCTREE;
+    else if (treeType == "hnsw")
+      tree = KNNModel::HNSW;
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
+    knn->Degree() = (size_t) CLI::GetParam<int>("degree");
+    knn->EfConstruction() = (size_t) CLI::GetParam<int>("ef_construction");
+    knn->EfSearch() = (size_t) CLI::GetParam<int>("ef_search");
 
     arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
 
@@ -271,6 +307,10 @@ static void mlpackMain()
     if (CLI::HasParam("leaf_size"))
       knn->LeafSize() = size_t(lsInt);
 
+    // The number of candidates of a graph search may also be changed.
+    if (CLI::HasParam("ef_search"))
+      knn->EfSearch() = (size_t) CLI::GetParam<int>("ef_search");
+
     Log::Info << "Loaded kNN model from '"
         << CLI::GetPrintableParam<KNNModel*>("input_model") << "' (trained on "
         << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
@@ -327,7 +367,8 @@ static void mlpackMain()
     // Calculate the effective error, if desired.
     if (CLI::HasParam("true_distances"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE &&
+          knn->TreeType() != KNNModel::HNSW && knn->Epsilon() == 0)
         Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
             << "the search is exact, so there is no need to calculate the "
             << "error!" << endl;
@@ -347,7 +388,8 @@ static void mlpackMain()
     // Calculate the recall, if desired.
     if (CLI::HasParam("true_neighbors"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE &&
+          knn->TreeType() != KNNModel::HNSW && knn->Epsilon() == 0)
         Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
             << " the search is exact, so there is no need to calculate the "
             << "recall!" << endl;
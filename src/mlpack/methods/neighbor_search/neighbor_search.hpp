@@ -273,6 +273,38 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Insert the given points into the reference set.  The new points are given
+   * the indices following the last index in use, so the indices of the other
+   * points don't change.  With a RectangleTree, the points are inserted into
+   * the tree; with other trees (and naive search), they are kept aside and
+   * searched by brute force until the tree is next rebuilt.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the points with the given indices from the reference set.  Removed
+   * points are never returned as neighbors, and their indices are not reused.
+   * With a RectangleTree, the points are deleted from the tree; with other
+   * trees, they are only marked as removed until the tree is next rebuilt.
+   *
+   * @param indices Indices of the points to remove.
+   * @throw std::invalid_argument if an index does not belong to a reference
+   *     point or is given more than once; no point is removed in that case.
+   */
+  void Remove(const arma::Col<size_t>& indices);
+
+  /**
+   * Rebuild the reference tree on the current reference points, dropping the
+   * removed points and adding the points inserted since the last build.  This
+   * is done automatically by Insert() and Remove() once the number of pending
+   * updates exceeds RebuildThreshold() times the number of reference points,
+   * and by the monochromatic Search() if there are pending updates.
+   */
+  void Rebuild();
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -322,9 +354,21 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
-  //! Access the reference dataset.
+  //! Access the reference dataset.  After points have been inserted or
+  //! removed, its columns may not match the reference indices; it holds the
+  //! points of the reference tree, including removed points until the next
+  //! rebuild.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
+  //! Get the number of reference points (not counting removed points).
+  size_t NumReferencePoints() const
+  { return referenceSet->n_cols - numRemoved + insertedSet.n_cols; }
+
+  //! Get the fraction of pending updates that triggers a rebuild.
+  double RebuildThreshold() const { return rebuildThreshold; }
+  //! Modify the fraction of pending updates that triggers a rebuild.
+  double& RebuildThreshold() { return rebuildThreshold; }
+
   //! Access the reference tree.
   const Tree& ReferenceTree() const { return *referenceTree; }
   //! Modify the reference tree.
@@ -332,10 +376,11 @@ class NeighborSearch
 
   //! Serialize the NeighborSearch model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
-  //! Permutations of reference points during tree building.
+  //! Permutations of reference points during tree building; after a rebuild,
+  //! the index of each point of the reference set.
   std::vector<size_t> oldFromNewReferences;
   //! Pointer to the root of the reference tree.
   Tree* referenceTree;
@@ -359,6 +404,40 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! Points inserted since the reference tree was last built.
+  MatType insertedSet;
+  //! Indices of the points of insertedSet.
+  std::vector<size_t> insertedIndices;
+  //! Whether each point of the reference set has been removed (empty if no
+  //! point was removed).
+  std::vector<bool> removedReferences;
+  //! Number of removed points in the reference set.
+  size_t numRemoved;
+  //! Column of each reference index in the reference set (built when a point
+  //! is removed; empty if not needed).
+  std::vector<size_t> newFromOldReferences;
+  //! Number of reference indices in use, including removed points.
+  size_t numReferenceIndices;
+  //! Fraction of pending updates that triggers a rebuild.
+  double rebuildThreshold;
+
+  //! Forget all inserted and removed points, after the reference set has been
+  //! replaced.
+  void ResetUpdates();
+
+  //! Rebuild the reference tree if there are too many pending updates.
+  void RebuildIfNeeded();
+
+  //! Get the column of the given reference index in the reference set, or
+  //! SIZE_MAX if the point is not in the reference set.
+  size_t ReferenceColumn(const size_t index);
+
+  //! Add the inserted points to the results of a search.
+  void MergeInserted(const MatType& querySet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -367,6 +446,31 @@ class NeighborSearch
 } // namespace neighbor
 } // namespace mlpack
 
+namespace boost {
+namespace serialization {
+
+//! Set the serialization version of the NeighborSearch class (version 1 adds
+//! the inserted and removed points).  BOOST_TEMPLATE_CLASS_VERSION() can't be
+//! used because of the commas in the template signature.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+struct version<mlpack::neighbor::NeighborSearch<SortPolicy, MetricType,
+    MatType, TreeType, DualTreeTraversalType, SingleTreeTraversalType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "neighbor_search_impl.hpp"
 
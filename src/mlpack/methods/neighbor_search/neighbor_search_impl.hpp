@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree/is_rectangle_tree.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -45,6 +46,59 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Insert points into a tree that supports insertion.
+template<typename TreeType, typename MatType>
+bool InsertIntoTree(
+    TreeType& tree,
+    const MatType& points,
+    const typename std::enable_if_t<
+        tree::IsRectangleTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  const size_t first = tree.Dataset().n_cols;
+  tree.Dataset().insert_cols(first, points);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    tree.InsertPoint(first + i);
+
+  return true;
+}
+
+//! Other trees can't insert points.
+template<typename TreeType, typename MatType>
+bool InsertIntoTree(
+    TreeType& /* tree */,
+    const MatType& /* points */,
+    const typename std::enable_if_t<
+        !tree::IsRectangleTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  return false;
+}
+
+//! Delete a point from a tree that supports deletion.
+template<typename TreeType>
+void DeleteFromTree(
+    TreeType& tree,
+    const size_t point,
+    const typename std::enable_if_t<
+        tree::IsRectangleTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  tree.DeletePoint(point);
+}
+
+//! Other trees keep the point (it is only marked as removed).
+template<typename TreeType>
+void DeleteFromTree(
+    TreeType& /* tree */,
+    const size_t /* point */,
+    const typename std::enable_if_t<
+        !tree::IsRectangleTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  // Nothing to do.
+}
+
 // Construct the object.
 template<typename SortPolicy,
          typename MetricType,
@@ -68,7 +122,10 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    numRemoved(0),
+    numReferenceIndices(referenceSet->n_cols),
+    rebuildThreshold(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -95,7 +152,10 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    numRemoved(0),
+    numReferenceIndices(referenceSet->n_cols),
+    rebuildThreshold(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -121,7 +181,10 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    numRemoved(0),
+    numReferenceIndices(referenceSet->n_cols),
+    rebuildThreshold(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -154,7 +217,14 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    insertedSet(other.insertedSet),
+    insertedIndices(other.insertedIndices),
+    removedReferences(other.removedReferences),
+    numRemoved(other.numRemoved),
+    newFromOldReferences(other.newFromOldReferences),
+    numReferenceIndices(other.numReferenceIndices),
+    rebuildThreshold(other.rebuildThreshold)
 {
   // Nothing else to do.
 }
@@ -178,7 +248,14 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    insertedSet(std::move(other.insertedSet)),
+    insertedIndices(std::move(other.insertedIndices)),
+    removedReferences(std::move(other.removedReferences)),
+    numRemoved(other.numRemoved),
+    newFromOldReferences(std::move(other.newFromOldReferences)),
+    numReferenceIndices(other.numReferenceIndices),
+    rebuildThreshold(other.rebuildThreshold)
 {
   // Clear the other model.
   other.referenceSet = new MatType();
@@ -190,6 +267,7 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.ResetUpdates();
 }
 
 // Copy operator.
@@ -233,6 +311,15 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  insertedSet = other.insertedSet;
+  insertedIndices = other.insertedIndices;
+  removedReferences = other.removedReferences;
+  numRemoved = other.numRemoved;
+  newFromOldReferences = other.newFromOldReferences;
+  numReferenceIndices = other.numReferenceIndices;
+  rebuildThreshold = other.rebuildThreshold;
+
+  return *this;
 }
 
 // Move operator.
@@ -275,6 +362,13 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  insertedSet = std::move(other.insertedSet);
+  insertedIndices = std::move(other.insertedIndices);
+  removedReferences = std::move(other.removedReferences);
+  numRemoved = other.numRemoved;
+  newFromOldReferences = std::move(other.newFromOldReferences);
+  numReferenceIndices = other.numReferenceIndices;
+  rebuildThreshold = other.rebuildThreshold;
 
   // Reset the other object.
   other.referenceTree = BuildTree<Tree>(*other.referenceSet,
@@ -285,6 +379,9 @@ NeighborSearch<SortPolicy,
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.ResetUpdates();
+
+  return *this;
 }
 
 // Clean memory.
@@ -317,9 +414,9 @@ void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
 {
   // Clean up the old tree, if we built one.
+  oldFromNewReferences.clear();
   if (referenceTree)
   {
-    oldFromNewReferences.clear();
     delete referenceTree;
     referenceTree = NULL;
   }
@@ -339,6 +436,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   {
     referenceSet = new MatType(std::move(referenceSetIn));
   }
+
+  ResetUpdates();
 }
 
 template<typename SortPolicy,
@@ -356,9 +455,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
     throw std::invalid_argument("cannot train on given reference tree when "
         "naive search (without trees) is desired");
 
+  oldFromNewReferences.clear();
   if (this->referenceTree)
   {
-    oldFromNewReferences.clear();
     delete this->referenceTree;
   }
   else
@@ -368,6 +467,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+  ResetUpdates();
 }
 
 /**
@@ -389,14 +489,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
 
+  // The tree must hold at least k points that have not been removed.
+  if (referenceSet->n_cols - numRemoved < k)
+    Rebuild();
+
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
@@ -412,18 +516,26 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
 
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  // Query indices need to be mapped if the tree rearranges points; reference
+  // indices need to be mapped if we have a mapping (because the tree
+  // rearranges points or because the tree was rebuilt after updates).
+  const bool mapQueries = tree::TreeTraits<Tree>::RearrangesDataset &&
+      (searchMode == DUAL_TREE_MODE);
+  const bool mapReferences = !oldFromNewReferences.empty();
+  if (mapQueries)
   {
-    if (searchMode == DUAL_TREE_MODE)
-    {
-      distancePtr = new arma::mat; // Query indices need to be mapped.
-      neighborPtr = new arma::Mat<size_t>;
-    }
-    else if (!oldFromNewReferences.empty())
-      neighborPtr = new arma::Mat<size_t>; // Reference indices need mapping.
+    distancePtr = new arma::mat;
+    neighborPtr = new arma::Mat<size_t>;
+  }
+  else if (mapReferences)
+  {
+    neighborPtr = new arma::Mat<size_t>;
   }
 
+  // Removed points must not be returned.
+  const std::vector<bool>* removed = removedReferences.empty() ? NULL :
+      &removedReferences;
+
   // Set the size of the neighbor and distance matrices.
   neighborPtr->set_size(k, querySet.n_cols);
   distancePtr->set_size(k, querySet.n_cols);
@@ -436,6 +548,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+      rules.RemovedReferences() = removed;
 
       // The naive brute-force traversal.
       for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -451,6 +564,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+      rules.RemovedReferences() = removed;
 
       // Create the traverser.
       SingleTreeTraversalType<RuleType> traverser(rules);
@@ -459,6 +573,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < querySet.n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
+      Profiler::Add(PrunesCounter, traverser.NumPrunes());
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -481,12 +596,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
+      rules.RemovedReferences() = removed;
 
       // Create the traverser.
       DualTreeTraversalType<RuleType> traverser(rules);
 
       traverser.Traverse(*queryTree, *referenceTree);
 
+      Profiler::Add(PrunesCounter, traverser.NumPrunes());
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -504,6 +621,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
+      rules.RemovedReferences() = removed;
 
       // Create the traverser.
       tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
@@ -515,6 +633,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < querySet.n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
+      Profiler::Add(PrunesCounter, traverser.NumPrunes());
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -529,11 +648,13 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 
   Timer::Stop("computing_neighbors");
+  Profiler::Add(BaseCasesCounter, baseCases);
+  Profiler::Add(NodeVisitsCounter, scores);
 
   // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  if (mapQueries || mapReferences)
   {
-    if (searchMode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
+    if (mapQueries && mapReferences)
     {
       // We must map both query and reference indices.
       neighbors.set_size(k, querySet.n_cols);
@@ -556,7 +677,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (searchMode == DUAL_TREE_MODE)
+    else if (mapQueries)
     {
       // We must map query indices only.
       neighbors.set_size(k, querySet.n_cols);
@@ -574,7 +695,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (!oldFromNewReferences.empty())
+    else
     {
       // We must map reference indices only.
       neighbors.set_size(k, querySet.n_cols);
@@ -588,6 +709,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
     }
   }
+
+  // The inserted points that are not in the tree yet are searched separately.
+  MergeInserted(querySet, k, neighbors, distances);
 } // Search()
 
 template<typename SortPolicy,
@@ -606,6 +730,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
+  // The query tree can't be matched with points outside the reference tree.
+  if (numRemoved > 0 || insertedSet.n_cols > 0)
+    Rebuild();
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -630,8 +758,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // We won't need to map query indices, but will we need to map distances?
   arma::Mat<size_t>* neighborPtr = &neighbors;
 
-  if (!oldFromNewReferences.empty() &&
-      tree::TreeTraits<Tree>::RearrangesDataset)
+  if (!oldFromNewReferences.empty())
     neighborPtr = new arma::Mat<size_t>;
 
   neighborPtr->set_size(k, querySet.n_cols);
@@ -645,6 +772,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   DualTreeTraversalType<RuleType> traverser(rules);
   traverser.Traverse(queryTree, *referenceTree);
 
+  Profiler::Add(PrunesCounter, traverser.NumPrunes());
   scores += rules.Scores();
   baseCases += rules.BaseCases();
 
@@ -657,10 +785,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   Log::Info << rules.BaseCases() << " base cases were calculated.\n";
 
   Timer::Stop("computing_neighbors");
+  Profiler::Add(BaseCasesCounter, baseCases);
+  Profiler::Add(NodeVisitsCounter, scores);
 
   // Do we need to map indices?
-  if (!oldFromNewReferences.empty() &&
-      tree::TreeTraits<Tree>::RearrangesDataset)
+  if (!oldFromNewReferences.empty())
   {
     // We must map reference indices only.
     neighbors.set_size(k, querySet.n_cols);
@@ -689,6 +818,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
+  // Every reference point must be in the tree to be used as a query point.
+  if (numRemoved > 0 || insertedSet.n_cols > 0)
+    Rebuild();
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -713,8 +846,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
 
-  if (!oldFromNewReferences.empty() &&
-      tree::TreeTraits<Tree>::RearrangesDataset)
+  if (!oldFromNewReferences.empty())
   {
     // We will always need to rearrange in this case.
     distancePtr = new arma::mat;
@@ -751,6 +883,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
+      Profiler::Add(PrunesCounter, traverser.NumPrunes());
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -799,6 +932,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         treeNeedsReset = true;
       }
 
+      Profiler::Add(PrunesCounter, traverser.NumPrunes());
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -823,6 +957,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
+      Profiler::Add(PrunesCounter, traverser.NumPrunes());
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -837,15 +972,23 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   rules.GetResults(*neighborPtr, *distancePtr);
 
   Timer::Stop("computing_neighbors");
+  Profiler::Add(BaseCasesCounter, baseCases);
+  Profiler::Add(NodeVisitsCounter, scores);
 
   // Do we need to map the reference indices?
-  if (!oldFromNewReferences.empty() &&
-      tree::TreeTraits<Tree>::RearrangesDataset)
+  if (!oldFromNewReferences.empty())
   {
-    neighbors.set_size(k, referenceSet->n_cols);
-    distances.set_size(k, referenceSet->n_cols);
+    // There is one column per reference index; removed points have no
+    // neighbors.
+    neighbors.set_size(k, numReferenceIndices);
+    distances.set_size(k, numReferenceIndices);
+    if (numReferenceIndices > referenceSet->n_cols)
+    {
+      neighbors.fill(SIZE_MAX);
+      distances.fill(SortPolicy::WorstDistance());
+    }
 
-    for (size_t i = 0; i < distances.n_cols; ++i)
+    for (size_t i = 0; i < distancePtr->n_cols; ++i)
     {
       // Map distances (copy a column).
       const size_t refMapping = oldFromNewReferences[i];
@@ -862,6 +1005,286 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points)
+{
+  const bool empty = (referenceSet->n_cols == 0 && insertedSet.n_cols == 0);
+  const size_t dimensionality = (referenceSet->n_cols > 0) ?
+      referenceSet->n_rows : insertedSet.n_rows;
+  if (!empty && points.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Insert(): dimensionality of the points ("
+        << points.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Insert the points directly into the tree, if it supports it.  (A tree
+  // built on an empty set doesn't know the dimensionality yet.)
+  const size_t first = referenceSet->n_cols;
+  if (referenceTree && referenceSet->n_cols > 0 &&
+      InsertIntoTree(*referenceTree, points))
+  {
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      if (!oldFromNewReferences.empty())
+        oldFromNewReferences.push_back(numReferenceIndices + i);
+      if (!newFromOldReferences.empty())
+        newFromOldReferences.push_back(first + i);
+      if (!removedReferences.empty())
+        removedReferences.push_back(false);
+    }
+
+    // The bounds of the statistics must be recomputed.
+    treeNeedsReset = true;
+  }
+  else
+  {
+    insertedSet.insert_cols(insertedSet.n_cols, points);
+    for (size_t i = 0; i < points.n_cols; ++i)
+      insertedIndices.push_back(numReferenceIndices + i);
+  }
+
+  numReferenceIndices += points.n_cols;
+  RebuildIfNeeded();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Remove(
+    const arma::Col<size_t>& indices)
+{
+  // Check all of the indices first, so that nothing is removed if one of them
+  // is invalid.
+  const arma::Col<size_t> sortedIndices = arma::sort(indices);
+  for (size_t i = 0; i < sortedIndices.n_elem; ++i)
+  {
+    const size_t index = sortedIndices[i];
+    if (i > 0 && index == sortedIndices[i - 1])
+    {
+      std::ostringstream oss;
+      oss << "NeighborSearch::Remove(): index " << index << " is given more "
+          << "than once!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (std::binary_search(insertedIndices.begin(), insertedIndices.end(),
+        index))
+      continue;
+
+    const size_t column = ReferenceColumn(index);
+    if (column == SIZE_MAX ||
+        (!removedReferences.empty() && removedReferences[column]))
+    {
+      std::ostringstream oss;
+      oss << "NeighborSearch::Remove(): there is no reference point with index "
+          << index << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t index = indices[i];
+
+    // The point may not have been added to the tree yet.
+    std::vector<size_t>::iterator it = std::lower_bound(
+        insertedIndices.begin(), insertedIndices.end(), index);
+    if (it != insertedIndices.end() && *it == index)
+    {
+      insertedSet.shed_col(it - insertedIndices.begin());
+      insertedIndices.erase(it);
+      continue;
+    }
+
+    const size_t column = ReferenceColumn(index);
+    if (removedReferences.empty())
+      removedReferences.resize(referenceSet->n_cols, false);
+    removedReferences[column] = true;
+    ++numRemoved;
+
+    if (referenceTree)
+      DeleteFromTree(*referenceTree, column);
+  }
+
+  RebuildIfNeeded();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Rebuild()
+{
+  // Collect the points that have not been removed, and their indices.
+  const size_t dimensionality = (referenceSet->n_cols > 0) ?
+      referenceSet->n_rows : insertedSet.n_rows;
+  MatType points(dimensionality, NumReferencePoints());
+  std::vector<size_t> indices(points.n_cols);
+  size_t column = 0;
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+  {
+    if (!removedReferences.empty() && removedReferences[i])
+      continue;
+
+    points.col(column) = referenceSet->col(i);
+    indices[column++] = oldFromNewReferences.empty() ? i :
+        oldFromNewReferences[i];
+  }
+  for (size_t i = 0; i < insertedSet.n_cols; ++i)
+  {
+    points.col(column) = insertedSet.col(i);
+    indices[column++] = insertedIndices[i];
+  }
+
+  // Training forgets the indices in use; they must not be reused.
+  const size_t numIndices = numReferenceIndices;
+  Train(std::move(points));
+  numReferenceIndices = numIndices;
+
+  // Map the columns of the new reference set to the indices.
+  if (oldFromNewReferences.empty())
+  {
+    oldFromNewReferences = std::move(indices);
+  }
+  else
+  {
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      oldFromNewReferences[i] = indices[oldFromNewReferences[i]];
+  }
+  treeNeedsReset = false;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ResetUpdates()
+{
+  insertedSet.reset();
+  insertedIndices.clear();
+  removedReferences.clear();
+  numRemoved = 0;
+  newFromOldReferences.clear();
+  numReferenceIndices = referenceSet->n_cols;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RebuildIfNeeded()
+{
+  const size_t pending = insertedSet.n_cols + numRemoved;
+  if (pending > rebuildThreshold * NumReferencePoints())
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ReferenceColumn(
+    const size_t index)
+{
+  if (oldFromNewReferences.empty())
+    return (index < referenceSet->n_cols) ? index : SIZE_MAX;
+
+  // Build the inverse mapping, if we don't have it yet.
+  if (newFromOldReferences.empty())
+  {
+    newFromOldReferences.resize(numReferenceIndices, SIZE_MAX);
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      newFromOldReferences[oldFromNewReferences[i]] = i;
+  }
+
+  return (index < newFromOldReferences.size()) ?
+      newFromOldReferences[index] : SIZE_MAX;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MergeInserted(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (insertedSet.n_cols == 0)
+    return;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < insertedSet.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(querySet.col(i),
+          insertedSet.col(j));
+
+      // Find where the point goes in the sorted list of neighbors.
+      size_t position = k;
+      while (position > 0 &&
+          SortPolicy::IsBetter(distance, distances(position - 1, i)))
+        --position;
+      if (position == k)
+        continue;
+
+      for (size_t l = k - 1; l > position; --l)
+      {
+        neighbors(l, i) = neighbors(l - 1, i);
+        distances(l, i) = distances(l - 1, i);
+      }
+      neighbors(position, i) = insertedIndices[j];
+      distances(position, i) = distance;
+    }
+  }
+
+  baseCases += querySet.n_cols * insertedSet.n_cols;
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -944,7 +1367,7 @@ template<typename Archive>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
   // Serialize preferences for search.
   ar & BOOST_SERIALIZATION_NVP(searchMode);
@@ -972,6 +1395,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
       referenceTree = NULL;
       oldFromNewReferences.clear();
     }
+
+    // After a rebuild, the columns of the dataset may not be the indices.
+    if (version >= 1)
+      ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
   }
   else
   {
@@ -993,11 +1420,27 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     }
   }
 
+  // Serialize the points inserted or removed since the last build.
+  if (version >= 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(insertedSet);
+    ar & BOOST_SERIALIZATION_NVP(insertedIndices);
+    ar & BOOST_SERIALIZATION_NVP(removedReferences);
+    ar & BOOST_SERIALIZATION_NVP(numRemoved);
+    ar & BOOST_SERIALIZATION_NVP(numReferenceIndices);
+    ar & BOOST_SERIALIZATION_NVP(rebuildThreshold);
+  }
+  else if (Archive::is_loading::value)
+  {
+    ResetUpdates();
+  }
+
   // Reset base cases and scores.
   if (Archive::is_loading::value)
   {
     baseCases = 0;
     scores = 0;
+    newFromOldReferences.clear();
   }
 }
 
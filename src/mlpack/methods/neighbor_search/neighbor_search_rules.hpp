@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/distance_block.hpp>
 
 #include <queue>
 
@@ -73,6 +74,21 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the given query points and a range of
+   * reference points (the points of a leaf), with the same results as calling
+   * BaseCase() for each pair.  For the Euclidean distance, all the distances
+   * are computed with one matrix product, and only the reference points that
+   * may enter the list of candidates get their exact distance computed.
+   *
+   * @param queryIndices Indices of the query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -157,6 +173,13 @@ class NeighborSearchRules
   //! Modify the traversal info.
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
+  //! Get the mask of removed reference points (NULL if there are none).
+  const std::vector<bool>* RemovedReferences() const
+  { return removedReferences; }
+  //! Modify the mask of removed reference points; base cases are still
+  //! computed for removed points, but they are never returned as neighbors.
+  const std::vector<bool>*& RemovedReferences() { return removedReferences; }
+
  protected:
   //! The reference set.
   const typename TreeType::Mat& referenceSet;
@@ -210,6 +233,14 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! Mask of removed reference points, or NULL.
+  const std::vector<bool>* removedReferences;
+
+  //! Computes the distances of the blocked base cases.
+  metric::DistanceBlock<MetricType, typename TreeType::Mat> distanceBlock;
+  //! The distances of the last blocked base case.
+  arma::mat blockDistances;
+
   /**
    * Recalculate the bound for a given query node.
    */
@@ -36,7 +36,9 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    removedReferences(NULL),
+    distanceBlock(metric, querySet, referenceSet)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -97,7 +99,9 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
                                     referenceSet.col(referenceIndex));
   ++baseCases;
 
-  InsertNeighbor(queryIndex, referenceIndex, distance);
+  // Removed points still give valid distances for the bounds of their nodes.
+  if (!removedReferences || !(*removedReferences)[referenceIndex])
+    InsertNeighbor(queryIndex, referenceIndex, distance);
 
   // Cache this information for the next time BaseCase() is called.
   lastQueryIndex = queryIndex;
@@ -107,6 +111,58 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlock(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  typedef metric::DistanceBlock<MetricType, typename TreeType::Mat> BlockType;
+
+  // Without a matrix product, there is nothing to gain over BaseCase().
+  if (!BlockType::UsesProduct)
+  {
+    for (size_t j = 0; j < queryIndices.size(); ++j)
+      for (size_t i = 0; i < referenceCount; ++i)
+        BaseCase(queryIndices[j], referenceBegin + i);
+    return;
+  }
+
+  const double error = distanceBlock.Evaluate(queryIndices, referenceBegin,
+      referenceCount, blockDistances);
+
+  for (size_t j = 0; j < queryIndices.size(); ++j)
+  {
+    const size_t queryIndex = queryIndices[j];
+    const CandidateList& pqueue = candidates[queryIndex];
+    const double* distances = blockDistances.colptr(j);
+    for (size_t i = 0; i < referenceCount; ++i)
+    {
+      const size_t referenceIndex = referenceBegin + i;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+      if (removedReferences && (*removedReferences)[referenceIndex])
+        continue;
+
+      // Most points can't be better than the current k-th candidate even with
+      // the largest error; the others need their exact distance.
+      if (!SortPolicy::IsBetter(SortPolicy::CombineBest(distances[i], error),
+          pqueue.top().first))
+        continue;
+
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(referenceIndex));
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+    }
+  }
+
+  // The last pair of BaseCase() may not have been computed exactly.
+  lastQueryIndex = querySet.n_cols;
+  lastReferenceIndex = referenceSet.n_cols;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
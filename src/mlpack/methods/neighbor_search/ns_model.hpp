@@ -22,6 +22,7 @@
 #include <mlpack/core/tree/octree.hpp>
 #include <boost/variant.hpp>
 #include "neighbor_search.hpp"
+#include "hnsw_search.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -124,6 +125,9 @@ class BiSearchVisitor : public boost::static_visitor<void>
   //! Bichromatic neighbor search specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
+  //! Bichromatic neighbor search specialized for HNSW graphs.
+  void operator()(HNSWSearch<SortPolicy>* ns) const;
+
   //! Construct the BiSearchVisitor.
   BiSearchVisitor(const arma::mat& querySet,
                   const size_t k,
@@ -182,6 +186,9 @@ class TrainVisitor : public boost::static_visitor<void>
   //! Train specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
+  //! Train specialized for HNSW graphs.
+  void operator()(HNSWSearch<SortPolicy>* ns) const;
+
   //! Construct the TrainVisitor object with the given reference set, leafSize
   //! for BinarySpaceTrees, and tau and rho for spill trees.
   TrainVisitor(arma::mat&& referenceSet,
@@ -223,6 +230,52 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(NSType *ns) const;
 };
 
+/**
+ * InsertVisitor adds new reference points to the given NSType.  HNSW graphs
+ * can't be updated, so an exception is thrown for them.
+ */
+template<typename SortPolicy>
+class InsertVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to insert.
+  const arma::mat& points;
+
+ public:
+  //! Insert the points into the given NSType.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Throw an exception, since HNSW graphs can't be updated.
+  void operator()(HNSWSearch<SortPolicy>* ns) const;
+
+  //! Construct the InsertVisitor with the given points.
+  InsertVisitor(const arma::mat& points) : points(points) { }
+};
+
+/**
+ * RemoveVisitor removes reference points from the given NSType.  HNSW graphs
+ * can't be updated, so an exception is thrown for them.
+ */
+template<typename SortPolicy>
+class RemoveVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The indices of the points to remove.
+  const arma::Col<size_t>& indices;
+
+ public:
+  //! Remove the points from the given NSType.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Throw an exception, since HNSW graphs can't be updated.
+  void operator()(HNSWSearch<SortPolicy>* ns) const;
+
+  //! Construct the RemoveVisitor with the given indices.
+  RemoveVisitor(const arma::Col<size_t>& indices) : indices(indices) { }
+};
+
 /**
  * DeleteVisitor deletes the given NSType instance.
  */
@@ -265,7 +318,8 @@ class NSModel
     MAX_RP_TREE,
     SPILL_TREE,
     UB_TREE,
-    OCTREE
+    OCTREE,
+    HNSW
   };
 
  private:
@@ -280,6 +334,13 @@ class NSModel
   //! Balance threshold (for spill trees).
   double rho;
 
+  //! Number of neighbors of each point (for HNSW graphs).
+  size_t degree;
+  //! Number of candidates considered when building (for HNSW graphs).
+  size_t efConstruction;
+  //! Number of candidates considered when searching (for HNSW graphs).
+  size_t efSearch;
+
   //! If true, random projections are used.
   bool randomBasis;
   //! This is the random projection matrix; only used if randomBasis is true.
@@ -304,7 +365,8 @@ class NSModel
                  NSType<SortPolicy, tree::MaxRPTree>*,
                  SpillKNN*,
                  NSType<SortPolicy, tree::UBTree>*,
-                 NSType<SortPolicy, tree::Octree>*> nSearch;
+                 NSType<SortPolicy, tree::Octree>*,
+                 HNSWSearch<SortPolicy>*> nSearch;
 
  public:
   /**
@@ -375,6 +437,18 @@ class NSModel
   double Rho() const { return rho; }
   double& Rho() { return rho; }
 
+  //! Expose degree (for HNSW graphs).
+  size_t Degree() const { return degree; }
+  size_t& Degree() { return degree; }
+
+  //! Expose efConstruction (for HNSW graphs).
+  size_t EfConstruction() const { return efConstruction; }
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Expose efSearch (for HNSW graphs).
+  size_t EfSearch() const { return efSearch; }
+  size_t& EfSearch() { return efSearch; }
+
   //! Expose treeType.
   TreeTypes TreeType() const { return treeType; }
   TreeTypes& TreeType() { return treeType; }
@@ -400,6 +474,18 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Add the given points to the reference set; they are given the next
+   * reference indices.  This is not supported for HNSW graphs.
+   */
+  void Insert(arma::mat&& points);
+
+  /**
+   * Remove the reference points with the given indices.  This is not
+   * supported for HNSW graphs.
+   */
+  void Remove(const arma::Col<size_t>& indices);
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
 };
@@ -409,7 +495,7 @@ class NSModel
 
 //! Set the serialization version of the NSModel class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+    mlpack::neighbor::NSModel<SortPolicy>, 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
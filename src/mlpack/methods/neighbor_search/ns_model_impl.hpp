@@ -110,6 +110,15 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Bichromatic neighbor search specialized for HNSW graphs.
+template<typename SortPolicy>
+void BiSearchVisitor<SortPolicy>::operator()(HNSWSearch<SortPolicy>* ns) const
+{
+  if (ns)
+    return ns->Search(querySet, k, neighbors, distances);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Bichromatic neighbor search on the given NSType considering the leafSize.
 template<typename SortPolicy>
 template<typename NSType>
@@ -207,6 +216,15 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Train specialized for HNSW graphs.
+template<typename SortPolicy>
+void TrainVisitor<SortPolicy>::operator()(HNSWSearch<SortPolicy>* ns) const
+{
+  if (ns)
+    return ns->Train(std::move(referenceSet));
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Train on the given NSType considering the leafSize.
 template<typename SortPolicy>
 template<typename NSType>
@@ -252,6 +270,44 @@ const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Insert the points into the given NSType.
+template<typename SortPolicy>
+template<typename NSType>
+void InsertVisitor<SortPolicy>::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Insert(points);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! HNSW graphs can't be updated.
+template<typename SortPolicy>
+void InsertVisitor<SortPolicy>::operator()(
+    HNSWSearch<SortPolicy>* /* ns */) const
+{
+  throw std::invalid_argument("NSModel::Insert(): points can't be inserted "
+      "into an HNSW graph; rebuild the model instead!");
+}
+
+//! Remove the points from the given NSType.
+template<typename SortPolicy>
+template<typename NSType>
+void RemoveVisitor<SortPolicy>::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Remove(indices);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! HNSW graphs can't be updated.
+template<typename SortPolicy>
+void RemoveVisitor<SortPolicy>::operator()(
+    HNSWSearch<SortPolicy>* /* ns */) const
+{
+  throw std::invalid_argument("NSModel::Remove(): points can't be removed "
+      "from an HNSW graph; rebuild the model instead!");
+}
+
 //! Clean memory, if necessary.
 template<typename NSType>
 void DeleteVisitor::operator()(NSType* ns) const
@@ -270,6 +326,9 @@ NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
     leafSize(20),
     tau(0),
     rho(0.7),
+    degree(16),
+    efConstruction(100),
+    efSearch(50),
     randomBasis(randomBasis)
 {
   // Nothing to do.
@@ -281,6 +340,9 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
+    degree(other.degree),
+    efConstruction(other.efConstruction),
+    efSearch(other.efSearch),
     randomBasis(other.randomBasis),
     q(other.q),
     nSearch(other.nSearch)
@@ -294,6 +356,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
+    degree(other.degree),
+    efConstruction(other.efConstruction),
+    efSearch(other.efSearch),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
     nSearch(other.nSearch)
@@ -303,6 +368,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.leafSize = 20;
   other.tau = 0;
   other.rho = 0.7;
+  other.degree = 16;
+  other.efConstruction = 100;
+  other.efSearch = 50;
   other.randomBasis = false;
   other.nSearch = decltype(other.nSearch)();
 }
@@ -316,6 +384,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   leafSize = other.leafSize;
   tau = other.tau;
   rho = other.rho;
+  degree = other.degree;
+  efConstruction = other.efConstruction;
+  efSearch = other.efSearch;
   randomBasis = other.randomBasis;
   q = other.q;
   nSearch = other.nSearch;
@@ -332,6 +403,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   leafSize = other.leafSize;
   tau = other.tau;
   rho = other.rho;
+  degree = other.degree;
+  efConstruction = other.efConstruction;
+  efSearch = other.efSearch;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
   // Copy the pointer and type.
@@ -342,6 +416,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.leafSize = 20;
   other.tau = 0;
   other.rho = 0.7;
+  other.degree = 16;
+  other.efConstruction = 100;
+  other.efSearch = 50;
   other.randomBasis = false;
   other.nSearch = decltype(other.nSearch)();
 
@@ -369,6 +446,12 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
     ar & BOOST_SERIALIZATION_NVP(tau);
     ar & BOOST_SERIALIZATION_NVP(rho);
   }
+  if (version > 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(degree);
+    ar & BOOST_SERIALIZATION_NVP(efConstruction);
+    ar & BOOST_SERIALIZATION_NVP(efSearch);
+  }
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
@@ -514,6 +597,10 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     case OCTREE:
       nSearch = new NSType<SortPolicy, tree::Octree>(searchMode, epsilon);
       break;
+    case HNSW:
+      nSearch = new HNSWSearch<SortPolicy>(degree, efConstruction, efSearch,
+          searchMode, epsilon);
+      break;
   }
 
   TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
@@ -539,21 +626,36 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
 
   Log::Info << "Searching for " << k << " neighbors with ";
 
-  switch (SearchMode())
+  // The number of candidates of a graph search may have changed since the
+  // graph was built.
+  if (treeType == HNSW)
+    boost::get<HNSWSearch<SortPolicy>*>(nSearch)->EfSearch() = efSearch;
+
+  // The graph is searched the same way in every search mode but the naive
+  // one.
+  if (treeType == HNSW && SearchMode() != NAIVE_MODE)
   {
-    case NAIVE_MODE:
-      Log::Info << "brute-force (naive) search..." << std::endl;
-      break;
-    case SINGLE_TREE_MODE:
-      Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case DUAL_TREE_MODE:
-      Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case GREEDY_SINGLE_TREE_MODE:
-      Log::Info << "greedy single-tree " << TreeName() << " search..."
-          << std::endl;
-      break;
+    Log::Info << TreeName() << " search (" << efSearch << " candidates)..."
+        << std::endl;
+  }
+  else
+  {
+    switch (SearchMode())
+    {
+      case NAIVE_MODE:
+        Log::Info << "brute-force (naive) search..." << std::endl;
+        break;
+      case SINGLE_TREE_MODE:
+        Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case DUAL_TREE_MODE:
+        Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case GREEDY_SINGLE_TREE_MODE:
+        Log::Info << "greedy single-tree " << TreeName() << " search..."
+            << std::endl;
+        break;
+    }
   }
 
   BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
@@ -569,21 +671,36 @@ void NSModel<SortPolicy>::Search(const size_t k,
 {
   Log::Info << "Searching for " << k << " neighbors with ";
 
-  switch (SearchMode())
+  // The number of candidates of a graph search may have changed since the
+  // graph was built.
+  if (treeType == HNSW)
+    boost::get<HNSWSearch<SortPolicy>*>(nSearch)->EfSearch() = efSearch;
+
+  // The graph is searched the same way in every search mode but the naive
+  // one.
+  if (treeType == HNSW && SearchMode() != NAIVE_MODE)
   {
-    case NAIVE_MODE:
-      Log::Info << "brute-force (naive) search..." << std::endl;
-      break;
-    case SINGLE_TREE_MODE:
-      Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case DUAL_TREE_MODE:
-      Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case GREEDY_SINGLE_TREE_MODE:
-      Log::Info << "greedy single-tree " << TreeName() << " search..."
-          << std::endl;
-      break;
+    Log::Info << TreeName() << " search (" << efSearch << " candidates)..."
+        << std::endl;
+  }
+  else
+  {
+    switch (SearchMode())
+    {
+      case NAIVE_MODE:
+        Log::Info << "brute-force (naive) search..." << std::endl;
+        break;
+      case SINGLE_TREE_MODE:
+        Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case DUAL_TREE_MODE:
+        Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case GREEDY_SINGLE_TREE_MODE:
+        Log::Info << "greedy single-tree " << TreeName() << " search..."
+            << std::endl;
+        break;
+    }
   }
 
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
@@ -594,6 +711,32 @@ void NSModel<SortPolicy>::Search(const size_t k,
   boost::apply_visitor(search, nSearch);
 }
 
+//! Add points to the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(arma::mat&& points)
+{
+  // The new points must be mapped like the reference set.
+  if (randomBasis)
+    points = q * points;
+
+  Log::Info << "Inserting " << points.n_cols << " points into the "
+      << TreeName() << "." << std::endl;
+
+  InsertVisitor<SortPolicy> insert(points);
+  boost::apply_visitor(insert, nSearch);
+}
+
+//! Remove points from the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Remove(const arma::Col<size_t>& indices)
+{
+  Log::Info << "Removing " << indices.n_elem << " points from the "
+      << TreeName() << "." << std::endl;
+
+  RemoveVisitor<SortPolicy> remove(indices);
+  boost::apply_visitor(remove, nSearch);
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
@@ -630,6 +773,8 @@ std::string NSModel<SortPolicy>::TreeName() const
       return "UB tree";
     case OCTREE:
       return "octree";
+    case HNSW:
+      return "HNSW graph";
     default:
       return "unknown tree";
   }
@@ -467,19 +467,25 @@ double RandomForest<
   trees.resize(numTrees); // This will fill the vector with untrained trees.
   double avgGain = 0.0;
 
+  // Global timers would serialize the threads on their lock, so the training
+  // of each tree is timed with thread-local profiler regions.
+  static const size_t bootstrapRegion = Profiler::RegisterRegion("bootstrap");
+  static const size_t trainTreeRegion = Profiler::RegisterRegion("train_tree");
+
   #pragma omp parallel for reduction( + : avgGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    Timer::Start("bootstrap");
     MatType bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
-    Timer::Stop("bootstrap");
+    {
+      ProfileScope bootstrapScope(bootstrapRegion);
+      Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
+          bootstrapLabels, bootstrapWeights);
+    }
 
     // Now build the decision tree.
-    Timer::Start("train_tree");
+    ProfileScope trainTreeScope(trainTreeRegion);
     if (UseWeights)
     {
       if (UseDatasetInfo)
@@ -509,7 +515,6 @@ double RandomForest<
             minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
       }
     }
-    Timer::Stop("train_tree");
   }
   return avgGain / numTrees;
 }
@@ -262,6 +262,40 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Insert the given points into the reference set.  The new points are given
+   * the indices following the last index in use, so the indices of the other
+   * points don't change.  With a RectangleTree, the points are inserted into
+   * the tree; with other trees (and naive search), they are kept aside and
+   * searched by brute force until the tree is next rebuilt.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the points with the given indices from the reference set.  Removed
+   * points are never returned in the results, and their indices are not
+   * reused.  With a RectangleTree, the points are deleted from the tree; with
+   * other trees, they are only marked as removed until the tree is next
+   * rebuilt.
+   *
+   * @param indices Indices of the points to remove.
+   * @throw std::invalid_argument if an index does not belong to a reference
+   *     point or is given more than once; no point is removed in that case.
+   */
+  void Remove(const arma::Col<size_t>& indices);
+
+  /**
+   * Rebuild the reference tree on the current reference points, dropping the
+   * removed points and adding the points inserted since the last build.  This
+   * is done automatically by Insert() and Remove() once the number of pending
+   * updates exceeds RebuildThreshold() times the number of reference points,
+   * and by the Search() overloads that don't take a query set if there are
+   * pending updates.
+   */
+  void Rebuild();
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -281,14 +315,26 @@ class RangeSearch
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
 
-  //! Return the reference set.
+  //! Return the reference set.  After points have been inserted or removed,
+  //! its columns may not match the reference indices; it holds the points of
+  //! the reference tree, including removed points until the next rebuild.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
+  //! Get the number of reference points (not counting removed points).
+  size_t NumReferencePoints() const
+  { return referenceSet->n_cols - numRemoved + insertedSet.n_cols; }
+
+  //! Get the fraction of pending updates that triggers a rebuild.
+  double RebuildThreshold() const { return rebuildThreshold; }
+  //! Modify the fraction of pending updates that triggers a rebuild.
+  double& RebuildThreshold() { return rebuildThreshold; }
+
   //! Return the reference tree (or NULL if in naive mode).
   Tree* ReferenceTree() { return referenceTree; }
 
  private:
-  //! Mappings to old reference indices (used when this object builds trees).
+  //! Mappings to old reference indices (used when this object builds trees);
+  //! after a rebuild, the index of each point of the reference set.
   std::vector<size_t> oldFromNewReferences;
   //! Reference tree.
   Tree* referenceTree;
@@ -312,6 +358,41 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  //! Points inserted since the reference tree was last built.
+  MatType insertedSet;
+  //! Indices of the points of insertedSet.
+  std::vector<size_t> insertedIndices;
+  //! Whether each point of the reference set has been removed (empty if no
+  //! point was removed).
+  std::vector<bool> removedReferences;
+  //! Number of removed points in the reference set.
+  size_t numRemoved;
+  //! Column of each reference index in the reference set (built when a point
+  //! is removed; empty if not needed).
+  std::vector<size_t> newFromOldReferences;
+  //! Number of reference indices in use, including removed points.
+  size_t numReferenceIndices;
+  //! Fraction of pending updates that triggers a rebuild.
+  double rebuildThreshold;
+
+  //! Forget all inserted and removed points, after the reference set has been
+  //! replaced.
+  void ResetUpdates();
+
+  //! Rebuild the reference tree if there are too many pending updates.
+  void RebuildIfNeeded();
+
+  //! Get the column of the given reference index in the reference set, or
+  //! SIZE_MAX if the point is not in the reference set.
+  size_t ReferenceColumn(const size_t index);
+
+  //! Add the inserted points that fall in the range to the results of a
+  //! search.
+  void MergeInserted(const MatType& querySet,
+                     const math::Range& range,
+                     std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
@@ -319,6 +400,27 @@ class RangeSearch
 } // namespace range
 } // namespace mlpack
 
+namespace boost {
+namespace serialization {
+
+//! Set the serialization version of the RangeSearch class (version 1 adds the
+//! inserted and removed points).  BOOST_TEMPLATE_CLASS_VERSION() can't be used
+//! because of the commas in the template signature.
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+struct version<mlpack::range::RangeSearch<MetricType, MatType, TreeType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "range_search_impl.hpp"
 
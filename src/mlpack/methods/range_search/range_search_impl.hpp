@@ -18,6 +18,9 @@
 // The rules for traversal.
 #include "range_search_rules.hpp"
 
+#include <mlpack/core/tree/parallel_single_tree_traversal.hpp>
+#include <mlpack/core/tree/rectangle_tree/is_rectangle_tree.hpp>
+
 namespace mlpack {
 namespace range {
 
@@ -42,6 +45,55 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Insert points into a tree that supports insertion.
+template<typename TreeType, typename MatType>
+bool InsertIntoTree(
+    TreeType& tree,
+    const MatType& points,
+    const typename std::enable_if<
+        tree::IsRectangleTree<TreeType>::value>::type* = 0)
+{
+  const size_t first = tree.Dataset().n_cols;
+  tree.Dataset().insert_cols(first, points);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    tree.InsertPoint(first + i);
+
+  return true;
+}
+
+//! Other trees can't insert points.
+template<typename TreeType, typename MatType>
+bool InsertIntoTree(
+    TreeType& /* tree */,
+    const MatType& /* points */,
+    const typename std::enable_if<
+        !tree::IsRectangleTree<TreeType>::value>::type* = 0)
+{
+  return false;
+}
+
+//! Delete a point from a tree that supports deletion.
+template<typename TreeType>
+void DeleteFromTree(
+    TreeType& tree,
+    const size_t point,
+    const typename std::enable_if<
+        tree::IsRectangleTree<TreeType>::value>::type* = 0)
+{
+  tree.DeletePoint(point);
+}
+
+//! Other trees keep the point (it is only marked as removed).
+template<typename TreeType>
+void DeleteFromTree(
+    TreeType& /* tree */,
+    const size_t /* point */,
+    const typename std::enable_if<
+        !tree::IsRectangleTree<TreeType>::value>::type* = 0)
+{
+  // Nothing to do.
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -61,7 +113,10 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(!naive && singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numRemoved(0),
+    numReferenceIndices(this->referenceSet->n_cols),
+    rebuildThreshold(0.1)
 {
   // Nothing to do.
 }
@@ -82,7 +137,10 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numRemoved(0),
+    numReferenceIndices(this->referenceSet->n_cols),
+    rebuildThreshold(0.1)
 {
   // Nothing else to initialize.
 }
@@ -103,7 +161,10 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    numRemoved(0),
+    numReferenceIndices(this->referenceSet->n_cols),
+    rebuildThreshold(0.1)
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -130,7 +191,14 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     metric(other.metric),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    insertedSet(other.insertedSet),
+    insertedIndices(other.insertedIndices),
+    removedReferences(other.removedReferences),
+    numRemoved(other.numRemoved),
+    newFromOldReferences(other.newFromOldReferences),
+    numReferenceIndices(other.numReferenceIndices),
+    rebuildThreshold(other.rebuildThreshold)
 {
   // Nothing to do.
 }
@@ -149,7 +217,14 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    insertedSet(std::move(other.insertedSet)),
+    insertedIndices(std::move(other.insertedIndices)),
+    removedReferences(std::move(other.removedReferences)),
+    numRemoved(other.numRemoved),
+    newFromOldReferences(std::move(other.newFromOldReferences)),
+    numReferenceIndices(other.numReferenceIndices),
+    rebuildThreshold(other.rebuildThreshold)
 {
   // Clear other object.
   other.referenceSet = new MatType();
@@ -161,6 +236,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
   other.singleMode = false;
   other.baseCases = 0;
   other.scores = 0;
+  other.ResetUpdates();
 }
 
 template<typename MetricType,
@@ -187,6 +263,13 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
+  insertedSet = std::move(other.insertedSet);
+  insertedIndices = std::move(other.insertedIndices);
+  removedReferences = std::move(other.removedReferences);
+  numRemoved = other.numRemoved;
+  newFromOldReferences = std::move(other.newFromOldReferences);
+  numReferenceIndices = other.numReferenceIndices;
+  rebuildThreshold = other.rebuildThreshold;
 
   return *this;
 }
@@ -216,6 +299,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Train(
   if (treeOwner && referenceTree)
     delete referenceTree;
 
+  // The old mappings are not valid anymore (and won't be replaced if the tree
+  // doesn't rearrange the dataset).
+  oldFromNewReferences.clear();
+
   // We may need to rebuild the tree.
   if (!naive)
   {
@@ -240,6 +327,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Train(
   {
     this->referenceSet = new MatType(std::move(referenceSet));
   }
+
+  ResetUpdates();
 }
 
 template<typename MetricType,
@@ -260,6 +349,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Train(
   this->referenceTree = referenceTree;
   this->referenceSet = &referenceTree->Dataset();
   treeOwner = false;
+
+  // The points of the given tree are not mapped.
+  oldFromNewReferences.clear();
+  ResetUpdates();
 }
 
 template<typename MetricType,
@@ -283,9 +376,13 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 
   // If there are no points, there is no search to be done.
-  if (referenceSet->n_cols == 0)
+  if (NumReferencePoints() == 0)
     return;
 
+  // The inserted points can't be searched without a tree to search them with.
+  if (referenceSet->n_cols == 0)
+    Rebuild();
+
   Timer::Start("range_search/computing_neighbors");
 
   // This will hold mappings for query points, if necessary.
@@ -298,21 +395,21 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
   std::vector<std::vector<double>>* distancePtr = &distances;
 
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  // Query indices only need to be mapped if we are building the query tree
+  // ourselves and the tree rearranges points; reference indices need to be
+  // mapped if we have a mapping (because we built a tree that rearranges
+  // points, or because the tree was rebuilt after updates).
+  const bool mapQueries = tree::TreeTraits<Tree>::RearrangesDataset &&
+      !singleMode && !naive;
+  const bool mapReferences = !oldFromNewReferences.empty();
+  if (mapQueries)
   {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<double>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
-
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
+    distancePtr = new std::vector<std::vector<double>>;
+    neighborPtr = new std::vector<std::vector<size_t>>;
+  }
+  else if (mapReferences)
+  {
+    neighborPtr = new std::vector<std::vector<size_t>>;
   }
 
   // Resize each vector.
@@ -328,10 +425,15 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   baseCases = 0;
   scores = 0;
 
+  // Removed points must not be returned.
+  const std::vector<bool>* removed = removedReferences.empty() ? NULL :
+      &removedReferences;
+
   if (naive)
   {
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         metric);
+    rules.RemovedReferences() = removed;
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -342,17 +444,20 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    // The query points are traversed in parallel, each thread with its own
+    // rules.  Cover trees cache distances in their nodes during the traversal,
+    // so they can't be shared between threads.
+    auto createRules = [&]()
+    {
+      RuleType* rules = new RuleType(*referenceSet, querySet, range,
+          *neighborPtr, *distancePtr, metric);
+      rules->RemovedReferences() = removed;
+      return rules;
+    };
+
+    tree::ParallelSingleTreeTraversal<Tree::template SingleTreeTraverser,
+        RuleType>(*referenceTree, querySet.n_cols, createRules, baseCases,
+        scores, !tree::TreeTraits<Tree>::FirstPointIsCentroid);
   }
   else // Dual-tree recursion.
   {
@@ -366,6 +471,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     // Create the traverser.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
         *distancePtr, metric);
+    rules.RemovedReferences() = removed;
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
@@ -380,9 +486,9 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   Timer::Stop("range_search/computing_neighbors");
 
   // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  if (mapQueries || mapReferences)
   {
-    if (!singleMode && !naive && treeOwner)
+    if (mapQueries && mapReferences)
     {
       // We must map both query and reference indices.
       neighbors.clear();
@@ -407,7 +513,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (!singleMode && !naive)
+    else if (mapQueries)
     {
       // We must map query indices only.
       neighbors.clear();
@@ -427,7 +533,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (treeOwner)
+    else
     {
       // We must map reference indices only.
       neighbors.clear();
@@ -444,6 +550,9 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
       delete neighborPtr;
     }
   }
+
+  // The inserted points that are not in the tree yet are searched separately.
+  MergeInserted(querySet, range, neighbors, distances);
 }
 
 template<typename MetricType,
@@ -458,9 +567,13 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     std::vector<std::vector<double>>& distances)
 {
   // If there are no points, there is no search to be done.
-  if (referenceSet->n_cols == 0)
+  if (NumReferencePoints() == 0)
     return;
 
+  // The query tree can't be matched with points outside the reference tree.
+  if (numRemoved > 0 || insertedSet.n_cols > 0)
+    Rebuild();
+
   Timer::Start("range_search/computing_neighbors");
 
   // Get a reference to the query set.
@@ -474,7 +587,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // We won't need to map query indices, but will we need to map distances?
   std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
 
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  if (!oldFromNewReferences.empty())
     neighborPtr = new std::vector<std::vector<size_t>>;
 
   // Resize each vector.
@@ -499,7 +612,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   scores = rules.Scores();
 
   // Do we need to map indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  if (!oldFromNewReferences.empty())
   {
     // We must map reference indices only.
     neighbors.clear();
@@ -528,16 +641,20 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     std::vector<std::vector<double>>& distances)
 {
   // If there are no points, there is no search to be done.
-  if (referenceSet->n_cols == 0)
+  if (NumReferencePoints() == 0)
     return;
 
+  // Every reference point must be in the tree to be used as a query point.
+  if (numRemoved > 0 || insertedSet.n_cols > 0)
+    Rebuild();
+
   Timer::Start("range_search/computing_neighbors");
 
   // Here, we will use the query set as the reference set.
   std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
   std::vector<std::vector<double>>* distancePtr = &distances;
 
-  if (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner)
+  if (!oldFromNewReferences.empty())
   {
     // We will always need to rearrange in this case.
     distancePtr = new std::vector<std::vector<double>>;
@@ -567,15 +684,18 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // The points are traversed in parallel, as in the bichromatic search.
+    auto createRules = [&]()
+    {
+      return new RuleType(*referenceSet, *referenceSet, range, *neighborPtr,
+          *distancePtr, metric, true /* don't return the query */);
+    };
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = 0;
+    scores = 0;
+    tree::ParallelSingleTreeTraversal<Tree::template SingleTreeTraverser,
+        RuleType>(*referenceTree, referenceSet->n_cols, createRules, baseCases,
+        scores, !tree::TreeTraits<Tree>::FirstPointIsCentroid);
   }
   else // Dual-tree recursion.
   {
@@ -590,15 +710,16 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   Timer::Stop("range_search/computing_neighbors");
 
-  // Do we need to map the reference indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  // Do we need to map the reference indices?  After updates, the results of
+  // removed indices are left empty.
+  if (!oldFromNewReferences.empty())
   {
     neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
+    neighbors.resize(numReferenceIndices);
     distances.clear();
-    distances.resize(referenceSet->n_cols);
+    distances.resize(numReferenceIndices);
 
-    for (size_t i = 0; i < distances.size(); i++)
+    for (size_t i = 0; i < referenceSet->n_cols; i++)
     {
       // Map distances (copy a column).
       const size_t refMapping = oldFromNewReferences[i];
@@ -618,6 +739,243 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Insert(const MatType& points)
+{
+  const bool empty = (referenceSet->n_cols == 0 && insertedSet.n_cols == 0);
+  const size_t dimensionality = (referenceSet->n_cols > 0) ?
+      referenceSet->n_rows : insertedSet.n_rows;
+  if (!empty && points.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Insert(): dimensionality of the points ("
+        << points.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Insert the points directly into the tree, if it supports it.  (A tree
+  // built on an empty set doesn't know the dimensionality yet.)
+  const size_t first = referenceSet->n_cols;
+  if (referenceTree && referenceSet->n_cols > 0 &&
+      InsertIntoTree(*referenceTree, points))
+  {
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      if (!oldFromNewReferences.empty())
+        oldFromNewReferences.push_back(numReferenceIndices + i);
+      if (!newFromOldReferences.empty())
+        newFromOldReferences.push_back(first + i);
+      if (!removedReferences.empty())
+        removedReferences.push_back(false);
+    }
+  }
+  else
+  {
+    insertedSet.insert_cols(insertedSet.n_cols, points);
+    for (size_t i = 0; i < points.n_cols; ++i)
+      insertedIndices.push_back(numReferenceIndices + i);
+  }
+
+  numReferenceIndices += points.n_cols;
+  RebuildIfNeeded();
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Remove(
+    const arma::Col<size_t>& indices)
+{
+  // Check all of the indices first, so that nothing is removed if one of them
+  // is invalid.
+  const arma::Col<size_t> sortedIndices = arma::sort(indices);
+  for (size_t i = 0; i < sortedIndices.n_elem; ++i)
+  {
+    const size_t index = sortedIndices[i];
+    if (i > 0 && index == sortedIndices[i - 1])
+    {
+      std::ostringstream oss;
+      oss << "RangeSearch::Remove(): index " << index << " is given more than "
+          << "once!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (std::binary_search(insertedIndices.begin(), insertedIndices.end(),
+        index))
+      continue;
+
+    const size_t column = ReferenceColumn(index);
+    if (column == SIZE_MAX ||
+        (!removedReferences.empty() && removedReferences[column]))
+    {
+      std::ostringstream oss;
+      oss << "RangeSearch::Remove(): there is no reference point with index "
+          << index << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t index = indices[i];
+
+    // The point may not have been added to the tree yet.
+    std::vector<size_t>::iterator it = std::lower_bound(
+        insertedIndices.begin(), insertedIndices.end(), index);
+    if (it != insertedIndices.end() && *it == index)
+    {
+      insertedSet.shed_col(it - insertedIndices.begin());
+      insertedIndices.erase(it);
+      continue;
+    }
+
+    const size_t column = ReferenceColumn(index);
+    if (removedReferences.empty())
+      removedReferences.resize(referenceSet->n_cols, false);
+    removedReferences[column] = true;
+    ++numRemoved;
+
+    if (referenceTree)
+      DeleteFromTree(*referenceTree, column);
+  }
+
+  RebuildIfNeeded();
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Rebuild()
+{
+  // Collect the points that have not been removed, and their indices.
+  const size_t dimensionality = (referenceSet->n_cols > 0) ?
+      referenceSet->n_rows : insertedSet.n_rows;
+  MatType points(dimensionality, NumReferencePoints());
+  std::vector<size_t> indices(points.n_cols);
+  size_t column = 0;
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+  {
+    if (!removedReferences.empty() && removedReferences[i])
+      continue;
+
+    points.col(column) = referenceSet->col(i);
+    indices[column++] = oldFromNewReferences.empty() ? i :
+        oldFromNewReferences[i];
+  }
+  for (size_t i = 0; i < insertedSet.n_cols; ++i)
+  {
+    points.col(column) = insertedSet.col(i);
+    indices[column++] = insertedIndices[i];
+  }
+
+  // Training forgets the indices in use; they must not be reused.
+  const size_t numIndices = numReferenceIndices;
+  Train(std::move(points));
+  numReferenceIndices = numIndices;
+
+  // Map the columns of the new reference set to the indices.
+  if (oldFromNewReferences.empty())
+  {
+    oldFromNewReferences = std::move(indices);
+  }
+  else
+  {
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      oldFromNewReferences[i] = indices[oldFromNewReferences[i]];
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::ResetUpdates()
+{
+  insertedSet.reset();
+  insertedIndices.clear();
+  removedReferences.clear();
+  numRemoved = 0;
+  newFromOldReferences.clear();
+  numReferenceIndices = referenceSet->n_cols;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::RebuildIfNeeded()
+{
+  const size_t pending = insertedSet.n_cols + numRemoved;
+  if (pending > rebuildThreshold * NumReferencePoints())
+    Rebuild();
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t RangeSearch<MetricType, MatType, TreeType>::ReferenceColumn(
+    const size_t index)
+{
+  if (oldFromNewReferences.empty())
+    return (index < referenceSet->n_cols) ? index : SIZE_MAX;
+
+  // Build the inverse mapping, if we don't have it yet.
+  if (newFromOldReferences.empty())
+  {
+    newFromOldReferences.resize(numReferenceIndices, SIZE_MAX);
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      newFromOldReferences[oldFromNewReferences[i]] = i;
+  }
+
+  return (index < newFromOldReferences.size()) ?
+      newFromOldReferences[index] : SIZE_MAX;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::MergeInserted(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  if (insertedSet.n_cols == 0)
+    return;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < insertedSet.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(querySet.col(i),
+          insertedSet.col(j));
+      if (range.Contains(distance))
+      {
+        neighbors[i].push_back(insertedIndices[j]);
+        distances[i].push_back(distance);
+      }
+    }
+  }
+
+  baseCases += querySet.n_cols * insertedSet.n_cols;
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -626,7 +984,7 @@ template<typename MetricType,
 template<typename Archive>
 void RangeSearch<MetricType, MatType, TreeType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
   // Serialize preferences for search.
   ar & BOOST_SERIALIZATION_NVP(naive);
@@ -662,6 +1020,10 @@ void RangeSearch<MetricType, MatType, TreeType>::serialize(
       oldFromNewReferences.clear();
       treeOwner = false;
     }
+
+    // After a rebuild, the points of a naive model are mapped too.
+    if (version >= 1)
+      ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
   }
   else
   {
@@ -686,6 +1048,25 @@ void RangeSearch<MetricType, MatType, TreeType>::serialize(
       metric = referenceTree->Metric(); // Get the metric from the tree.
     }
   }
+
+  // Serialize the points inserted or removed since the tree was built.
+  if (version >= 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(insertedSet);
+    ar & BOOST_SERIALIZATION_NVP(insertedIndices);
+    ar & BOOST_SERIALIZATION_NVP(removedReferences);
+    ar & BOOST_SERIALIZATION_NVP(numRemoved);
+    ar & BOOST_SERIALIZATION_NVP(numReferenceIndices);
+    ar & BOOST_SERIALIZATION_NVP(rebuildThreshold);
+  }
+  else if (Archive::is_loading::value)
+  {
+    ResetUpdates();
+  }
+
+  // The inverse mapping is rebuilt when needed.
+  if (Archive::is_loading::value)
+    newFromOldReferences.clear();
 }
 
 } // namespace range
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/distance_block.hpp>
 
 namespace mlpack {
 namespace range {
@@ -57,6 +58,21 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the given query points and a range of
+   * reference points (the points of a leaf), with the same results as calling
+   * BaseCase() for each pair.  For the Euclidean distance, all the distances
+   * are computed with one matrix product, and only the reference points that
+   * may be in the range get their exact distance computed.
+   *
+   * @param queryIndices Indices of the query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -117,6 +133,13 @@ class RangeSearchRules
   //! Get the number of scores (that is, calls to RangeDistance()).
   size_t Scores() const { return scores; }
 
+  //! Get the mask of removed reference points (NULL if there are none).
+  const std::vector<bool>* RemovedReferences() const
+  { return removedReferences; }
+  //! Modify the mask of removed reference points; removed points are never
+  //! returned in the results.
+  const std::vector<bool>*& RemovedReferences() { return removedReferences; }
+
  private:
   //! The reference set.
   const arma::mat& referenceSet;
@@ -156,6 +179,18 @@ class RangeSearchRules
   size_t baseCases;
   //! THe number of scores.
   size_t scores;
+
+  //! Mask of removed reference points, or NULL.
+  const std::vector<bool>* removedReferences;
+
+  //! Return whether the given reference point has been removed.
+  bool IsRemoved(const size_t referenceIndex) const
+  { return removedReferences && (*removedReferences)[referenceIndex]; }
+
+  //! Computes the distances of the blocked base cases.
+  metric::DistanceBlock<MetricType> distanceBlock;
+  //! The distances of the last blocked base case.
+  arma::mat blockDistances;
 };
 
 } // namespace range
@@ -37,7 +37,9 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    removedReferences(NULL),
+    distanceBlock(metric, querySet, referenceSet)
 {
   // Nothing to do.
 }
@@ -66,7 +68,7 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastQueryIndex = queryIndex;
   lastReferenceIndex = referenceIndex;
 
-  if (range.Contains(distance))
+  if (range.Contains(distance) && !IsRemoved(referenceIndex))
   {
     neighbors[queryIndex].push_back(referenceIndex);
     distances[queryIndex].push_back(distance);
@@ -75,6 +77,59 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlock(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  // Without a matrix product, there is nothing to gain over BaseCase().
+  if (!metric::DistanceBlock<MetricType>::UsesProduct)
+  {
+    for (size_t j = 0; j < queryIndices.size(); ++j)
+      for (size_t i = 0; i < referenceCount; ++i)
+        BaseCase(queryIndices[j], referenceBegin + i);
+    return;
+  }
+
+  const double error = distanceBlock.Evaluate(queryIndices, referenceBegin,
+      referenceCount, blockDistances);
+
+  for (size_t j = 0; j < queryIndices.size(); ++j)
+  {
+    const size_t queryIndex = queryIndices[j];
+    const double* blockColumn = blockDistances.colptr(j);
+    for (size_t i = 0; i < referenceCount; ++i)
+    {
+      const size_t referenceIndex = referenceBegin + i;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+
+      // Most points are out of the range even with the largest error; the
+      // others need their exact distance.
+      if (blockColumn[i] + error < range.Lo() ||
+          blockColumn[i] - error > range.Hi() ||
+          IsRemoved(referenceIndex))
+        continue;
+
+      const double distance = metric.Evaluate(
+          querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex));
+      if (range.Contains(distance))
+      {
+        neighbors[queryIndex].push_back(referenceIndex);
+        distances[queryIndex].push_back(distance);
+      }
+    }
+  }
+
+  // The last pair of BaseCase() may not have been computed exactly.
+  lastQueryIndex = querySet.n_cols;
+  lastReferenceIndex = referenceSet.n_cols;
+}
+
 //! Single-tree scoring function.
 template<typename MetricType, typename TreeType>
 double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
@@ -250,6 +305,8 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     if ((&referenceSet == &querySet) &&
         (queryIndex == referenceNode.Descendant(i)))
       continue;
+    if (IsRemoved(referenceNode.Descendant(i)))
+      continue;
 
     const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
         referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
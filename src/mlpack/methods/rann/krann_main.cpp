@@ -18,6 +18,8 @@
 #include "ra_model.hpp"
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 
+#include <chrono>
+
 using namespace std;
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -62,7 +64,17 @@ PROGRAM_INFO("K-Rank-Approximate-Nearest-Neighbors (kRANN)",
     "neighbors output file corresponds to the index of the point in the "
     "reference set which is the i'th nearest neighbor from the point in the "
     "query set with index j.  Row i and column j in the distances output file "
-    "corresponds to the distance between those two points.",
+    "corresponds to the distance between those two points."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("target_recall") + " is specified, the "
+    "sampling parameters (" + PRINT_PARAM_STRING("sample_at_leaves") + ", " +
+    PRINT_PARAM_STRING("first_leaf_exact") + " and " +
+    PRINT_PARAM_STRING("single_sample_limit") + ") are tuned before the "
+    "search: " + PRINT_PARAM_STRING("tuning_set_size") + " points of the "
+    "reference set are searched with each combination of parameters, and the "
+    "fastest combination for which the average fraction of returned neighbors "
+    "that are among the true k nearest neighbors is at least the target is "
+    "used.  The tuned parameters are also saved in the output model.",
     SEE_ALSO("@knn", "#knn"),
     SEE_ALSO("@lsh", "#lsh"),
     SEE_ALSO("Rank-approximate nearest neighbor search: Retaining meaning and "
@@ -113,6 +125,128 @@ PARAM_FLAG("first_leaf_exact", "The flag to trigger sampling only after "
 PARAM_INT_IN("single_sample_limit", "The limit on the maximum number of "
     "samples (and hence the largest node you can approximate).", "z", 20);
 
+// Tuning options.
+PARAM_DOUBLE_IN("target_recall", "If specified, tune the sampling parameters "
+    "to find the fastest search with at least this recall (between 0 and 1).",
+    "g", 0.0);
+PARAM_INT_IN("tuning_set_size", "Maximum number of reference points used to "
+    "tune the sampling parameters.", "u", 100);
+
+/**
+ * Find the fastest combination of sampling parameters (sample at leaves, first
+ * leaf exact, and single sample limit) whose recall on a set of reference
+ * points reaches the target, and set it in the model.  The recall of a point is
+ * the fraction of the returned neighbors that are not further than its true
+ * k'th nearest neighbor.  If no combination reaches the target, the one with
+ * the best recall is used.
+ */
+static void TuneSearchParameters(RANNModel& rann,
+                                 const size_t k,
+                                 const size_t tuningSetSize,
+                                 const double targetRecall)
+{
+  const arma::mat& referenceSet = rann.Dataset();
+  arma::uvec samples;
+  math::ObtainDistinctSamples(0, referenceSet.n_cols, tuningSetSize, samples);
+  const arma::mat tuningSet = referenceSet.cols(samples);
+
+  // Find the distance to the true k'th nearest neighbor of each point by brute
+  // force.
+  arma::vec kthDistances(tuningSet.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) tuningSet.n_cols; ++i)
+  {
+    std::vector<double> pointDistances(referenceSet.n_cols);
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    {
+      pointDistances[j] = EuclideanDistance::Evaluate(tuningSet.col(i),
+          referenceSet.col(j));
+    }
+
+    std::nth_element(pointDistances.begin(), pointDistances.begin() + k - 1,
+        pointDistances.end());
+    kthDistances[i] = pointDistances[k - 1];
+  }
+
+  // The tuning points are already in the (possibly projected) space of the
+  // model.
+  const bool randomBasis = rann.RandomBasis();
+  rann.RandomBasis() = false;
+
+  const size_t singleSampleLimits[] = { 5, 10, 20, 50, 100 };
+  bool found = false;
+  double bestTime = DBL_MAX;
+  double bestRecall = -1.0;
+  bool bestSampleAtLeaves = rann.SampleAtLeaves();
+  bool bestFirstLeafExact = rann.FirstLeafExact();
+  size_t bestSingleSampleLimit = rann.SingleSampleLimit();
+  for (size_t s = 0; s < 4; ++s)
+  {
+    for (const size_t singleSampleLimit : singleSampleLimits)
+    {
+      rann.SampleAtLeaves() = ((s & 1) != 0);
+      rann.FirstLeafExact() = ((s & 2) != 0);
+      rann.SingleSampleLimit() = singleSampleLimit;
+
+      arma::mat querySet(tuningSet);
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      rann.Search(std::move(querySet), k, neighbors, distances);
+      const double time = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+
+      size_t numFound = 0;
+      for (size_t i = 0; i < distances.n_cols; ++i)
+      {
+        for (size_t j = 0; j < k; ++j)
+        {
+          if (distances(j, i) <= kthDistances[i] * (1.0 + 1e-10))
+            ++numFound;
+        }
+      }
+      const double recall = (double) numFound / (double) distances.n_elem;
+
+      Log::Info << "Sample at leaves: "
+          << (rann.SampleAtLeaves() ? "yes" : "no") << ", first leaf exact: "
+          << (rann.FirstLeafExact() ? "yes" : "no") << ", single sample limit: "
+          << singleSampleLimit << "; recall " << recall << ", " << time << "s."
+          << endl;
+
+      // A combination that reaches the target is better than any that doesn't.
+      const bool reached = (recall >= targetRecall);
+      if ((reached && (!found || time < bestTime)) ||
+          (!reached && !found && recall > bestRecall))
+      {
+        found = reached;
+        bestTime = time;
+        bestRecall = recall;
+        bestSampleAtLeaves = rann.SampleAtLeaves();
+        bestFirstLeafExact = rann.FirstLeafExact();
+        bestSingleSampleLimit = singleSampleLimit;
+      }
+    }
+  }
+
+  if (!found)
+  {
+    Log::Warn << "No sampling parameters reach the target recall "
+        << targetRecall << "; using the parameters with the best recall ("
+        << bestRecall << ")." << endl;
+  }
+
+  rann.RandomBasis() = randomBasis;
+  rann.SampleAtLeaves() = bestSampleAtLeaves;
+  rann.FirstLeafExact() = bestFirstLeafExact;
+  rann.SingleSampleLimit() = bestSingleSampleLimit;
+
+  Log::Info << "Tuned sampling parameters: sample at leaves: "
+      << (bestSampleAtLeaves ? "yes" : "no") << ", first leaf exact: "
+      << (bestFirstLeafExact ? "yes" : "no") << ", single sample limit: "
+      << bestSingleSampleLimit << "." << endl;
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -146,6 +280,19 @@ static void mlpackMain()
   // Naive mode overrides single mode.
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
 
+  // Tuning needs a search, and naive search doesn't use the tuned parameters.
+  ReportIgnoredParam({{ "k", false }}, "target_recall");
+  ReportIgnoredParam({{ "naive", true }}, "target_recall");
+  ReportIgnoredParam({{ "target_recall", false }}, "tuning_set_size");
+  if (CLI::HasParam("target_recall"))
+  {
+    RequireParamValue<double>("target_recall", [](double x)
+        { return x > 0.0 && x <= 1.0; }, true,
+        "target recall must be in (0, 1]");
+    RequireParamValue<int>("tuning_set_size", [](int x) { return x > 0; },
+        true, "tuning set size must be greater than 0");
+  }
+
   // Sanity check on leaf size.
   const int lsInt = CLI::GetParam<int>("leaf_size");
   RequireParamValue<int>("leaf_size", [](int x) { return x > 0; }, true,
@@ -224,7 +371,7 @@ static void mlpackMain()
   if (CLI::HasParam("single_sample_limit"))
     rann->SingleSampleLimit() = CLI::GetParam<double>("single_sample_limit");
   rann->SampleAtLeaves() = CLI::HasParam("sample_at_leaves");
-  rann->FirstLeafExact() = CLI::HasParam("sample_at_leaves");
+  rann->FirstLeafExact() = CLI::HasParam("first_leaf_exact");
 
   // Perform search, if desired.
   if (CLI::HasParam("k"))
@@ -250,6 +397,13 @@ static void mlpackMain()
       Log::Fatal << rann->Dataset().n_cols << ")." << endl;
     }
 
+    if (CLI::HasParam("target_recall") && !rann->Naive() && k > 0)
+    {
+      TuneSearchParameters(*rann, k,
+          (size_t) CLI::GetParam<int>("tuning_set_size"),
+          CLI::GetParam<double>("target_recall"));
+    }
+
     arma::Mat<size_t> neighbors;
     arma::mat distances;
     if (CLI::HasParam("query"))
@@ -391,6 +391,41 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Traverse the reference tree for each query point, in parallel.  The query
+   * points are split into blocks, and each block is traversed with its own
+   * rules object that shares the results with the given rules and samples from
+   * its own random stream.
+   *
+   * @param rules Rules object that holds the results.
+   * @param numQueries Number of query points.
+   * @return The number of distance computations.
+   */
+  template<typename RuleType>
+  size_t SingleTreeSearch(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Traverse the given query tree and the reference tree, in parallel.  The
+   * query tree is split into disjoint subtrees, and each subtree is traversed
+   * with its own rules object that shares the results with the given rules and
+   * samples from its own random stream.
+   *
+   * @param rules Rules object that holds the results.
+   * @param queryTree Query tree to traverse.
+   * @return The number of distance computations.
+   */
+  template<typename RuleType>
+  size_t DualTreeSearch(RuleType& rules, Tree* queryTree);
+
+  /**
+   * Split the given query tree into disjoint subtrees, which are used as the
+   * query nodes of parallel dual-tree traversals.
+   *
+   * @param queryTree Query tree to split.
+   * @param queryNodes Vector to store the subtrees in.
+   */
+  static void GetQueryNodes(Tree* queryTree, std::vector<Tree*>& queryNodes);
+
   //! For access to mappings when building models.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -17,6 +17,10 @@
 
 #include "ra_search_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace neighbor {
 
@@ -323,17 +327,12 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      const size_t numDistComputations = SingleTreeSearch(rules,
+          querySet.n_cols);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
-          << (rules.NumDistComputations() / querySet.n_cols) << "."
-          << std::endl;
+          << (numDistComputations / querySet.n_cols) << "." << std::endl;
     }
 
     rules.GetResults(*neighborPtr, *distancePtr);
@@ -352,16 +351,15 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    const size_t numDistComputations = DualTreeSearch(rules, queryTree);
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
-        << (rules.NumDistComputations() / querySet.n_cols) << "." << std::endl;
+        << (numDistComputations / querySet.n_cols) << "." << std::endl;
 
     rules.GetResults(*neighborPtr, *distancePtr);
 
@@ -466,9 +464,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeSearch(rules, queryTree);
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -539,19 +535,11 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeSearch(rules, referenceSet->n_cols);
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeSearch(rules, referenceTree);
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
@@ -581,6 +569,131 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+size_t RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeSearch(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  // Each block samples from the random stream given by its index, so the
+  // results only depend on the random seed and not on the number of threads.
+  const size_t queryBlockSize = 64;
+  const size_t numQueryBlocks = (numQueries + queryBlockSize - 1) /
+      queryBlockSize;
+
+  size_t numDistComputations = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:numDistComputations)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    RuleType blockRules(rules, (size_t) b + 1);
+    typename Tree::template SingleTreeTraverser<RuleType>
+        traverser(blockRules);
+
+    const size_t queryBegin = (size_t) b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize, numQueries);
+    for (size_t i = queryBegin; i < queryEnd; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    numDistComputations += blockRules.NumDistComputations();
+  }
+
+  return numDistComputations;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+size_t RASearch<SortPolicy, MetricType, MatType, TreeType>::DualTreeSearch(
+    RuleType& rules,
+    Tree* queryTree)
+{
+  // The subtrees are disjoint, so the rules of each traversal only modify the
+  // statistics and the results of their own query points; the reference tree is
+  // not modified by the traversals.  The split depends on the number of
+  // threads, so (unlike single-tree search) the results are only reproducible
+  // for a fixed number of threads.
+  std::vector<Tree*> queryNodes;
+  GetQueryNodes(queryTree, queryNodes);
+
+  size_t numDistComputations = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:numDistComputations)
+  for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+  {
+    RuleType nodeRules(rules, (size_t) i + 1);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(nodeRules);
+
+    traverser.Traverse(*queryNodes[i], *referenceTree);
+
+    numDistComputations += nodeRules.NumDistComputations();
+  }
+
+  return numDistComputations;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::GetQueryNodes(
+    Tree* queryTree,
+    std::vector<Tree*>& queryNodes)
+{
+  queryNodes.clear();
+  queryNodes.push_back(queryTree);
+
+  // Each point must belong to only one subtree, so a node can only be
+  // replaced by its children if its own points are also held by them.
+  if (tree::TreeTraits<Tree>::HasDuplicatedPoints)
+    return;
+
+  #ifdef HAS_OPENMP
+  const size_t targetNodes = 8 * omp_get_max_threads();
+  #else
+  const size_t targetNodes = 1;
+  #endif
+
+  // Expand the largest nodes first, so that the subtrees have similar sizes.
+  bool expanded = true;
+  while (queryNodes.size() < targetNodes && expanded)
+  {
+    expanded = false;
+    size_t largest = 0;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      Tree* node = queryNodes[i];
+      if (node->NumChildren() > 0 && (node->NumPoints() == 0 ||
+          tree::TreeTraits<Tree>::HasSelfChildren) &&
+          (!expanded || node->NumDescendants() >
+              queryNodes[largest]->NumDescendants()))
+      {
+        largest = i;
+        expanded = true;
+      }
+    }
+
+    if (expanded)
+    {
+      Tree* node = queryNodes[largest];
+      queryNodes[largest] = &node->Child(0);
+      for (size_t i = 1; i < node->NumChildren(); ++i)
+        queryNodes.push_back(&node->Child(i));
+    }
+  }
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -66,6 +66,21 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct a RASearchRules object that shares the candidate lists and the
+   * sample counts of the given one, but has its own traversal state and draws
+   * its samples from its own random stream.  This is used for parallel search,
+   * where each traversal works on a disjoint set of query points.  The stream
+   * only depends on the given object and the stream index, so the results don't
+   * depend on which thread runs the traversal.  The given object must outlive
+   * this one.
+   *
+   * @param other Rules object to share the candidates of.
+   * @param stream Index of the random stream of the new object (it should be
+   *     different for every object sharing the same candidates, and nonzero).
+   */
+  RASearchRules(RASearchRules& other, const size_t stream);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -263,8 +278,11 @@ class RASearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point, if this object owns them.
+  std::vector<CandidateList> ownCandidates;
+  //! Set of candidate neighbors for each point (possibly shared with other
+  //! rules).
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -284,7 +302,8 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
-  //! The number of samples made for every query.
+  //! The number of samples made for every query.  This may be an alias of the
+  //! sample counts of another rules object.
   arma::Col<size_t> numSamplesMade;
 
   //! The sampling ratio.
@@ -296,6 +315,9 @@ class RASearchRules
   //! If the query and reference set are identical, this is true.
   bool sameSet;
 
+  //! The random stream the samples are drawn from.
+  math::RandomStream rng;
+
   TraversalInfoType traversalInfo;
 
   /**
@@ -33,6 +33,7 @@ RASearchRules(const arma::mat& referenceSet,
               const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(ownCandidates),
     k(k),
     metric(metric),
     sampleAtLeaves(sampleAtLeaves),
@@ -40,6 +41,12 @@ RASearchRules(const arma::mat& referenceSet,
     singleSampleLimit(singleSampleLimit),
     sameSet(sameSet)
 {
+  // Take the key of our random stream from the stream of the calling thread, so
+  // that every search draws different samples.
+  const uint64_t seed = (uint64_t(math::ThreadRandGen()()) << 32) |
+      math::ThreadRandGen()();
+  rng.Seed(seed);
+
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
 
@@ -90,13 +97,35 @@ RASearchRules(const arma::mat& referenceSet,
     arma::uvec distinctSamples;
     for (size_t i = 0; i < querySet.n_cols; ++i)
     {
-      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
+      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples, rng);
       for (size_t j = 0; j < distinctSamples.n_elem; j++)
         BaseCase(i, (size_t) distinctSamples[j]);
     }
   }
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+RASearchRules<SortPolicy, MetricType, TreeType>::
+RASearchRules(RASearchRules& other, const size_t stream) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(other.metric),
+    sampleAtLeaves(other.sampleAtLeaves),
+    firstLeafExact(other.firstLeafExact),
+    singleSampleLimit(other.singleSampleLimit),
+    numSamplesReqd(other.numSamplesReqd),
+    numSamplesMade(other.numSamplesMade.memptr(), other.numSamplesMade.n_elem,
+        false, true),
+    samplingRatio(other.samplingRatio),
+    numDistComputations(0),
+    sameSet(other.sameSet),
+    rng(other.rng.Seed(), (uint64_t) stream)
+{
+  // Nothing to do.
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -205,7 +234,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           // Hence, approximate the node by sampling enough number of points.
           arma::uvec distinctSamples;
           math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
+              samplesReqd, distinctSamples, rng);
           for (size_t i = 0; i < distinctSamples.n_elem; i++)
             // The counting of the samples are done in the 'BaseCase' function
             // so no book-keeping is required here.
@@ -221,7 +250,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
             // Approximate node by sampling enough number of points.
             arma::uvec distinctSamples;
             math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
+                samplesReqd, distinctSamples, rng);
             for (size_t i = 0; i < distinctSamples.n_elem; i++)
               // The counting of the samples are done in the 'BaseCase' function
               // so no book-keeping is required here.
@@ -309,7 +338,7 @@ Rescore(const size_t queryIndex,
         // by sampling enough number of points.
         arma::uvec distinctSamples;
         math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-            samplesReqd, distinctSamples);
+            samplesReqd, distinctSamples, rng);
         for (size_t i = 0; i < distinctSamples.n_elem; i++)
           // The counting of the samples are done in the 'BaseCase' function so
           // no book-keeping is required here.
@@ -325,7 +354,7 @@ Rescore(const size_t queryIndex,
           // Approximate node by sampling enough points.
           arma::uvec distinctSamples;
           math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
+              samplesReqd, distinctSamples, rng);
           for (size_t i = 0; i < distinctSamples.n_elem; i++)
             // The counting of the samples are done in the 'BaseCase' function
             // so no book-keeping is required here.
@@ -512,7 +541,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             const size_t queryIndex = queryNode.Descendant(i);
             math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
+                samplesReqd, distinctSamples, rng);
             for (size_t j = 0; j < distinctSamples.n_elem; j++)
               // The counting of the samples are done in the 'BaseCase' function
               // so no book-keeping is required here.
@@ -542,7 +571,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
             {
               const size_t queryIndex = queryNode.Descendant(i);
               math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                  samplesReqd, distinctSamples);
+                  samplesReqd, distinctSamples, rng);
               for (size_t j = 0; j < distinctSamples.n_elem; j++)
                 // The counting of the samples are done in the 'BaseCase'
                 // function so no book-keeping is required here.
@@ -717,7 +746,7 @@ Rescore(TreeType& queryNode,
         {
           const size_t queryIndex = queryNode.Descendant(i);
           math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
+              samplesReqd, distinctSamples, rng);
           for (size_t j = 0; j < distinctSamples.n_elem; j++)
             // The counting of the samples are done in the 'BaseCase'
             // function so no book-keeping is required here.
@@ -746,7 +775,7 @@ Rescore(TreeType& queryNode,
           {
             const size_t queryIndex = queryNode.Descendant(i);
             math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
+                samplesReqd, distinctSamples, rng);
             for (size_t j = 0; j < distinctSamples.n_elem; j++)
               // The counting of the samples are done in BaseCase() so no
               // book-keeping is required here.
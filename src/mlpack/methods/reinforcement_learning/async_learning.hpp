@@ -41,6 +41,14 @@ namespace rl {
  * }
  * @endcode
  *
+ * The workers run without locks: each thread claims a free worker with an
+ * atomic flag and steps it, and the workers apply their gradients to the
+ * shared learning network in place (Hogwild-style, so concurrent updates may
+ * interleave).  The target network is periodically published as an immutable
+ * copy of the learning network; each worker keeps its own copy of the latest
+ * published one (see TargetNetwork) and picks up a new one at its next
+ * update, so that publishing never blocks the other workers.
+ *
  * @tparam WorkerType The type of the worker.
  * @tparam EnvironmentType The type of reinforcement learning task.
  * @tparam NetworkType The type of the network model.
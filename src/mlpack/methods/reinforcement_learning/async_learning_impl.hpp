@@ -14,7 +14,9 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+
+#include <atomic>
+#include <memory>
 
 namespace mlpack {
 namespace rl {
@@ -68,10 +70,11 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  std::shared_ptr<const NetworkType> targetNetwork(
+      new NetworkType(learningNetwork));
+  std::atomic<size_t> totalSteps(0);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -80,10 +83,14 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
+  const size_t numWorkers = workers.size();
+
+  // A worker is claimed by a thread for one step by setting its flag, so that
+  // no worker is stepped by two threads at once; this replaces a task queue
+  // under a lock.
+  std::vector<std::atomic<bool>> busy(numWorkers);
+  for (size_t i = 0; i < numWorkers; ++i)
+    busy[i] = false;
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -95,9 +102,9 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
+  #pragma omp parallel for shared(stop, workers, busy, learningNetwork, \
       targetNetwork, totalSteps, policy)
-  for (omp_size_t i = 0; i < numThreads; ++i)
+  for (omp_size_t i = 0; i < (omp_size_t) numThreads; ++i)
   {
     #pragma omp critical
     {
@@ -106,34 +113,27 @@ void AsyncLearning<
             " started." << std::endl;
       #endif
     }
-    size_t task = std::numeric_limits<size_t>::max();
+
+    // Each thread walks over the workers from a different starting point, and
+    // steps every worker that is not claimed by another thread.
+    size_t task = (size_t) i % numWorkers;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
+      if (!busy[task].exchange(true, std::memory_order_acquire))
       {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
+        // Get corresponding worker.
+        WorkerType& worker = workers[task];
+        double episodeReturn;
+        if (worker.Step(learningNetwork, targetNetwork, totalSteps,
+            policy, episodeReturn) && !task)
         {
-          task = tasks.front();
-          tasks.pop();
+          stop = measure(episodeReturn);
         }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
 
-      // Get corresponding worker.
-      WorkerType& worker = workers[task];
-      double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
-      {
-        stop = measure(episodeReturn);
+        busy[task].store(false, std::memory_order_release);
       }
+
+      task = (task + 1) % numWorkers;
     }
   }
 
@@ -0,0 +1,199 @@
+/**
+ * @file vectorized_environment.hpp
+ *
+ * Wrapper that steps several copies of an RL environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTORIZED_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTORIZED_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A vectorized environment holds several independent copies of an environment
+ * (for instance CartPole, MountainCar, Acrobot or Pendulum), each with its own
+ * current state, and advances all of them at once given one action per copy.
+ * The current states of all copies are kept encoded as the columns of one
+ * matrix, so that an agent can select the actions of all copies with a single
+ * batched forward pass of its network.
+ *
+ * When a copy reaches a terminal state (or the step limit), its episode is
+ * finished: the return of the episode is recorded, and the copy is restarted
+ * from a new initial state.  The transition that finished the episode is still
+ * reported by Step().
+ *
+ * @tparam EnvironmentType The environment to vectorize.
+ */
+template <typename EnvironmentType>
+class VectorizedEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using State = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment, and start an
+   * episode in each of them.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @param environment Environment to copy.
+   * @param stepLimit Maximum number of steps of an episode (0 means no limit).
+   */
+  VectorizedEnvironment(const size_t numEnvironments,
+                        const EnvironmentType& environment = EnvironmentType(),
+                        const size_t stepLimit = 0) :
+      environments(numEnvironments, environment),
+      states(numEnvironments),
+      steps(numEnvironments, 0),
+      returns(numEnvironments, 0.0),
+      stepLimit(stepLimit)
+  {
+    if (numEnvironments == 0)
+    {
+      throw std::invalid_argument("VectorizedEnvironment::"
+          "VectorizedEnvironment(): number of environments must be positive!");
+    }
+
+    Reset();
+  }
+
+  /**
+   * Start a new episode in every copy of the environment.  The returns of the
+   * episodes in progress are discarded.
+   */
+  void Reset()
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+      Restart(i);
+  }
+
+  /**
+   * Take one step in every copy of the environment.  After the call, column i
+   * of each output (element i for vectors) describes the transition of copy i.
+   * Copies whose episode finished with this step are restarted, so the next
+   * states are not necessarily the current states afterwards.
+   *
+   * A transition is marked as terminal only if the next state is a terminal
+   * state of the environment; an episode cut by the step limit is not.
+   *
+   * @param actions Action to take in each copy.
+   * @param encodedStates Will hold the encoded states before the step.
+   * @param rewards Will hold the rewards of the step.
+   * @param encodedNextStates Will hold the encoded states after the step.
+   * @param isTerminal Will indicate whether each next state is terminal.
+   */
+  void Step(const std::vector<Action>& actions,
+            arma::mat& encodedStates,
+            arma::colvec& rewards,
+            arma::mat& encodedNextStates,
+            arma::icolvec& isTerminal)
+  {
+    if (actions.size() != environments.size())
+    {
+      std::ostringstream oss;
+      oss << "VectorizedEnvironment::Step(): expected " << environments.size()
+          << " actions, but " << actions.size() << " were given!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    encodedStates = this->encodedStates;
+    encodedNextStates.set_size(this->encodedStates.n_rows, environments.size());
+    rewards.set_size(environments.size());
+    isTerminal.set_size(environments.size());
+
+    State nextState;
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i], nextState);
+      isTerminal[i] = environments[i].IsTerminal(nextState);
+      encodedNextStates.col(i) = nextState.Encode();
+
+      returns[i] += rewards[i];
+      ++steps[i];
+      if (isTerminal[i] || (stepLimit != 0 && steps[i] >= stepLimit))
+      {
+        episodeReturns.push_back(returns[i]);
+        Restart(i);
+      }
+      else
+      {
+        states[i] = nextState;
+        this->encodedStates.col(i) = nextState.Encode();
+      }
+    }
+  }
+
+  //! Get the number of copies of the environment.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the current states of the copies, encoded as columns.
+  const arma::mat& EncodedStates() const { return encodedStates; }
+
+  //! Get the current state of the given copy.
+  const State& CurrentState(const size_t i) const { return states[i]; }
+
+  //! Get the given copy of the environment.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given copy of the environment.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+  //! Get the maximum number of steps of an episode (0 means no limit).
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of an episode (0 means no limit).
+  size_t& StepLimit() { return stepLimit; }
+
+  //! Get the returns of the finished episodes, in order of completion.
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+  //! Modify the returns of the finished episodes (e.g. to clear them).
+  std::vector<double>& EpisodeReturns() { return episodeReturns; }
+
+ private:
+  //! Start a new episode in the given copy.
+  void Restart(const size_t i)
+  {
+    states[i] = environments[i].InitialSample();
+    const auto& encoded = states[i].Encode();
+    if (encodedStates.n_cols != environments.size())
+      encodedStates.set_size(encoded.n_elem, environments.size());
+    encodedStates.col(i) = encoded;
+    steps[i] = 0;
+    returns[i] = 0.0;
+  }
+
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each copy.
+  std::vector<State> states;
+
+  //! The current states of the copies, encoded as columns.
+  arma::mat encodedStates;
+
+  //! The number of steps of the current episode of each copy.
+  std::vector<size_t> steps;
+
+  //! The return of the current episode of each copy.
+  std::vector<double> returns;
+
+  //! The returns of the finished episodes.
+  std::vector<double> episodeReturns;
+
+  //! Maximum number of steps of an episode.
+  size_t stepLimit;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "environment/vectorized_environment.hpp"
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
@@ -90,6 +91,21 @@ class QLearning
    */
   double Step();
 
+  /**
+   * Execute a step in every copy of the given vectorized environment at once.
+   * The actions of all copies are selected with one batched forward pass of
+   * the learning network, and all the transitions are stored for replay
+   * together.  Unlike Step(), this also counts the steps, anneals the policy
+   * and syncs the target network; the learning network is trained once per
+   * call (instead of once per transition), so sampling throughput grows with
+   * the number of copies.  Finished episodes are restarted automatically, and
+   * their returns are recorded by the vectorized environment.
+   *
+   * @param environments Copies of the reinforcement learning task.
+   * @return Total reward of the step over all copies.
+   */
+  double Step(VectorizedEnvironment<EnvironmentType>& environments);
+
   /**
    * Execute an episode.
    * @return Return of the episode.
@@ -129,6 +145,12 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Sample a batch of transitions from the replay memory and update the
+   * learning network with it.
+   */
+  void TrainAgent();
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -158,6 +180,30 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Encoded states of the last sampled batch.
+  arma::mat sampledStates;
+
+  //! Actions of the last sampled batch.
+  arma::icolvec sampledActions;
+
+  //! Rewards of the last sampled batch.
+  arma::colvec sampledRewards;
+
+  //! Encoded next states of the last sampled batch.
+  arma::mat sampledNextStates;
+
+  //! Whether each next state of the last sampled batch is terminal.
+  arma::icolvec isTerminal;
+
+  //! Action values of the next states of the last sampled batch.
+  arma::mat nextActionValues;
+
+  //! Training targets of the last sampled batch.
+  arma::mat target;
+
+  //! Gradients of the last update.
+  arma::mat gradients;
 };
 
 } // namespace rl
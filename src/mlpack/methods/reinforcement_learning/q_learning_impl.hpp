@@ -116,20 +116,34 @@ double QLearning<
   if (deterministic || totalSteps < config.ExplorationSteps())
     return reward;
 
-  // Start experience replay.
+  TrainAgent();
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  arma::icolvec sampledActions;
-  arma::colvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::icolvec isTerminal;
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
+  // Start experience replay.
 
+  // Sample from previous experience.  The batch buffers are members, so the
+  // replay method can gather into them without allocating.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
   // Compute action value for next state with target network.
-  arma::mat nextActionValues;
   targetNetwork.Predict(sampledNextStates, nextActionValues);
 
   arma::Col<size_t> bestActions;
@@ -146,7 +160,6 @@ double QLearning<
   }
 
   // Compute the update target.
-  arma::mat target;
   learningNetwork.Forward(sampledStates, target);
   /**
    * If the agent is at a terminal state, then we don't need to add the
@@ -167,13 +180,68 @@ double QLearning<
   }
 
   // Learn form experience.
-  arma::mat gradients;
   learningNetwork.Backward(target, gradients);
 
   replayMethod.Update(target, sampledActions,
       nextActionValues, gradients);
 
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+double QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Step(VectorizedEnvironment<EnvironmentType>& environments)
+{
+  const size_t numEnvironments = environments.NumEnvironments();
+
+  // Get the action values of every copy with one forward pass.
+  arma::mat actionValues;
+  learningNetwork.Predict(environments.EncodedStates(), actionValues);
+
+  // Select an action for each copy according to the behavior policy.
+  std::vector<ActionType> actions(numEnvironments);
+  for (size_t i = 0; i < numEnvironments; ++i)
+    actions[i] = policy.Sample(actionValues.col(i), deterministic);
+
+  // Interact with every copy, and store all the transitions for replay.
+  arma::mat states, nextStates;
+  arma::colvec rewards;
+  arma::icolvec isTerminal;
+  environments.Step(actions, states, rewards, nextStates, isTerminal);
+  const double reward = arma::accu(rewards);
+
+  if (deterministic)
+    return reward;
+
+  replayMethod.BatchStore(states, actions, rewards, nextStates, isTerminal);
+
+  // Count the steps of all the copies; the target network is synced if the
+  // sync interval has been crossed.
+  const size_t previousSteps = totalSteps;
+  totalSteps += numEnvironments;
+  if (totalSteps / config.TargetNetworkSyncInterval() !=
+      previousSteps / config.TargetNetworkSyncInterval())
+    targetNetwork = learningNetwork;
+
+  for (size_t i = previousSteps + 1; i <= totalSteps; ++i)
+  {
+    if (i > config.ExplorationSteps())
+      policy.Anneal();
+  }
+
+  if (previousSteps >= config.ExplorationSteps())
+    TrainAgent();
 
   return reward;
 }
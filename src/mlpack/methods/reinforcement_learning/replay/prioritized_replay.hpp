@@ -13,7 +13,9 @@
 #define MLPACK_METHODS_RL_PRIORITIZED_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 #include "sumtree.hpp"
+#include "transition_buffer.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -33,9 +35,15 @@ namespace rl {
  *  }
  * @endcode
  *
+ * The transitions are kept in a preallocated TransitionBuffer, sampled batches
+ * are gathered directly into the matrices given to Sample(), and the
+ * priorities of a sampled batch are updated at once.
+ *
  * @tparam EnvironmentType Desired task.
+ * @tparam ObservationType Element type used to store encoded states (e.g.
+ *     float to halve the memory of the buffer).
  */
-template <typename EnvironmentType>
+template <typename EnvironmentType, typename ObservationType = double>
 class PrioritizedReplay
 {
  public:
@@ -64,18 +72,13 @@ class PrioritizedReplay
                     const double alpha,
                     const size_t dimension = StateType::dimension) :
       batchSize(batchSize),
-      capacity(capacity),
-      position(0),
-      states(dimension, capacity),
-      actions(capacity),
-      rewards(capacity),
-      nextStates(dimension, capacity),
-      isTerminal(capacity),
-      full(false),
+      buffer(capacity, dimension),
       alpha(alpha),
       maxPriority(1.0),
       initialBeta(0.6),
-      replayBetaIters(10000)
+      replayBetaIters(10000),
+      sampledIndices(batchSize),
+      weights(batchSize)
   {
     size_t size = 1;
     while (size < capacity)
@@ -102,20 +105,38 @@ class PrioritizedReplay
              const StateType& nextState,
              bool isEnd)
   {
-    states.col(position) = state.Encode();
-    actions(position) = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-
-    idxSum.Set(position, maxPriority * alpha);
+    const size_t index = buffer.Store(state.Encode(), action, reward,
+        nextState.Encode(), isEnd);
+    idxSum.Set(index, maxPriority * alpha);
+  }
 
-    position++;
-    if (position == capacity)
+  /**
+   * Store several experiences at once, such as one step of each copy of a
+   * vectorized environment, and set their priorities.  Column (or element) i
+   * of each argument describes experience i.
+   *
+   * @param encodedStates Given encoded states.
+   * @param actions Given actions.
+   * @param rewards Given rewards.
+   * @param encodedNextStates Given encoded next states.
+   * @param isEnd Whether each next state is terminal state.
+   */
+  void BatchStore(const arma::mat& encodedStates,
+                  const std::vector<ActionType>& actions,
+                  const arma::colvec& rewards,
+                  const arma::mat& encodedNextStates,
+                  const arma::icolvec& isEnd)
+  {
+    arma::ucolvec indices(encodedStates.n_cols);
+    for (size_t i = 0; i < encodedStates.n_cols; ++i)
     {
-      full = true;
-      position = 0;
+      indices[i] = buffer.Store(encodedStates.col(i), actions[i], rewards[i],
+          encodedNextStates.col(i), isEnd[i]);
     }
+
+    const arma::colvec priorities(encodedStates.n_cols,
+        arma::fill::ones);
+    idxSum.BatchUpdate(indices, maxPriority * alpha * priorities);
   }
 
   /**
@@ -125,19 +146,33 @@ class PrioritizedReplay
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
+    arma::ucolvec idxes;
+    SampleProportional(idxes);
+    return idxes;
+  }
+
+  /**
+   * Sample some experiences according to their priorities, and write their
+   * indices into the given vector.
+   *
+   * @param idxes Vector to store the indices in.
+   */
+  void SampleProportional(arma::ucolvec& idxes)
+  {
+    idxes.set_size(batchSize);
+    double totalSum = idxSum.Sum(0, buffer.Size());
     double sumPerRange = totalSum / batchSize;
     for (size_t bt = 0; bt < batchSize; bt++)
     {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
+      const double mass = math::Random() * sumPerRange + bt * sumPerRange;
       idxes(bt) = idxSum.FindPrefixSum(mass);
     }
-    return idxes;
   }
 
   /**
-   * Sample some experience according to their priorities.
+   * Sample some experience according to their priorities.  The outputs are
+   * only reallocated if their size differs from the batch size, so passing the
+   * same matrices at every call avoids any allocation.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -152,23 +187,19 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::icolvec& isTerminal)
   {
-    sampledIndices = SampleProportional();
+    SampleProportional(sampledIndices);
     BetaAnneal();
 
-    sampledStates = states.cols(sampledIndices);
-    sampledActions = actions.elem(sampledIndices);
-    sampledRewards = rewards.elem(sampledIndices);
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices);
+    buffer.Gather(sampledIndices, sampledStates, sampledActions,
+        sampledRewards, sampledNextStates, isTerminal);
 
     // Calculate the weights of sampled transitions.
-
-    size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
-
+    const size_t numSample = buffer.Size();
+    const double totalSum = idxSum.Sum();
+    weights.set_size(sampledIndices.n_rows);
     for (size_t i = 0; i < sampledIndices.n_rows; i++)
     {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
+      double p_sample = idxSum.Get(sampledIndices(i)) / totalSum;
       weights(i) = pow(numSample * p_sample, -beta);
     }
     weights /= weights.max();
@@ -180,11 +211,11 @@ class PrioritizedReplay
    * @param indices The indices of sample to be updated.
    * @param priorities Their corresponding priorities.
    */
-  void UpdatePriorities(arma::ucolvec& indices, arma::colvec& priorities)
+  void UpdatePriorities(const arma::ucolvec& indices,
+                        const arma::colvec& priorities)
   {
-      arma::colvec alphaPri = alpha * priorities;
-      maxPriority = std::max(maxPriority, arma::max(priorities));
-      idxSum.BatchUpdate(indices, alphaPri);
+    maxPriority = std::max(maxPriority, arma::max(priorities));
+    idxSum.BatchUpdate(indices, alpha * priorities);
   }
 
   /**
@@ -192,9 +223,9 @@ class PrioritizedReplay
    *
    * @return Actual used memory size.
    */
-  const size_t& Size()
+  size_t Size() const
   {
-    return full ? capacity : position;
+    return buffer.Size();
   }
 
   /**
@@ -213,52 +244,29 @@ class PrioritizedReplay
    * @param nextActionValues Agent's next action.
    * @param gradients The model's gradients.
    */
-  void Update(arma::mat target,
-              arma::icolvec sampledActions,
-              arma::mat nextActionValues,
+  void Update(const arma::mat& target,
+              const arma::icolvec& sampledActions,
+              const arma::mat& nextActionValues,
               arma::mat& gradients)
   {
-    arma::colvec tdError(target.n_cols);
+    tdError.set_size(target.n_cols);
     for (size_t i = 0; i < target.n_cols; i ++)
     {
-      tdError(i) = nextActionValues(sampledActions(i), i) -
-          target(sampledActions(i), i);
+      tdError(i) = std::abs(nextActionValues(sampledActions(i), i) -
+          target(sampledActions(i), i));
     }
-    tdError = arma::abs(tdError);
     UpdatePriorities(sampledIndices, tdError);
 
     // Update the gradient
-    gradients = arma::mean(weights) * gradients;
+    gradients *= arma::mean(weights);
   }
 
-
  private:
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
 
-  //! Locally-stored total memory limit.
-  size_t capacity;
-
-  //! Indicate the position to store new transition.
-  size_t position;
-
-  //! Locally-stored encoded previous states.
-  arma::mat states;
-
-  //! Locally-stored previous actions.
-  arma::icolvec actions;
-
-  //! Locally-stored previous rewards.
-  arma::colvec rewards;
-
-  //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
-
-  //! Locally-stored termination information of previous experience.
-  arma::icolvec isTerminal;
-
-  //! Locally-stored indicator that whether the memory is full or not.
-  bool full;
+  //! Locally-stored transitions.
+  TransitionBuffer<ObservationType> buffer;
 
   //! How much prioritization is used.
   //! (0 - no prioritization, 1 - full prioritization)
@@ -284,6 +292,9 @@ class PrioritizedReplay
 
   //! Locally-stored the weights of sampled transitions.
   arma::rowvec weights;
+
+  //! Locally-stored TD errors of the sampled transitions.
+  arma::colvec tdError;
 };
 
 } // namespace rl
@@ -13,6 +13,8 @@
 #define MLPACK_METHODS_RL_REPLAY_RANDOM_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "transition_buffer.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -37,9 +39,15 @@ namespace rl {
  * }
  * @endcode
  *
+ * The transitions are kept in a preallocated TransitionBuffer, and sampled
+ * batches are gathered directly into the matrices given to Sample(), so that
+ * no memory is allocated when the same matrices are used for every batch.
+ *
  * @tparam EnvironmentType Desired task.
+ * @tparam ObservationType Element type used to store encoded states (e.g.
+ *     float to halve the memory of the buffer).
  */
-template <typename EnvironmentType>
+template <typename EnvironmentType, typename ObservationType = double>
 class RandomReplay
 {
  public:
@@ -50,10 +58,7 @@ class RandomReplay
   using StateType = typename EnvironmentType::State;
 
   RandomReplay():
-      batchSize(0),
-      capacity(0),
-      position(0),
-      full(false)
+      batchSize(0)
   { /* Nothing to do here. */ }
 
   /**
@@ -67,14 +72,8 @@ class RandomReplay
                const size_t capacity,
                const size_t dimension = StateType::dimension) :
       batchSize(batchSize),
-      capacity(capacity),
-      position(0),
-      states(dimension, capacity),
-      actions(capacity),
-      rewards(capacity),
-      nextStates(dimension, capacity),
-      isTerminal(capacity),
-      full(false)
+      buffer(capacity, dimension),
+      sampledIndices(batchSize)
   { /* Nothing to do here. */ }
 
   /**
@@ -92,21 +91,37 @@ class RandomReplay
              const StateType& nextState,
              bool isEnd)
   {
-    states.col(position) = state.Encode();
-    actions(position) = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-    position++;
-    if (position == capacity)
+    buffer.Store(state.Encode(), action, reward, nextState.Encode(), isEnd);
+  }
+
+  /**
+   * Store several experiences at once, such as one step of each copy of a
+   * vectorized environment.  Column (or element) i of each argument describes
+   * experience i.
+   *
+   * @param encodedStates Given encoded states.
+   * @param actions Given actions.
+   * @param rewards Given rewards.
+   * @param encodedNextStates Given encoded next states.
+   * @param isEnd Whether each next state is terminal state.
+   */
+  void BatchStore(const arma::mat& encodedStates,
+                  const std::vector<ActionType>& actions,
+                  const arma::colvec& rewards,
+                  const arma::mat& encodedNextStates,
+                  const arma::icolvec& isEnd)
+  {
+    for (size_t i = 0; i < encodedStates.n_cols; ++i)
     {
-      full = true;
-      position = 0;
+      buffer.Store(encodedStates.col(i), actions[i], rewards[i],
+          encodedNextStates.col(i), isEnd[i]);
     }
   }
 
   /**
-   * Sample some experiences.
+   * Sample some experiences.  The outputs are only reallocated if their size
+   * differs from the batch size, so passing the same matrices at every call
+   * avoids any allocation.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -121,15 +136,12 @@ class RandomReplay
               arma::mat& sampledNextStates,
               arma::icolvec& isTerminal)
   {
-    size_t upperBound = full ? capacity : position;
-    arma::uvec sampledIndices = arma::randi<arma::uvec>(
-        batchSize, arma::distr_param(0, upperBound - 1));
-
-    sampledStates = states.cols(sampledIndices);
-    sampledActions = actions.elem(sampledIndices);
-    sampledRewards = rewards.elem(sampledIndices);
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices);
+    const size_t upperBound = buffer.Size();
+    for (size_t i = 0; i < batchSize; ++i)
+      sampledIndices[i] = (size_t) math::RandInt((int) upperBound);
+
+    buffer.Gather(sampledIndices, sampledStates, sampledActions,
+        sampledRewards, sampledNextStates, isTerminal);
   }
 
   /**
@@ -137,9 +149,9 @@ class RandomReplay
    *
    * @return Actual used memory size
    */
-  const size_t& Size()
+  size_t Size() const
   {
-    return full ? capacity : position;
+    return buffer.Size();
   }
 
   /**
@@ -150,9 +162,9 @@ class RandomReplay
    * @param nextActionValues Agent's next action
    * @param gradients The model's gradients
    */
-  void Update(arma::mat /* target */,
-              arma::icolvec /* sampledActions */,
-              arma::mat /* nextActionValues */,
+  void Update(const arma::mat& /* target */,
+              const arma::icolvec& /* sampledActions */,
+              const arma::mat& /* nextActionValues */,
               arma::mat& /* gradients */)
   {
     /* Do nothing for random replay. */
@@ -162,29 +174,11 @@ class RandomReplay
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
 
-  //! Locally-stored total memory limit.
-  size_t capacity;
-
-  //! Indicate the position to store new transition.
-  size_t position;
-
-  //! Locally-stored encoded previous states.
-  arma::mat states;
-
-  //! Locally-stored previous actions.
-  arma::icolvec actions;
-
-  //! Locally-stored previous rewards.
-  arma::colvec rewards;
-
-  //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
-
-  //! Locally-stored termination information of previous experience.
-  arma::icolvec isTerminal;
+  //! Locally-stored transitions.
+  TransitionBuffer<ObservationType> buffer;
 
-  //! Locally-stored indicator that whether the memory is full or not
-  bool full;
+  //! Indices of the last sampled transitions.
+  arma::uvec sampledIndices;
 };
 
 } // namespace rl
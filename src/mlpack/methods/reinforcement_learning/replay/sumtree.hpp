@@ -68,20 +68,58 @@ class SumTree
 
   /**
    * Update the data with batch rather loop over the indices with set method.
+   * Only the ancestors of the changed elements are recomputed, one level of
+   * the tree at a time; the nodes of a level are independent, so large levels
+   * are recomputed in parallel.  If an index appears several times, the last
+   * value is used.
    *
    * @param indices The indices of data to be changed.
    * @param data The data that array with indices to be.
    */
   void BatchUpdate(const arma::ucolvec& indices, const arma::Col<T>& data)
   {
+    std::vector<size_t> nodes(indices.n_rows);
     for (size_t i = 0; i < indices.n_rows; i++)
     {
       element[indices[i] + capacity] = data[i];
+      nodes[i] = (indices[i] + capacity) / 2;
     }
-    // update the total tree with bottom-up technique.
-    for (size_t i = capacity - 1; i > 0; i--)
+
+    // Keep the nodes to recompute sorted in decreasing order, so that the
+    // deepest ones come first.
+    std::sort(nodes.begin(), nodes.end(), std::greater<size_t>());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    std::vector<size_t> parents;
+    while (!nodes.empty() && nodes.front() >= 1)
     {
-      element[i] = element[2 * i] + element[2 * i + 1];
+      // Find the nodes on the deepest level, which starts at levelStart.
+      size_t levelStart = 1;
+      while (2 * levelStart <= nodes.front())
+        levelStart *= 2;
+      size_t levelSize = 0;
+      while (levelSize < nodes.size() && nodes[levelSize] >= levelStart)
+        ++levelSize;
+
+      #pragma omp parallel for if (levelSize >= 4096)
+      for (omp_size_t i = 0; i < (omp_size_t) levelSize; ++i)
+      {
+        const size_t node = nodes[i];
+        element[node] = element[2 * node] + element[2 * node + 1];
+      }
+
+      // Replace the level by its parents.  Parents keep the decreasing order,
+      // but may need to be merged with the nodes of the next level.
+      parents.clear();
+      for (size_t i = 0; i < levelSize; ++i)
+      {
+        if (nodes[i] > 1 && (parents.empty() || parents.back() != nodes[i] / 2))
+          parents.push_back(nodes[i] / 2);
+      }
+      std::vector<size_t> merged(parents.size() + nodes.size() - levelSize);
+      std::merge(parents.begin(), parents.end(), nodes.begin() + levelSize,
+          nodes.end(), merged.begin(), std::greater<size_t>());
+      merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+      nodes.swap(merged);
     }
   }
 
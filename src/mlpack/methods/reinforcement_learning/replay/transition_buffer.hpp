@@ -0,0 +1,180 @@
+/**
+ * @file transition_buffer.hpp
+ *
+ * Preallocated ring buffer of transitions, shared by the experience replay
+ * methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_TRANSITION_BUFFER_HPP
+#define MLPACK_METHODS_RL_REPLAY_TRANSITION_BUFFER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A first-in-first-out buffer of transitions, stored as a structure of arrays:
+ * all encoded states are the columns of one matrix, all actions are the
+ * elements of one vector, and so on.  All the memory is allocated at
+ * construction time, so storing a transition never allocates, and a sampled
+ * batch is gathered directly into the caller's matrices, which are only
+ * resized when the batch shape changes.
+ *
+ * The observations may be stored with a smaller element type than double
+ * (e.g. float) to halve the memory used by the buffer; they are converted back
+ * to double when a batch is gathered.
+ *
+ * @tparam ObservationType Element type used to store encoded states.
+ */
+template<typename ObservationType = double>
+class TransitionBuffer
+{
+ public:
+  /**
+   * Create an empty buffer that can't hold any transition.
+   */
+  TransitionBuffer() : capacity(0), position(0), full(false)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Create a buffer that can hold the given number of transitions.
+   *
+   * @param capacity Maximum number of transitions.
+   * @param dimension Dimension of an encoded state.
+   */
+  TransitionBuffer(const size_t capacity, const size_t dimension) :
+      capacity(capacity),
+      position(0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      full(false)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given transition, overwriting the oldest one if the buffer is
+   * full.
+   *
+   * @param state Encoded state.
+   * @param action Action taken in the state.
+   * @param reward Reward of the transition.
+   * @param nextState Encoded next state.
+   * @param isEnd Whether the next state is a terminal state.
+   * @return Index of the stored transition in the buffer.
+   */
+  template<typename StateVecType, typename NextStateVecType>
+  size_t Store(const StateVecType& state,
+               const arma::sword action,
+               const double reward,
+               const NextStateVecType& nextState,
+               const bool isEnd)
+  {
+    const size_t index = position;
+    CopyObservation(state, states.colptr(index));
+    actions[index] = action;
+    rewards[index] = reward;
+    CopyObservation(nextState, nextStates.colptr(index));
+    isTerminal[index] = isEnd;
+
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+
+    return index;
+  }
+
+  /**
+   * Gather the transitions with the given indices into the given batch.  The
+   * outputs are only reallocated if their size differs from the batch size.
+   *
+   * @param indices Indices of the transitions in the buffer.
+   * @param sampledStates Encoded states of the transitions.
+   * @param sampledActions Actions of the transitions.
+   * @param sampledRewards Rewards of the transitions.
+   * @param sampledNextStates Encoded next states of the transitions.
+   * @param sampledIsTerminal Whether each next state is terminal.
+   */
+  void Gather(const arma::uvec& indices,
+              arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& sampledIsTerminal) const
+  {
+    sampledStates.set_size(states.n_rows, indices.n_elem);
+    sampledActions.set_size(indices.n_elem);
+    sampledRewards.set_size(indices.n_elem);
+    sampledNextStates.set_size(nextStates.n_rows, indices.n_elem);
+    sampledIsTerminal.set_size(indices.n_elem);
+
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      const size_t index = indices[i];
+      std::copy(states.colptr(index), states.colptr(index) + states.n_rows,
+          sampledStates.colptr(i));
+      sampledActions[i] = actions[index];
+      sampledRewards[i] = rewards[index];
+      std::copy(nextStates.colptr(index),
+          nextStates.colptr(index) + nextStates.n_rows,
+          sampledNextStates.colptr(i));
+      sampledIsTerminal[i] = isTerminal[index];
+    }
+  }
+
+  //! Get the number of stored transitions.
+  size_t Size() const { return full ? capacity : position; }
+
+  //! Get the maximum number of transitions.
+  size_t Capacity() const { return capacity; }
+
+  //! Get the index where the next transition will be stored.
+  size_t Position() const { return position; }
+
+ private:
+  //! Copy an encoded state into the given column of the buffer.
+  template<typename VecType>
+  void CopyObservation(const VecType& x, ObservationType* out)
+  {
+    for (size_t i = 0; i < states.n_rows; ++i)
+      out[i] = (ObservationType) x[i];
+  }
+
+  //! Maximum number of transitions.
+  size_t capacity;
+
+  //! Index where the next transition will be stored.
+  size_t position;
+
+  //! Encoded states.
+  arma::Mat<ObservationType> states;
+
+  //! Actions.
+  arma::icolvec actions;
+
+  //! Rewards.
+  arma::colvec rewards;
+
+  //! Encoded next states.
+  arma::Mat<ObservationType> nextStates;
+
+  //! Whether each next state is terminal.
+  arma::icolvec isTerminal;
+
+  //! Whether the buffer has been filled at least once.
+  bool full;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
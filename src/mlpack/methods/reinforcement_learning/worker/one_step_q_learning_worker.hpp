@@ -13,8 +13,13 @@
 #ifndef MLPACK_METHODS_RL_WORKER_ONE_STEP_Q_LEARNING_WORKER_HPP
 #define MLPACK_METHODS_RL_WORKER_ONE_STEP_Q_LEARNING_WORKER_HPP
 
+#include <mlpack/prereqs.hpp>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
 
+#include "target_network.hpp"
+
+#include <atomic>
+
 namespace mlpack {
 namespace rl {
 
@@ -76,7 +81,8 @@ class OneStepQLearningWorker
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetNetwork The latest published target network (see
+   *     AsyncLearning).
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -84,8 +90,8 @@ class OneStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
-            size_t& totalSteps,
+            std::shared_ptr<const NetworkType>& targetNetwork,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -115,14 +121,16 @@ class OneStepQLearningWorker
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    const size_t currentSteps = ++totalSteps;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
 
     if (terminal || pendingIndex >= config.UpdateInterval())
     {
+      // Get the latest published target network.
+      localTargetNetwork.Sync(targetNetwork);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -132,11 +140,8 @@ class OneStepQLearningWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        localTargetNetwork.Network().Predict(
+            std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -161,7 +166,7 @@ class OneStepQLearningWorker
           { return std::min(std::max(gradient, -config.GradientLimit()),
           config.GradientLimit()); });
 
-      // Perform async update of the global network.
+      // Perform a lock-free (Hogwild) update of the global network.
       updater.Update(learningNetwork.Parameters(),
           config.StepSize(), totalGradients);
 
@@ -171,12 +176,9 @@ class OneStepQLearningWorker
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+    // Publish a new target network.
+    if (currentSteps % config.TargetNetworkSyncInterval() == 0)
+      TargetNetwork<NetworkType>::Publish(targetNetwork, learningNetwork);
 
     policy.Anneal();
 
@@ -229,6 +231,9 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network.
+  TargetNetwork<NetworkType> localTargetNetwork;
+
   //! Current state of the agent.
   StateType state;
 };
@@ -13,8 +13,13 @@
 #ifndef MLPACK_METHODS_RL_WORKER_ONE_STEP_SARSA_WORKER_HPP
 #define MLPACK_METHODS_RL_WORKER_ONE_STEP_SARSA_WORKER_HPP
 
+#include <mlpack/prereqs.hpp>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
 
+#include "target_network.hpp"
+
+#include <atomic>
+
 namespace mlpack {
 namespace rl {
 
@@ -77,7 +82,8 @@ class OneStepSarsaWorker
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetNetwork The latest published target network (see
+   *     AsyncLearning).
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -85,8 +91,8 @@ class OneStepSarsaWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
-            size_t& totalSteps,
+            std::shared_ptr<const NetworkType>& targetNetwork,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -124,14 +130,16 @@ class OneStepSarsaWorker
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    const size_t currentSteps = ++totalSteps;
 
     pending[pendingIndex++] =
         std::make_tuple(state, action, reward, nextState, nextAction);
 
     if (terminal || pendingIndex >= config.UpdateInterval())
     {
+      // Get the latest published target network.
+      localTargetNetwork.Sync(targetNetwork);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -141,11 +149,8 @@ class OneStepSarsaWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        localTargetNetwork.Network().Predict(
+            std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = 0;
         if (!(terminal && i == pending.size() - 1))
           targetActionValue = actionValue[std::get<4>(transition)];
@@ -170,7 +175,7 @@ class OneStepSarsaWorker
           { return std::min(std::max(gradient, -config.GradientLimit()),
           config.GradientLimit()); });
 
-      // Perform async update of the global network.
+      // Perform a lock-free (Hogwild) update of the global network.
       updater.Update(learningNetwork.Parameters(),
           config.StepSize(), totalGradients);
 
@@ -180,12 +185,9 @@ class OneStepSarsaWorker
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+    // Publish a new target network.
+    if (currentSteps % config.TargetNetworkSyncInterval() == 0)
+      TargetNetwork<NetworkType>::Publish(targetNetwork, learningNetwork);
 
     policy.Anneal();
 
@@ -240,6 +242,9 @@ class OneStepSarsaWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network.
+  TargetNetwork<NetworkType> localTargetNetwork;
+
   //! Current state of the agent.
   StateType state;
 
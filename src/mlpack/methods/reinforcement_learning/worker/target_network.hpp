@@ -0,0 +1,79 @@
+/**
+ * @file target_network.hpp
+ *
+ * This file is the definition of the TargetNetwork class, which holds the
+ * local copy of the target network of an async learning worker.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_TARGET_NETWORK_HPP
+#define MLPACK_METHODS_RL_WORKER_TARGET_NETWORK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * The local copy of the target network of a worker.  The target network is
+ * published by AsyncLearning as an immutable copy of the learning network;
+ * each worker copies the latest published one at its next update.
+ *
+ * @tparam NetworkType The type of the network model.
+ */
+template<typename NetworkType>
+class TargetNetwork
+{
+ public:
+  /**
+   * Copy the latest published target network, unless it is the one that was
+   * copied last time.
+   *
+   * @param published The latest published target network.
+   */
+  void Sync(const std::shared_ptr<const NetworkType>& published)
+  {
+    std::shared_ptr<const NetworkType> latest = std::atomic_load(&published);
+    if (latest != source)
+    {
+      network = *latest;
+      source = std::move(latest);
+    }
+  }
+
+  /**
+   * Publish a copy of the given learning network as the new target network.
+   * Workers still holding the previous one keep using it until their next
+   * update.
+   *
+   * @param published The published target network to replace.
+   * @param learningNetwork The shared learning network.
+   */
+  static void Publish(std::shared_ptr<const NetworkType>& published,
+                      const NetworkType& learningNetwork)
+  {
+    std::atomic_store(&published, std::shared_ptr<const NetworkType>(
+        new NetworkType(learningNetwork)));
+  }
+
+  //! Get the local copy of the target network.
+  NetworkType& Network() { return network; }
+
+ private:
+  //! Local copy of the target network.
+  NetworkType network;
+
+  //! The published target network the local copy was made from.
+  std::shared_ptr<const NetworkType> source;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
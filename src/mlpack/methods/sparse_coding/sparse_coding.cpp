@@ -40,21 +40,33 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   arma::mat matGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
 
+  // Every point is coded independently, so the points are split between
+  // threads.  Each thread keeps its own LARS object (and thus its own Cholesky
+  // factor and active set), while the Gram matrix is shared read-only.
+  #pragma omp parallel
+  {
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
+    arma::rowvec responses(data.n_rows);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Report progress.
+      if ((i % 100) == 0)
+      {
+        #pragma omp critical(SparseCodingEncodeLog)
+        Log::Debug << "Optimization at point " << i << "." << std::endl;
+      }
+
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col(i);
+      responses = data.unsafe_col(i).t();
+      lars.Train(dictionary, responses, code, false);
+    }
   }
 }
 
@@ -0,0 +1,134 @@
+/**
+ * @file anytime_kfn_test.cpp
+ *
+ * Test the AnytimeKFN functionality and the queue budget of the breadth-first
+ * dual-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/approx_kfn/anytime_kfn.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(AnytimeKFNTest);
+
+/**
+ * Without a time limit, the results must be exact, whatever the queue budget
+ * is (a small budget forces most combinations to be traversed depth-first).
+ */
+BOOST_AUTO_TEST_CASE(AnytimeKFNExactTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(4, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 200);
+
+  KFN kfn(referenceSet);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  kfn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  const size_t budgets[] = { 0, 1, 8, 1000000 };
+  for (size_t b = 0; b < 4; ++b)
+  {
+    AnytimeKFN<> anytime(referenceSet, budgets[b]);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    anytime.Search(querySet, 5, neighbors, distances);
+
+    BOOST_REQUIRE(!anytime.TimedOut());
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, 200);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], trueNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * With a time limit so small that the search cannot finish, k valid neighbors
+ * must still be returned for every query point, with the right distances.
+ */
+BOOST_AUTO_TEST_CASE(AnytimeKFNTimeLimitTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(10, 5000);
+  arma::mat querySet = arma::randu<arma::mat>(10, 1000);
+
+  AnytimeKFN<> anytime(referenceSet, 1000000, 1e-6);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  anytime.Search(querySet, 3, neighbors, distances);
+
+  BOOST_REQUIRE(anytime.TimedOut());
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), referenceSet.n_cols);
+      const double dist = metric::EuclideanDistance::Evaluate(querySet.col(i),
+          referenceSet.col(neighbors(j, i)));
+      BOOST_REQUIRE_CLOSE(distances(j, i), dist, 1e-5);
+
+      // The neighbors must be sorted and distinct.
+      if (j > 0)
+      {
+        BOOST_REQUIRE_GE(distances(j - 1, i), distances(j, i));
+        BOOST_REQUIRE_NE(neighbors(j - 1, i), neighbors(j, i));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(AnytimeKFNSerializationTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 500);
+  arma::mat querySet = arma::randu<arma::mat>(5, 100);
+
+  AnytimeKFN<> anytime(referenceSet, 50);
+
+  arma::mat fakeDataset = arma::randu<arma::mat>(3, 100);
+  AnytimeKFN<> anytimeXml(fakeDataset);
+  AnytimeKFN<> anytimeText;
+  AnytimeKFN<> anytimeBinary(fakeDataset, 10, 5.0);
+
+  SerializeObjectAll(anytime, anytimeXml, anytimeText, anytimeBinary);
+
+  BOOST_REQUIRE_EQUAL(anytimeXml.MaxQueueSize(), 50);
+  BOOST_REQUIRE_EQUAL(anytimeText.MaxQueueSize(), 50);
+  BOOST_REQUIRE_EQUAL(anytimeBinary.MaxQueueSize(), 50);
+  BOOST_REQUIRE_SMALL(anytimeBinary.TimeLimit(), 1e-10);
+
+  arma::Mat<size_t> neighbors, neighborsXml, neighborsText, neighborsBinary;
+  arma::mat distances, distancesXml, distancesText, distancesBinary;
+  anytime.Search(querySet, 3, neighbors, distances);
+  anytimeXml.Search(querySet, 3, neighborsXml, distancesXml);
+  anytimeText.Search(querySet, 3, neighborsText, distancesText);
+  anytimeBinary.Search(querySet, 3, neighborsBinary, distancesBinary);
+
+  CheckMatrices(neighbors, neighborsXml, neighborsText, neighborsBinary);
+  CheckMatrices(distances, distancesXml, distancesText, distancesBinary);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -462,6 +462,36 @@ BOOST_AUTO_TEST_CASE(KFoldCVAccuracyTest)
   cv.Model();
 }
 
+/**
+ * Test that the model kept by k-fold cross-validation is always the one trained
+ * for the last fold, even though the folds may be trained in parallel.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVLastModelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 6);
+  arma::rowvec responses = arma::randu<arma::rowvec>(6);
+
+  // With 3 folds of 2 points each, the last fold validates on points 2 and 3,
+  // so its model is trained on points 0, 1, 4 and 5.
+  KFoldCV<LinearRegression, MSE> cv(3, data, responses, false);
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    cv.Evaluate();
+
+    arma::uvec trainingIndices("0 1 4 5");
+    arma::rowvec trainingResponses = responses.cols(trainingIndices);
+    LinearRegression lr(data.cols(trainingIndices), trainingResponses);
+
+    BOOST_REQUIRE_EQUAL(cv.Model().Parameters().n_elem,
+        lr.Parameters().n_elem);
+    for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(cv.Model().Parameters()[i], lr.Parameters()[i],
+          1e-5);
+    }
+  }
+}
+
 /**
  * Test k-fold cross-validation with weighted linear regression.
  */
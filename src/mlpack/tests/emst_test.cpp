@@ -278,4 +278,41 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure that a dataset with many equal distances (a grid with duplicated
+ * points) gives a spanning tree of the same length as the naive computation.
+ */
+BOOST_AUTO_TEST_CASE(EqualDistancesTest)
+{
+  arma::mat inputData(2, 800);
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+  {
+    inputData(0, i) = (i / 2) % 20;
+    inputData(1, i) = (i / 2) / 20;
+  }
+
+  DualTreeBoruvka<> dtb(inputData);
+  DualTreeBoruvka<> dtbNaive(inputData, true);
+
+  arma::mat dualResults;
+  arma::mat naiveResults;
+  dtb.ComputeMST(dualResults);
+  dtbNaive.ComputeMST(naiveResults);
+
+  BOOST_REQUIRE_EQUAL(dualResults.n_cols, inputData.n_cols - 1);
+  BOOST_REQUIRE_EQUAL(naiveResults.n_cols, inputData.n_cols - 1);
+  BOOST_REQUIRE_CLOSE(arma::accu(dualResults.row(2)),
+      arma::accu(naiveResults.row(2)), 1e-5);
+
+  // Each point of a grid cell is at distance 0 of the other one, and the cells
+  // are at distance 1 of their neighbors.
+  BOOST_REQUIRE_CLOSE(arma::accu(dualResults.row(2)), 399.0, 1e-5);
+
+  // The edges must connect every point.
+  UnionFind uf(inputData.n_cols);
+  for (size_t i = 0; i < dualResults.n_cols; ++i)
+    BOOST_REQUIRE(uf.Union((size_t) dualResults(0, i),
+        (size_t) dualResults(1, i)));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -127,6 +127,111 @@ BOOST_AUTO_TEST_CASE(DualTreeVsSingleTree)
   }
 }
 
+/**
+ * Make sure the blocked kernel evaluations of brute-force search give the same
+ * results as separate kernel evaluations.
+ */
+template<typename KernelType>
+void CheckKernelBlock(KernelType& kernel)
+{
+  arma::mat queries(5, 30, arma::fill::randn);
+  arma::mat references(5, 40, arma::fill::randn);
+  references.col(3).zeros();
+
+  arma::mat products;
+  KernelBlock<KernelType>::Evaluate(kernel, queries, references, products);
+
+  BOOST_REQUIRE_EQUAL(products.n_rows, references.n_cols);
+  BOOST_REQUIRE_EQUAL(products.n_cols, queries.n_cols);
+  for (size_t j = 0; j < queries.n_cols; ++j)
+  {
+    for (size_t i = 0; i < references.n_cols; ++i)
+    {
+      const double kernelValue = kernel.Evaluate(queries.col(j),
+          references.col(i));
+      if (std::abs(kernelValue) < 1e-10)
+        BOOST_REQUIRE_SMALL(products(i, j), 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(products(i, j), kernelValue, 1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(KernelBlockTest)
+{
+  LinearKernel lk;
+  CheckKernelBlock(lk);
+
+  PolynomialKernel pk(3.0, 1.5);
+  CheckKernelBlock(pk);
+
+  CosineDistance cd;
+  CheckKernelBlock(cd);
+
+  GaussianKernel gk(1.5);
+  CheckKernelBlock(gk);
+}
+
+/**
+ * Compare dual-tree (which runs in parallel on subtrees of the query tree) and
+ * naive search with a separate query set, with the cosine kernel.
+ */
+BOOST_AUTO_TEST_CASE(DualTreeVsNaiveQuerySetCosine)
+{
+  arma::mat referenceData(6, 1500, arma::fill::randn);
+  arma::mat queryData(6, 700, arma::fill::randn);
+  CosineDistance cd;
+
+  FastMKS<CosineDistance> naive(referenceData, cd, false, true);
+  FastMKS<CosineDistance> tree(referenceData, cd);
+
+  arma::Mat<size_t> naiveIndices, treeIndices;
+  arma::mat naiveProducts, treeProducts;
+  naive.Search(queryData, 5, naiveIndices, naiveProducts);
+  tree.Search(queryData, 5, treeIndices, treeProducts);
+
+  // Run the dual-tree search a second time, to make sure that nothing left in
+  // the tree from the first search changes the results.
+  tree.Search(queryData, 5, treeIndices, treeProducts);
+
+  for (size_t q = 0; q < treeIndices.n_cols; ++q)
+  {
+    for (size_t r = 0; r < treeIndices.n_rows; ++r)
+    {
+      BOOST_REQUIRE_EQUAL(treeIndices(r, q), naiveIndices(r, q));
+      BOOST_REQUIRE_CLOSE(treeProducts(r, q), naiveProducts(r, q), 1e-5);
+    }
+  }
+}
+
+/**
+ * Compare single-tree (which traverses the query points in parallel) and naive
+ * search with a separate query set, with the polynomial kernel.
+ */
+BOOST_AUTO_TEST_CASE(SingleTreeVsNaiveQuerySet)
+{
+  arma::mat referenceData(4, 1200, arma::fill::randn);
+  arma::mat queryData(4, 800, arma::fill::randn);
+  PolynomialKernel pk(2.0);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  FastMKS<PolynomialKernel> single(referenceData, pk, true);
+
+  arma::Mat<size_t> naiveIndices, singleIndices;
+  arma::mat naiveProducts, singleProducts;
+  naive.Search(queryData, 7, naiveIndices, naiveProducts);
+  single.Search(queryData, 7, singleIndices, singleProducts);
+
+  for (size_t q = 0; q < singleIndices.n_cols; ++q)
+  {
+    for (size_t r = 0; r < singleIndices.n_rows; ++r)
+    {
+      BOOST_REQUIRE_EQUAL(singleIndices(r, q), naiveIndices(r, q));
+      BOOST_REQUIRE_CLOSE(singleProducts(r, q), naiveProducts(r, q), 1e-5);
+    }
+  }
+}
+
 /**
  * Test sparse FastMKS (how useful is this, I'm not sure).
  */
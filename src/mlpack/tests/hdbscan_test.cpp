@@ -0,0 +1,255 @@
+/**
+ * @file hdbscan_test.cpp
+ *
+ * Test the Dendrogram and HDBSCAN implementations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hdbscan/hdbscan.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::emst;
+using namespace mlpack::hdbscan;
+
+BOOST_AUTO_TEST_SUITE(HDBSCANTest);
+
+/**
+ * Check the linkage matrix of a small hand-computed spanning tree.
+ */
+BOOST_AUTO_TEST_CASE(DendrogramLinkageTest)
+{
+  // Points 0, 1, 2 and 3 on a line at 0, 1, 3 and 7.
+  arma::mat spanningTree = { { 2, 0, 1 },
+                             { 3, 1, 2 },
+                             { 4, 1, 2 } };
+
+  Dendrogram d(spanningTree);
+
+  BOOST_REQUIRE_EQUAL(d.NumPoints(), 4);
+  const arma::mat& linkage = d.Linkage();
+  BOOST_REQUIRE_EQUAL(linkage.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(linkage.n_cols, 3);
+
+  // First merge: points 0 and 1 into cluster 4.
+  BOOST_REQUIRE_EQUAL(linkage(0, 0), 0);
+  BOOST_REQUIRE_EQUAL(linkage(1, 0), 1);
+  BOOST_REQUIRE_CLOSE(linkage(2, 0), 1.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 0), 2);
+
+  // Second merge: point 2 and cluster 4 into cluster 5.
+  BOOST_REQUIRE_EQUAL(linkage(0, 1), 2);
+  BOOST_REQUIRE_EQUAL(linkage(1, 1), 4);
+  BOOST_REQUIRE_CLOSE(linkage(2, 1), 2.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 1), 3);
+
+  // Last merge: point 3 and cluster 5.
+  BOOST_REQUIRE_EQUAL(linkage(0, 2), 3);
+  BOOST_REQUIRE_EQUAL(linkage(1, 2), 5);
+  BOOST_REQUIRE_CLOSE(linkage(2, 2), 4.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 2), 4);
+
+  // Edges that do not form a tree must be rejected.
+  arma::mat cycle = { { 0, 0, 1 },
+                      { 1, 1, 0 },
+                      { 1, 1, 1 } };
+  BOOST_REQUIRE_THROW(Dendrogram d2(cycle), std::invalid_argument);
+}
+
+/**
+ * Cutting the single-linkage dendrogram must give the connected components of
+ * the points closer than the cut distance.
+ */
+BOOST_AUTO_TEST_CASE(SingleLinkageCutTest)
+{
+  arma::mat spanningTree = { { 2, 0, 1 },
+                             { 3, 1, 2 },
+                             { 4, 1, 2 } };
+  Dendrogram d(spanningTree);
+
+  arma::Row<size_t> assignments;
+  BOOST_REQUIRE_EQUAL(d.Cut(0.5, assignments), 4);
+  BOOST_REQUIRE_EQUAL(d.Cut(1.5, assignments), 3);
+  BOOST_REQUIRE_EQUAL(assignments[0], 0);
+  BOOST_REQUIRE_EQUAL(assignments[1], 0);
+  BOOST_REQUIRE_EQUAL(assignments[2], 1);
+  BOOST_REQUIRE_EQUAL(assignments[3], 2);
+
+  // With a minimum cluster size, the small clusters are noise.
+  BOOST_REQUIRE_EQUAL(d.Cut(2.0, assignments, 2), 1);
+  BOOST_REQUIRE_EQUAL(assignments[0], 0);
+  BOOST_REQUIRE_EQUAL(assignments[1], 0);
+  BOOST_REQUIRE_EQUAL(assignments[2], 0);
+  BOOST_REQUIRE_EQUAL(assignments[3], SIZE_MAX);
+
+  BOOST_REQUIRE_EQUAL(d.Cut(10.0, assignments), 1);
+}
+
+/**
+ * Check that each point appears once in the condensed tree, and that the
+ * cluster sizes are consistent.
+ */
+BOOST_AUTO_TEST_CASE(CondensedTreeTest)
+{
+  arma::mat dataset(2, 300, arma::fill::randn);
+  dataset.cols(100, 199) += 10.0;
+
+  DualTreeBoruvka<> dtb(dataset);
+  arma::mat spanningTree;
+  dtb.ComputeMST(spanningTree);
+  Dendrogram d(spanningTree);
+
+  arma::mat condensedTree;
+  d.Condense(10, condensedTree);
+
+  arma::Col<size_t> pointCount(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    BOOST_REQUIRE_GE(condensedTree(0, i), dataset.n_cols);
+    if (condensedTree(1, i) < dataset.n_cols)
+    {
+      ++pointCount[(size_t) condensedTree(1, i)];
+      BOOST_REQUIRE_EQUAL(condensedTree(3, i), 1);
+    }
+    else
+    {
+      // Children are clusters with at least the minimum number of points.
+      BOOST_REQUIRE_GE(condensedTree(3, i), 10);
+      BOOST_REQUIRE_GT(condensedTree(1, i), condensedTree(0, i));
+    }
+  }
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(pointCount[i], 1);
+
+  BOOST_REQUIRE_THROW(d.Condense(1, condensedTree), std::invalid_argument);
+}
+
+/**
+ * The mutual reachability spanning tree computed with trees must have the same
+ * length as the one computed naively.
+ */
+BOOST_AUTO_TEST_CASE(MutualReachabilityTreeTest)
+{
+  arma::mat dataset(3, 500, arma::fill::randu);
+
+  arma::vec coreDistances;
+  HDBSCAN<>::CoreDistances(dataset, 5, coreDistances);
+  BOOST_REQUIRE_EQUAL(coreDistances.n_elem, dataset.n_cols);
+
+  // Check a few core distances against brute force.
+  for (size_t i = 0; i < dataset.n_cols; i += 50)
+  {
+    arma::vec distances(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      distances[j] = arma::norm(dataset.col(i) - dataset.col(j));
+    distances = arma::sort(distances);
+    // The point itself is the first neighbor.
+    BOOST_REQUIRE_CLOSE(coreDistances[i], distances[4], 1e-5);
+  }
+
+  DualTreeBoruvka<> dtb(dataset);
+  DualTreeBoruvka<> naive(dataset, true);
+  arma::mat dtbTree, naiveTree;
+  dtb.ComputeMST(dtbTree, coreDistances);
+  naive.ComputeMST(naiveTree, coreDistances);
+
+  BOOST_REQUIRE_EQUAL(dtbTree.n_cols, dataset.n_cols - 1);
+  BOOST_REQUIRE_CLOSE(arma::accu(dtbTree.row(2)), arma::accu(naiveTree.row(2)),
+      1e-5);
+
+  // No edge can be shorter than the core distances of its points.
+  for (size_t i = 0; i < dtbTree.n_cols; ++i)
+  {
+    BOOST_REQUIRE_GE(dtbTree(2, i) + 1e-10,
+        coreDistances[(size_t) dtbTree(0, i)]);
+    BOOST_REQUIRE_GE(dtbTree(2, i) + 1e-10,
+        coreDistances[(size_t) dtbTree(1, i)]);
+  }
+}
+
+/**
+ * HDBSCAN should find three well-separated Gaussian clusters, and label far
+ * away points as noise.
+ */
+BOOST_AUTO_TEST_CASE(ThreeClustersTest)
+{
+  arma::mat dataset(2, 303);
+  dataset.cols(0, 99) = arma::randn<arma::mat>(2, 100);
+  dataset.cols(100, 199) = arma::randn<arma::mat>(2, 100) + 20.0;
+  dataset.cols(200, 299) = arma::randn<arma::mat>(2, 100) - 20.0;
+  dataset.col(300) = arma::vec({ 100.0, -100.0 });
+  dataset.col(301) = arma::vec({ -100.0, 100.0 });
+  dataset.col(302) = arma::vec({ 200.0, 200.0 });
+
+  HDBSCAN<> h(10);
+  arma::Row<size_t> assignments;
+  const size_t numClusters = h.Cluster(dataset, assignments);
+
+  BOOST_REQUIRE_EQUAL(numClusters, 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, dataset.n_cols);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    // Most points of each blob must be in the same cluster.
+    const size_t label = assignments[100 * c];
+    size_t count = 0;
+    for (size_t i = 100 * c; i < 100 * (c + 1); ++i)
+      if (assignments[i] == label)
+        ++count;
+    BOOST_REQUIRE_NE(label, SIZE_MAX);
+    BOOST_REQUIRE_GE(count, 90);
+  }
+
+  BOOST_REQUIRE_NE(assignments[0], assignments[100]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[200]);
+  BOOST_REQUIRE_NE(assignments[100], assignments[200]);
+
+  for (size_t i = 300; i < 303; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], SIZE_MAX);
+}
+
+/**
+ * Cutting the HDBSCAN dendrogram at a distance should give the core points of
+ * DBSCAN* with that radius.
+ */
+BOOST_AUTO_TEST_CASE(DendrogramCutDBSCANTest)
+{
+  arma::mat dataset(2, 200);
+  dataset.cols(0, 99) = arma::randn<arma::mat>(2, 100);
+  dataset.cols(100, 199) = arma::randn<arma::mat>(2, 100) + 50.0;
+
+  HDBSCAN<> h(5);
+  Dendrogram d;
+  arma::Row<size_t> assignments;
+  h.Cluster(dataset, assignments, d);
+
+  arma::vec coreDistances;
+  HDBSCAN<>::CoreDistances(dataset, 5, coreDistances);
+
+  const double epsilon = 1.0;
+  d.Cut(epsilon, assignments, 2);
+
+  // Points whose core distance is larger than epsilon are not core points, so
+  // they are noise at that radius.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    if (coreDistances[i] > epsilon)
+      BOOST_REQUIRE_EQUAL(assignments[i], SIZE_MAX);
+
+  // The two blobs are never in the same cluster.
+  for (size_t i = 0; i < 100; ++i)
+  {
+    for (size_t j = 100; j < 200; ++j)
+    {
+      if (assignments[i] != SIZE_MAX)
+        BOOST_REQUIRE_NE(assignments[i], assignments[j]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,95 @@
+/**
+ * @file ivfpq_test.cpp
+ *
+ * Unit tests for the 'IVFPQSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <mlpack/methods/ivfpq/ivfpq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(IVFPQTest);
+
+/**
+ * When every list is visited and every candidate is re-ranked, the results
+ * must be the exact nearest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQExhaustiveRerankTest)
+{
+  arma::mat referenceData(8, 200, arma::fill::randu);
+  arma::mat queryData(8, 20, arma::fill::randu);
+
+  IVFPQSearch<> ivfpq(referenceData, 4, 4, 16, true);
+  ivfpq.NumProbes() = 4;
+  ivfpq.Rerank() = referenceData.n_cols;
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queryData, 5, neighbors, distances);
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], trueNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Adding the reference set in chunks must give the same index as adding it at
+ * once.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQChunkedAddTest)
+{
+  arma::mat referenceData(10, 300, arma::fill::randu);
+
+  IVFPQSearch<> ivfpq(8, 5, 32);
+  ivfpq.Train(referenceData);
+  IVFPQSearch<> chunked(ivfpq);
+
+  ivfpq.Add(referenceData);
+  chunked.Add(referenceData.cols(0, 99));
+  chunked.Add(referenceData.cols(100, 299));
+
+  BOOST_REQUIRE_EQUAL(chunked.Size(), referenceData.n_cols);
+  for (size_t l = 0; l < ivfpq.NumLists(); ++l)
+  {
+    BOOST_REQUIRE(ivfpq.ListIndices(l) == chunked.ListIndices(l));
+    BOOST_REQUIRE(ivfpq.ListCodes(l) == chunked.ListCodes(l));
+  }
+
+  arma::mat queryData(10, 10, arma::fill::randu);
+  arma::Mat<size_t> neighbors, chunkedNeighbors;
+  arma::mat distances, chunkedDistances;
+  ivfpq.Search(queryData, 3, neighbors, distances);
+  chunked.Search(queryData, 3, chunkedNeighbors, chunkedDistances);
+
+  CheckMatrices(neighbors, chunkedNeighbors);
+  CheckMatrices(distances, chunkedDistances);
+}
+
+/**
+ * The codes are stored on one byte, so no subspace may have more than 256
+ * centroids.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQTooManyCentroidsTest)
+{
+  BOOST_REQUIRE_THROW(IVFPQSearch<>(8, 4, 257), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
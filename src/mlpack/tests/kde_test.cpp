@@ -164,6 +164,45 @@ BOOST_AUTO_TEST_CASE(GaussianKDEBruteForceTest)
     BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError*100);
 }
 
+/**
+ * Test dual-tree results against brute force results on data far from the
+ * origin, where the blocked distances have large rounding errors, both with
+ * no error tolerance and with a relative error tolerance.
+ */
+BOOST_AUTO_TEST_CASE(GaussianKDEOffsetBruteForceTest)
+{
+  arma::mat reference = arma::randu(3, 300) + 1e4;
+  arma::mat query = arma::randu(3, 80) + 1e4;
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.3;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  const double relErrors[] = { 0.0, 0.01 };
+  for (size_t r = 0; r < 2; ++r)
+  {
+    arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+    metric::EuclideanDistance metric;
+    KDE<GaussianKernel,
+        metric::EuclideanDistance,
+        arma::mat,
+        tree::KDTree>
+        kde(relErrors[r], 0.0, kernel, KDEMode::DUAL_TREE_MODE, metric);
+    kde.Train(reference);
+    kde.Evaluate(query, treeEstimations);
+
+    // An exact estimation may only differ by floating-point noise.
+    const double tolerance = (relErrors[r] == 0.0) ? 1e-6 : relErrors[r] * 100;
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], tolerance);
+  }
+}
+
 /**
  * Test single-tree implementation results against brute force results.
  */
@@ -16,6 +16,7 @@
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -1466,4 +1467,353 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Ensure that the HNSW graph finds most of the true nearest neighbors, both
+ * for a separate query set and for the reference set itself, and that naive
+ * mode is exact.
+ */
+BOOST_AUTO_TEST_CASE(HNSWSearchRecallTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(20, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(20, 100);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors, trueMonoNeighbors;
+  arma::mat trueDistances, trueMonoDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+  knn.Search(10, trueMonoNeighbors, trueMonoDistances);
+
+  HNSWSearch<> hnsw(referenceData, 16, 100, 100);
+  BOOST_REQUIRE_GT(hnsw.NumLevels(), 1);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 10, neighbors, distances);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.95);
+
+  hnsw.Search(10, neighbors, distances);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueMonoNeighbors), 0.95);
+  BOOST_REQUIRE_EQUAL(arma::accu(neighbors == arma::repmat(
+      arma::regspace<arma::Row<size_t>>(0, 999), 10, 1)), 0);
+
+  hnsw.SearchMode() = NAIVE_MODE;
+  hnsw.Search(queryData, 10, neighbors, distances);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Ensure that an NSModel with an HNSW graph gives the same results after
+ * serialization.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelHNSWSerializationTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(10, 500);
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+
+  KNNModel model(KNNModel::TreeTypes::HNSW);
+  model.Degree() = 8;
+  model.EfSearch() = 40;
+  model.BuildModel(std::move(arma::mat(referenceData)), 20, SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(std::move(arma::mat(queryData)), 5, neighbors, distances);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.9);
+
+  KNNModel xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  KNNModel* models[3] = { &xmlModel, &textModel, &binaryModel };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(models[i]->TreeType(), KNNModel::TreeTypes::HNSW);
+    BOOST_REQUIRE_EQUAL(models[i]->Degree(), 8);
+    BOOST_REQUIRE_EQUAL(models[i]->EfSearch(), 40);
+
+    arma::Mat<size_t> loadedNeighbors;
+    arma::mat loadedDistances;
+    models[i]->Search(std::move(arma::mat(queryData)), 5, loadedNeighbors,
+        loadedDistances);
+    CheckMatrices(loadedNeighbors, neighbors);
+    CheckMatrices(loadedDistances, distances);
+  }
+}
+
+/**
+ * Check that the given object, after some points were inserted and removed,
+ * gives the same results as a brute-force search on the points that are left.
+ */
+template<typename NSType>
+void CheckUpdatedSearch(NSType& ns,
+                        const arma::mat& dataset,
+                        const std::vector<bool>& alive,
+                        const arma::mat& queryData,
+                        const bool monochromatic)
+{
+  // Build the reference set that the object should be equivalent to.
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < alive.size(); ++i)
+    if (alive[i])
+      indices.push_back(i);
+  arma::mat liveSet(dataset.n_rows, indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    liveSet.col(i) = dataset.col(indices[i]);
+
+  BOOST_REQUIRE_EQUAL(ns.NumReferencePoints(), indices.size());
+
+  KNN naive(liveSet, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, trueNeighbors;
+  arma::mat distances, trueDistances;
+  naive.Search(queryData, 5, trueNeighbors, trueDistances);
+  ns.Search(queryData, 5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], indices[trueNeighbors[i]]);
+    BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+  }
+
+  if (!monochromatic)
+    return;
+
+  // The results of the monochromatic search are indexed by reference index;
+  // removed points have no neighbors.
+  naive.Search(5, trueNeighbors, trueDistances);
+  ns.Search(5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, alive.size());
+  for (size_t i = 0; i < alive.size(); ++i)
+    if (!alive[i])
+      BOOST_REQUIRE_EQUAL(neighbors(0, i), (size_t) SIZE_MAX);
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, indices[i]),
+          indices[trueNeighbors(j, i)]);
+      BOOST_REQUIRE_CLOSE(distances(j, indices[i]), trueDistances(j, i),
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Insert and remove points from the given type of NeighborSearch object, and
+ * check the results after each step.
+ */
+template<typename NSType>
+void InsertRemoveTest(const NeighborSearchMode mode)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+  std::vector<bool> alive(1000, false);
+
+  NSType ns(dataset.cols(0, 699), mode);
+  for (size_t i = 0; i < 700; ++i)
+    alive[i] = true;
+
+  // Insert the other points in batches; some are searched by brute force
+  // until a rebuild.
+  for (size_t i = 700; i < 1000; i += 50)
+  {
+    ns.Insert(dataset.cols(i, i + 49));
+    for (size_t j = i; j < i + 50; ++j)
+      alive[j] = true;
+  }
+  CheckUpdatedSearch(ns, dataset, alive, queryData, false);
+
+  // Remove a few points; this is not enough to trigger a rebuild.
+  arma::Col<size_t> removed = { 3, 16, 250, 699, 700, 997 };
+  ns.Remove(removed);
+  for (size_t i = 0; i < removed.n_elem; ++i)
+    alive[removed[i]] = false;
+  CheckUpdatedSearch(ns, dataset, alive, queryData, false);
+
+  // A point can't be removed twice.
+  arma::Col<size_t> removedAgain = { 250 };
+  BOOST_REQUIRE_THROW(ns.Remove(removedAgain), std::invalid_argument);
+
+  // Invalid lists are rejected before any point is removed.
+  const size_t numPoints = ns.NumReferencePoints();
+  arma::Col<size_t> duplicates = { 5, 701, 5 };
+  BOOST_REQUIRE_THROW(ns.Remove(duplicates), std::invalid_argument);
+  arma::Col<size_t> outOfRange = { 5, 701, 5000 };
+  BOOST_REQUIRE_THROW(ns.Remove(outOfRange), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(ns.NumReferencePoints(), numPoints);
+
+  // Now remove many points, which will rebuild the tree.
+  removed = arma::regspace<arma::Col<size_t>>(2, 3, 999);
+  ns.Remove(removed);
+  for (size_t i = 0; i < removed.n_elem; ++i)
+    alive[removed[i]] = false;
+  CheckUpdatedSearch(ns, dataset, alive, queryData, true);
+}
+
+/**
+ * Check that a dual-tree search gives the same results as a naive search on
+ * points far from the origin, where the blocked Euclidean base cases suffer
+ * from cancellation.
+ */
+template<typename SearchType>
+void CheckBlockedBaseCases()
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 800) + 1000.0;
+  arma::mat queryData = arma::randu<arma::mat>(3, 200) + 1000.0;
+
+  SearchType tree(dataset, DUAL_TREE_MODE);
+  SearchType naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    // The second pass is monochromatic.
+    if (pass == 0)
+    {
+      tree.Search(queryData, 5, neighbors, distances);
+      naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+    }
+    else
+    {
+      tree.Search(5, neighbors, distances);
+      naive.Search(5, naiveNeighbors, naiveDistances);
+    }
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the blocked base cases of the dual-tree traversal find the
+ * exact nearest and furthest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(BlockedBaseCaseTest)
+{
+  CheckBlockedBaseCases<KNN>();
+  CheckBlockedBaseCases<KFN>();
+}
+
+/**
+ * Make sure that points can be inserted into and removed from a kd-tree
+ * search object, whose updates are kept aside until the tree is rebuilt.
+ */
+BOOST_AUTO_TEST_CASE(KNNInsertRemoveKDTreeTest)
+{
+  InsertRemoveTest<KNN>(DUAL_TREE_MODE);
+}
+
+/**
+ * Make sure that points can be inserted into and removed from an R tree search
+ * object, whose updates go directly into the tree.
+ */
+BOOST_AUTO_TEST_CASE(KNNInsertRemoveRTreeTest)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      RTree> RTreeKNN;
+  InsertRemoveTest<RTreeKNN>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Make sure that an NSModel forwards insertions and removals, and refuses them
+ * for HNSW graphs.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelInsertRemoveTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::mat queryData = arma::randu<arma::mat>(4, 20);
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE);
+  model.BuildModel(std::move(arma::mat(dataset.cols(0, 199))), 20,
+      DUAL_TREE_MODE);
+  model.Insert(std::move(arma::mat(dataset.cols(200, 299))));
+  arma::Col<size_t> removed = arma::regspace<arma::Col<size_t>>(0, 2, 299);
+  model.Remove(removed);
+
+  arma::mat liveSet = dataset.cols(arma::regspace<arma::uvec>(1, 2, 299));
+  KNN naive(liveSet, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, trueNeighbors;
+  arma::mat distances, trueDistances;
+  naive.Search(queryData, 3, trueNeighbors, trueDistances);
+  model.Search(std::move(arma::mat(queryData)), 3, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], 2 * trueNeighbors[i] + 1);
+    BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+  }
+
+  KNNModel hnswModel(KNNModel::TreeTypes::HNSW);
+  hnswModel.BuildModel(std::move(arma::mat(dataset)), 20, SINGLE_TREE_MODE);
+  BOOST_REQUIRE_THROW(hnswModel.Insert(std::move(arma::mat(queryData))),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnswModel.Remove(removed), std::invalid_argument);
+}
+
+/**
+ * Make sure that searching a frozen tree gives the same results as searching
+ * the same tree before it was frozen, in every tree mode.
+ */
+BOOST_AUTO_TEST_CASE(KNNFrozenTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 300);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  TreeType tree(dataset);
+  TreeType frozenTree(tree);
+  frozenTree.Freeze();
+  BOOST_REQUIRE(frozenTree.IsFrozen());
+
+  KNN knn(std::move(tree));
+  KNN frozenKnn(std::move(frozenTree));
+  BOOST_REQUIRE(frozenKnn.ReferenceTree().IsFrozen());
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    knn.SearchMode() = modes[m];
+    frozenKnn.SearchMode() = modes[m];
+
+    arma::Mat<size_t> neighbors, frozenNeighbors;
+    arma::mat distances, frozenDistances;
+    knn.Search(querySet, 5, neighbors, distances);
+    frozenKnn.Search(querySet, 5, frozenNeighbors, frozenDistances);
+
+    // Monochromatic search too.
+    arma::Mat<size_t> allNeighbors, frozenAllNeighbors;
+    arma::mat allDistances, frozenAllDistances;
+    knn.Search(3, allNeighbors, allDistances);
+    frozenKnn.Search(3, frozenAllNeighbors, frozenAllDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], frozenNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], frozenDistances[i], 1e-5);
+    }
+
+    for (size_t i = 0; i < allNeighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(allNeighbors[i], frozenAllNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(allDistances[i], frozenAllDistances[i], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
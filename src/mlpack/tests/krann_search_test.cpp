@@ -271,6 +271,32 @@ BOOST_AUTO_TEST_CASE(SingleDatasetSearch)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 2500);
 }
 
+// Test that the parallel single-tree and dual-tree searches, which sample from
+// one random stream per block of queries or query subtree, give the same
+// results when the random seed is the same.
+BOOST_AUTO_TEST_CASE(SameSeedSameResultsTest)
+{
+  arma::mat dataset(4, 3000, arma::fill::randn);
+  arma::mat queries(4, 1000, arma::fill::randn);
+
+  for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+  {
+    RASearch<> rann(dataset, false, singleMode == 1);
+
+    arma::Mat<size_t> neighbors1, neighbors2;
+    arma::mat distances1, distances2;
+    math::RandomSeed(42);
+    rann.Search(queries, 3, neighbors1, distances1);
+    math::RandomSeed(42);
+    rann.Search(queries, 3, neighbors2, distances2);
+
+    CheckMatrices(neighbors1, neighbors2);
+    CheckMatrices(distances1, distances2);
+  }
+
+  math::RandomSeed(std::time(NULL));
+}
+
 // Test single-tree rank-approximate search with cover trees.
 BOOST_AUTO_TEST_CASE(SingleCoverTreeTest)
 {
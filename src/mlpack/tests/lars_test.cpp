@@ -397,4 +397,60 @@ BOOST_AUTO_TEST_CASE(LARSTrainReturnCorrelation)
   BOOST_REQUIRE_EQUAL(std::isfinite(maxCorr), true);
 }
 
+/**
+ * Make sure that training on sparse data gives the same solution as training on
+ * the equivalent dense data, both with and without a precomputed Gram matrix.
+ */
+BOOST_AUTO_TEST_CASE(LARSSparseDenseTest)
+{
+  arma::sp_mat spX;
+  spX.sprandu(10, 100, 0.3);
+  arma::mat X(spX);
+  arma::rowvec y = arma::randn<arma::vec>(10).t() * X;
+
+  const double lambda1 = 0.1;
+  for (size_t useCholesky = 0; useCholesky < 2; ++useCholesky)
+  {
+    LARS denseLars(useCholesky, lambda1);
+    arma::vec denseBeta;
+    denseLars.Train(X, y, denseBeta);
+
+    LARS sparseLars(useCholesky, lambda1);
+    arma::vec sparseBeta;
+    sparseLars.Train(spX, y, sparseBeta);
+
+    arma::mat gram = X * X.t();
+    LARS gramLars(useCholesky, gram, lambda1);
+    arma::vec gramBeta;
+    gramLars.Train(spX, y, gramBeta);
+
+    BOOST_REQUIRE_EQUAL(denseBeta.n_elem, sparseBeta.n_elem);
+    BOOST_REQUIRE_EQUAL(denseBeta.n_elem, gramBeta.n_elem);
+    for (size_t i = 0; i < denseBeta.n_elem; ++i)
+    {
+      if (std::abs(denseBeta[i]) < 1e-8)
+      {
+        BOOST_REQUIRE_SMALL(sparseBeta[i], 1e-8);
+        BOOST_REQUIRE_SMALL(gramBeta[i], 1e-8);
+      }
+      else
+      {
+        BOOST_REQUIRE_CLOSE(denseBeta[i], sparseBeta[i], 1e-5);
+        BOOST_REQUIRE_CLOSE(denseBeta[i], gramBeta[i], 1e-5);
+      }
+    }
+
+    arma::rowvec densePredictions, sparsePredictions;
+    denseLars.Predict(X, densePredictions);
+    sparseLars.Predict(spX, sparsePredictions);
+    for (size_t i = 0; i < densePredictions.n_elem; ++i)
+    {
+      if (std::abs(densePredictions[i]) < 1e-8)
+        BOOST_REQUIRE_SMALL(sparsePredictions[i], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(densePredictions[i], sparsePredictions[i], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
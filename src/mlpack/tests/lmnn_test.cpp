@@ -100,6 +100,65 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * The impostors found with the shared tree should match a brute-force search
+ * over the differently labeled points, for several classes and for a subset of
+ * the points.
+ */
+BOOST_AUTO_TEST_CASE(LMNNImpostorsBruteForceTest)
+{
+  arma::mat dataset(3, 300, arma::fill::randu);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 4;
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+    norm(i) = arma::norm(dataset.col(i));
+
+  const size_t k = 3;
+  Constraints<> constraint(dataset, labels, k);
+
+  arma::Mat<size_t> impostors(k, dataset.n_cols);
+  arma::mat distances(k, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  // The distances must be Euclidean, not squared: LMNNFunction bounds them
+  // with the triangle inequality.
+  EuclideanDistance metric;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    arma::vec bruteDistances(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      bruteDistances[j] = (labels[i] == labels[j]) ? DBL_MAX :
+          metric.Evaluate(dataset.col(i), dataset.col(j));
+    }
+    arma::uvec order = arma::sort_index(bruteDistances);
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(impostors(j, i), order[j]);
+      BOOST_REQUIRE_CLOSE(distances(j, i), bruteDistances[order[j]], 1e-5);
+    }
+  }
+
+  // Recomputing only some of the points shouldn't change the others.
+  arma::Mat<size_t> subsetImpostors(k, dataset.n_cols, arma::fill::zeros);
+  arma::mat subsetDistances(k, dataset.n_cols, arma::fill::zeros);
+  arma::uvec points = "5 17 100 299 42";
+  constraint.Impostors(subsetImpostors, subsetDistances, dataset, labels, norm,
+      points, 3);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+      BOOST_REQUIRE_EQUAL(subsetImpostors(j, points[i]),
+          impostors(j, points[i]));
+  }
+  BOOST_REQUIRE_EQUAL(subsetImpostors(0, 42), 0);
+}
+
 //
 // Tests for the LMNNFunction
 //
@@ -403,4 +403,54 @@ BOOST_AUTO_TEST_CASE(ApproxKFNDifferentAlgoTest)
   CheckMatricesNotEqual(firstOutputNeighbors, secondOutputNeighbors);
 }
 
+/**
+ * Make sure that the 'anytime' algorithm without a time limit gives the exact
+ * furthest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(ApproxKFNAnytimeExactTest)
+{
+  arma::mat referenceData;
+  referenceData.randu(6, 100); // 100 points in 6 dimensions.
+
+  KFN kfn(referenceData);
+  arma::Mat<size_t> exactNeighbors;
+  arma::mat exactDistances;
+  kfn.Search(10, exactNeighbors, exactDistances);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 10);
+  SetInputParam("algorithm", (string) "anytime");
+  SetInputParam("max_queue_size", (int) 16);
+
+  mlpackMain();
+
+  // A point is never among its own 10 furthest neighbors, so the results are
+  // the same as those of KFN, which skips the point itself.
+  const arma::Mat<size_t>& neighbors =
+      CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  const arma::mat& distances = CLI::GetParam<arma::mat>("distances");
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], exactNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], exactDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Check that we can't specify a negative time limit.
+ */
+BOOST_AUTO_TEST_CASE(ApproxKFNNegativeTimeLimitTest)
+{
+  arma::mat referenceData;
+  referenceData.randu(6, 100); // 100 points in 6 dimensions.
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("algorithm", (string) "anytime");
+  SetInputParam("time_limit", -1.0); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1009,4 +1009,70 @@ BOOST_AUTO_TEST_CASE(InplaceSparseShuffleWeightsTest)
   }
 }
 
+/**
+ * Make sure the first block of RandomStream matches the published Philox4x32-10
+ * known-answer test, and that streams with different indices differ.
+ */
+BOOST_AUTO_TEST_CASE(RandomStreamKnownAnswerTest)
+{
+  RandomStream stream(0, 0);
+  BOOST_REQUIRE_EQUAL(stream(), 0x6627e8d5U);
+  BOOST_REQUIRE_EQUAL(stream(), 0xe169c58dU);
+  BOOST_REQUIRE_EQUAL(stream(), 0xbc57ac4cU);
+  BOOST_REQUIRE_EQUAL(stream(), 0x9b00dbd8U);
+
+  RandomStream a(42, 0), b(42, 1);
+  size_t equal = 0;
+  for (size_t i = 0; i < 100; ++i)
+    equal += (a() == b()) ? 1 : 0;
+  BOOST_REQUIRE_LT(equal, 5);
+}
+
+/**
+ * Make sure that Discard() skips exactly the given number of outputs.
+ */
+BOOST_AUTO_TEST_CASE(RandomStreamDiscardTest)
+{
+  for (size_t n = 0; n < 10; ++n)
+  {
+    RandomStream a(7, 3), b(7, 3);
+    a();
+    b();
+    for (size_t i = 0; i < n; ++i)
+      a();
+    b.Discard(n);
+
+    BOOST_REQUIRE_EQUAL(a(), b());
+  }
+}
+
+/**
+ * Make sure that the per-thread and per-task streams are reproducible after
+ * reseeding.
+ */
+BOOST_AUTO_TEST_CASE(ThreadRandGenReseedTest)
+{
+  RandomSeed(12);
+  const double r1 = Random();
+  const double n1 = RandNormal();
+  RandomStream t1 = TaskRandGen(5);
+
+  RandomSeed(12);
+  BOOST_REQUIRE_EQUAL(Random(), r1);
+  BOOST_REQUIRE_EQUAL(RandNormal(), n1);
+  RandomStream t2 = TaskRandGen(5);
+  for (size_t i = 0; i < 10; ++i)
+    BOOST_REQUIRE_EQUAL(t1.Random(), t2.Random());
+
+  // Random numbers must lie in [0, 1).
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const double r = Random();
+    BOOST_REQUIRE_GE(r, 0.0);
+    BOOST_REQUIRE_LT(r, 1.0);
+  }
+
+  RandomSeed(std::time(NULL));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -249,6 +249,73 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * When the softmax is restricted to all the other points as neighbors, the
+ * objective and gradient must be the same as those of the exact computation.
+ * This also checks the blocked Euclidean kernel evaluation against the
+ * per-pair metric evaluation used for neighbors.
+ */
+template<typename MetricType>
+void CheckAllNeighborsSoftmax()
+{
+  arma::mat dataset(3, 150, arma::fill::randu);
+  arma::Row<size_t> labels(150);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (i % 3 == 0) ? 0 : 1;
+
+  arma::mat coordinates(3, 3, arma::fill::randu);
+  coordinates += arma::eye<arma::mat>(3, 3);
+
+  SoftmaxErrorFunction<MetricType> exact(dataset, labels);
+  SoftmaxErrorFunction<MetricType> restricted(dataset, labels, MetricType(),
+      dataset.n_cols - 1);
+
+  BOOST_REQUIRE_CLOSE(restricted.Evaluate(coordinates),
+      exact.Evaluate(coordinates), 1e-5);
+
+  arma::mat exactGradient, restrictedGradient;
+  exact.Gradient(coordinates, exactGradient);
+  restricted.Gradient(coordinates, restrictedGradient);
+  for (size_t i = 0; i < exactGradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(restrictedGradient[i], exactGradient[i], 1e-5);
+
+  BOOST_REQUIRE_CLOSE(restricted.Evaluate(coordinates, 10, 70),
+      exact.Evaluate(coordinates, 10, 70), 1e-5);
+
+  exact.Gradient(coordinates, 10, exactGradient, 70);
+  restricted.Gradient(coordinates, 10, restrictedGradient, 70);
+  for (size_t i = 0; i < exactGradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(restrictedGradient[i], exactGradient[i], 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(SoftmaxAllNeighborsTest)
+{
+  CheckAllNeighborsSoftmax<SquaredEuclideanDistance>();
+  CheckAllNeighborsSoftmax<EuclideanDistance>();
+}
+
+/**
+ * Restricting the softmax to a few neighbors should still separate the points
+ * of the simple dataset.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxNeighborsLBFGSTest)
+{
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS> nca(data, labels);
+  nca.ErrorFunction().NumNeighbors() = 3;
+  nca.ErrorFunction().RecomputeInterval() = 1;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  BOOST_REQUIRE_LT(sef.Evaluate(outputMatrix),
+      sef.Evaluate(arma::eye<arma::mat>(2, 2)));
+}
+
 //
 // Tests for the NCA algorithm.
 //
@@ -241,6 +241,65 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDoubleDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task with several copies of the environment.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorizedDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of steps using random weights, so we allow a few trials.
+  bool converged = false;
+  for (size_t trial = 0; trial < 3 && !converged; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+    RandomReplay<CartPole> replayMethod(32, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+
+    // Set up DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+        agent(std::move(config), std::move(model), std::move(policy),
+        std::move(replayMethod));
+
+    // Step eight copies of the task at once.
+    VectorizedEnvironment<CartPole> environments(8, CartPole(), 200);
+    for (size_t step = 0; step < 5000; ++step)
+    {
+      agent.Step(environments);
+
+      // Use the average return of the last episodes as the criterion.
+      const std::vector<double>& returns = environments.EpisodeReturns();
+      if (returns.size() < 20)
+        continue;
+
+      double averageReturn = 0.0;
+      for (size_t i = returns.size() - 20; i < returns.size(); ++i)
+        averageReturn += returns[i] / 20;
+      Log::Debug << "Average return: " << averageReturn << std::endl;
+      if (averageReturn > 35)
+      {
+        converged = true;
+        break;
+      }
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
 //! Test DQN in Acrobot task.
 BOOST_AUTO_TEST_CASE(AcrobotWithDQN)
 {
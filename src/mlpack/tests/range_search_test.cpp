@@ -1696,4 +1696,67 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that points inserted into and removed from a RangeSearch object
+ * give the same results as a brute-force search on the points that are left.
+ */
+BOOST_AUTO_TEST_CASE(InsertRemoveTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 600);
+  arma::mat queryData = arma::randu<arma::mat>(3, 40);
+
+  RangeSearch<> rs(dataset.cols(0, 399));
+  rs.Insert(dataset.cols(400, 429)); // Searched by brute force.
+  rs.Insert(dataset.cols(430, 599)); // Triggers a rebuild.
+  // Invalid lists are rejected before any point is removed.
+  arma::Col<size_t> duplicates = { 5, 410, 5 };
+  BOOST_REQUIRE_THROW(rs.Remove(duplicates), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(rs.NumReferencePoints(), 600);
+
+  arma::Col<size_t> removed = { 5, 17, 410 }; // Only marked as removed.
+  rs.Remove(removed);
+
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < 600; ++i)
+    if (i != 5 && i != 17 && i != 410)
+      indices.push_back(i);
+  arma::mat liveSet(3, indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    liveSet.col(i) = dataset.col(indices[i]);
+
+  BOOST_REQUIRE_EQUAL(rs.NumReferencePoints(), indices.size());
+
+  RangeSearch<> naive(liveSet, true);
+  vector<vector<size_t>> neighbors, trueNeighbors;
+  vector<vector<double>> distances, trueDistances;
+  const math::Range range(0.1, 0.3);
+  rs.Search(queryData, range, neighbors, distances);
+  naive.Search(queryData, range, trueNeighbors, trueDistances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.size(), queryData.n_cols);
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i].size(), trueNeighbors[i].size());
+
+    std::vector<size_t> found(neighbors[i]);
+    std::vector<size_t> expected(trueNeighbors[i].size());
+    for (size_t j = 0; j < trueNeighbors[i].size(); ++j)
+      expected[j] = indices[trueNeighbors[i][j]];
+    std::sort(found.begin(), found.end());
+    std::sort(expected.begin(), expected.end());
+    for (size_t j = 0; j < found.size(); ++j)
+      BOOST_REQUIRE_EQUAL(found[j], expected[j]);
+  }
+
+  // The monochromatic search rebuilds the tree first; removed points have no
+  // results.
+  rs.Search(range, neighbors, distances);
+  naive.Search(range, trueNeighbors, trueDistances);
+  BOOST_REQUIRE_EQUAL(neighbors.size(), 600);
+  BOOST_REQUIRE_EQUAL(neighbors[5].size(), 0);
+  BOOST_REQUIRE_EQUAL(neighbors[410].size(), 0);
+  for (size_t i = 0; i < indices.size(); ++i)
+    BOOST_REQUIRE_EQUAL(neighbors[indices[i]].size(), trueNeighbors[i].size());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
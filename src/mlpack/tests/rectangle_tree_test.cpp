@@ -1384,4 +1384,75 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Bulk load a tree of the given type with the given packing policy, check that
+ * it is a valid and balanced tree (which is not higher than the tree built by
+ * inserting the points, if it was packed), and check that nearest neighbor
+ * search with it gives the same results as the given naive search.
+ */
+template<template<typename, typename, typename> class TreeType,
+         typename PackingType>
+void CheckBulkLoadedTree(const arma::mat& dataset,
+                         const arma::Mat<size_t>& naiveNeighbors,
+                         const arma::mat& naiveDistances)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(PackingType(), dataset, 20, 6, 5, 2, 0);
+  Tree insertedTree(dataset, 20, 6, 5, 2, 0);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), dataset.n_cols);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  if (PackingTraits<Tree>::CanPack)
+    BOOST_REQUIRE_LE(tree.TreeDepth(), insertedTree.TreeDepth());
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(std::move(tree));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(5, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the bulk-loaded rectangle type trees are valid and give the
+ * right nearest neighbors, with both packing policies.
+ */
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  naive.Search(5, neighbors, distances);
+
+  CheckBulkLoadedTree<RTree, SortTileRecursivePacking>(dataset, neighbors,
+      distances);
+  CheckBulkLoadedTree<RTree, HilbertPacking>(dataset, neighbors, distances);
+  CheckBulkLoadedTree<RStarTree, SortTileRecursivePacking>(dataset, neighbors,
+      distances);
+  CheckBulkLoadedTree<XTree, HilbertPacking>(dataset, neighbors, distances);
+
+  // The Hilbert R tree is built by inserting the points in Hilbert order, so
+  // it must keep its ordering.
+  CheckBulkLoadedTree<HilbertRTree, HilbertPacking>(dataset, neighbors,
+      distances);
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType hilbertRTree(HilbertPacking(), dataset, 20, 6, 5, 2, 0);
+  CheckHilbertOrdering(hilbertRTree);
+  CheckDiscreteHilbertValueSync(hilbertRTree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
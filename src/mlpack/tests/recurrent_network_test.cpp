@@ -1413,4 +1413,116 @@ BOOST_AUTO_TEST_CASE(BRNNTrainReturnObjective)
   BOOST_REQUIRE_EQUAL(std::isfinite(objVal), true);
 }
 
+/**
+ * Test that the padding of sequences of different lengths does not affect the
+ * objective and the gradient of an RNN, and that it can be trained on them.
+ */
+BOOST_AUTO_TEST_CASE(RNNVariableLengthTest)
+{
+  const size_t rho = 6;
+  const size_t numSequences = 8;
+
+  arma::cube input(3, numSequences, rho, arma::fill::randn);
+  arma::cube responses(2, numSequences, rho, arma::fill::randn);
+  arma::Row<size_t> lengths = arma::randi<arma::Row<size_t>>(numSequences,
+      arma::distr_param(2, (int) rho));
+  lengths[0] = 1;
+
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(3, 4, rho);
+  model.Add<Linear<> >(4, 2);
+
+  model.Predictors() = input;
+  model.Responses() = responses;
+  model.SequenceLengths() = lengths;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, numSequences);
+
+  // Change the padding; nothing should change.
+  for (size_t i = 0; i < numSequences; ++i)
+  {
+    for (size_t s = lengths[i]; s < rho; ++s)
+    {
+      model.Predictors().slice(s).col(i).randn();
+      model.Responses().slice(s).col(i).randn();
+    }
+  }
+
+  arma::mat paddedGradient;
+  const double paddedObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, paddedGradient, numSequences);
+
+  BOOST_REQUIRE_CLOSE(objective, paddedObjective, 1e-5);
+  CheckMatrices(gradient, paddedGradient, 1e-5);
+
+  const size_t batchSize = 2;
+  StandardSGD opt(0.01, batchSize, 5 * numSequences, -100);
+  const double objVal = model.Train(input, responses, opt, lengths);
+  BOOST_REQUIRE_EQUAL(std::isfinite(objVal), true);
+
+  // The sequences are bucketed by length, but the order of the batches is
+  // shuffled, so each batch must hold the lengths of one of the sorted
+  // buckets.
+  const arma::Row<size_t> sortedLengths = arma::sort(lengths);
+  std::vector<bool> usedBuckets(numSequences / batchSize, false);
+  for (size_t i = 0; i < numSequences; i += batchSize)
+  {
+    const arma::Row<size_t> batchLengths = arma::sort(
+        model.SequenceLengths().subvec(i, i + batchSize - 1));
+
+    bool found = false;
+    for (size_t b = 0; b < usedBuckets.size() && !found; ++b)
+    {
+      if (!usedBuckets[b] && arma::all(batchLengths ==
+          sortedLengths.subvec(b * batchSize, (b + 1) * batchSize - 1)))
+      {
+        usedBuckets[b] = true;
+        found = true;
+      }
+    }
+    BOOST_REQUIRE(found);
+  }
+}
+
+/**
+ * Make sure that an RNN with a Recurrent layer, which can't stop its recursion
+ * early, can't be trained on sequences shorter than rho.
+ */
+BOOST_AUTO_TEST_CASE(RNNVariableLengthRecurrentTest)
+{
+  const size_t rho = 5;
+  const size_t numSequences = 4;
+
+  arma::cube input(1, numSequences, rho, arma::fill::randn);
+  arma::cube responses(1, numSequences, rho, arma::fill::randn);
+  arma::Row<size_t> lengths(numSequences);
+  lengths.fill(rho);
+
+  Add<> add(4);
+  Linear<> lookup(1, 4);
+  SigmoidLayer<> sigmoidLayer;
+  Linear<> linear(4, 4);
+  Recurrent<>* recurrent = new Recurrent<>(add, lookup, linear,
+      sigmoidLayer, rho);
+
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add(recurrent);
+  model.Add<Linear<> >(4, 1);
+
+  StandardSGD opt(0.01, 2, numSequences, -100);
+
+  // Sequences of length rho are fine.
+  const double objVal = model.Train(input, responses, opt, lengths);
+  BOOST_REQUIRE_EQUAL(std::isfinite(objVal), true);
+
+  lengths[1] = 2;
+  BOOST_REQUIRE_THROW(model.Train(input, responses, opt, lengths),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
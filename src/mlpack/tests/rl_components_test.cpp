@@ -20,6 +20,7 @@
 #include <mlpack/methods/reinforcement_learning/environment/continuous_multiple_pole_cart.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vectorized_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
@@ -268,6 +269,96 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Step a vectorized Cart Pole environment and make sure that each copy follows
+ * the dynamics of a single Cart Pole, that finished episodes are restarted, and
+ * that the transitions can be stored in a replay memory at once.
+ */
+BOOST_AUTO_TEST_CASE(VectorizedEnvironmentTest)
+{
+  VectorizedEnvironment<CartPole> envs(4, CartPole(), 5);
+  BOOST_REQUIRE_EQUAL(envs.NumEnvironments(), 4);
+  BOOST_REQUIRE_EQUAL(envs.EncodedStates().n_rows, CartPole::State::dimension);
+  BOOST_REQUIRE_EQUAL(envs.EncodedStates().n_cols, 4);
+
+  RandomReplay<CartPole> replay(4, 100);
+  CartPole env;
+  std::vector<CartPole::Action> actions(4, CartPole::Action::forward);
+  arma::mat states, nextStates;
+  arma::colvec rewards;
+  arma::icolvec isTerminal;
+  for (size_t step = 0; step < 12; ++step)
+  {
+    const arma::mat currentStates = envs.EncodedStates();
+    envs.Step(actions, states, rewards, nextStates, isTerminal);
+    CheckMatrices(currentStates, states);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+      CartPole::State nextState;
+      const double reward = env.Sample(CartPole::State(states.col(i)),
+          actions[i], nextState);
+      CheckMatrices(nextState.Encode(), nextStates.col(i));
+      BOOST_REQUIRE_CLOSE(reward, rewards[i], 1e-5);
+      BOOST_REQUIRE_EQUAL(false, isTerminal[i]);
+    }
+
+    replay.BatchStore(states, actions, rewards, nextStates, isTerminal);
+  }
+
+  // Every copy finished two episodes of five steps.
+  BOOST_REQUIRE_EQUAL(envs.EpisodeReturns().size(), 8);
+  for (size_t i = 0; i < 8; ++i)
+    BOOST_REQUIRE_CLOSE(envs.EpisodeReturns()[i], 5.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 48);
+}
+
+/**
+ * Make sure that a random replay storing its observations as floats returns the
+ * stored transitions, and that sampling into the same matrices again does not
+ * reallocate them.
+ */
+BOOST_AUTO_TEST_CASE(FloatRandomReplayTest)
+{
+  RandomReplay<CartPole, float> replay(8, 4);
+  CartPole env;
+  CartPole::State state = env.InitialSample();
+  CartPole::State nextState;
+  const double reward = env.Sample(state, CartPole::Action::forward,
+      nextState);
+  replay.Store(state, CartPole::Action::forward, reward, nextState, false);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 1);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  BOOST_REQUIRE_EQUAL(sampledState.n_rows, CartPole::State::dimension);
+  BOOST_REQUIRE_EQUAL(sampledState.n_cols, 8);
+
+  const double* statesMemory = sampledState.memptr();
+  const double* nextStatesMemory = sampledNextState.memptr();
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  BOOST_REQUIRE_EQUAL(sampledState.memptr(), statesMemory);
+  BOOST_REQUIRE_EQUAL(sampledNextState.memptr(), nextStatesMemory);
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    for (size_t d = 0; d < CartPole::State::dimension; ++d)
+    {
+      BOOST_REQUIRE_CLOSE(sampledState(d, i), state.Encode()[d], 1e-4);
+      BOOST_REQUIRE_CLOSE(sampledNextState(d, i), nextState.Encode()[d], 1e-4);
+    }
+    BOOST_REQUIRE_EQUAL(sampledAction[i], CartPole::Action::forward);
+    BOOST_REQUIRE_CLOSE(sampledReward[i], reward, 1e-5);
+    BOOST_REQUIRE_EQUAL(sampledTerminal[i], 0);
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -91,4 +91,38 @@ BOOST_AUTO_TEST_CASE(BatchUpdate)
   BOOST_CHECK_EQUAL(sumtree.FindPrefixSum(3.0), 3);
 }
 
+/**
+ * Test that a batch update of a few elements, possibly repeated, gives the
+ * same tree as setting the elements one by one, also when the capacity is not
+ * a power of two.
+ */
+BOOST_AUTO_TEST_CASE(BatchUpdateMatchesSet)
+{
+  const size_t capacities[] = { 1, 10, 37, 1024 };
+  for (const size_t capacity : capacities)
+  {
+    SumTree<double> batchTree(capacity);
+    SumTree<double> setTree(capacity);
+    for (size_t trial = 0; trial < 5; ++trial)
+    {
+      const size_t count = math::RandInt(1, (int) (2 * capacity + 1));
+      arma::ucolvec indices(count);
+      arma::colvec data(count, arma::fill::randu);
+      for (size_t i = 0; i < count; ++i)
+      {
+        indices[i] = math::RandInt((int) capacity);
+        setTree.Set(indices[i], data[i]);
+      }
+      batchTree.BatchUpdate(indices, data);
+
+      for (size_t i = 0; i < capacity; ++i)
+      {
+        BOOST_REQUIRE_CLOSE(batchTree.Get(i), setTree.Get(i), 1e-8);
+        BOOST_REQUIRE_CLOSE(batchTree.Sum(0, i + 1), setTree.Sum(0, i + 1),
+            1e-8);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -147,4 +147,50 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Make sure that the profiler nests regions and sums counters over threads.
+ */
+BOOST_AUTO_TEST_CASE(ProfilerRegionTest)
+{
+  const size_t outer = Profiler::RegisterRegion("profiler_test_outer");
+  const size_t inner = Profiler::RegisterRegion("profiler_test_inner");
+  BOOST_REQUIRE_EQUAL(Profiler::RegisterRegion("profiler_test_outer"), outer);
+
+  Profiler::Reset();
+  Profiler::Enable();
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < 10; ++i)
+  {
+    ProfileScope outerScope(outer);
+    ProfileScope innerScope(inner);
+    Profiler::Add(BaseCasesCounter, 3);
+  }
+
+  Profiler::Disable();
+
+  // Nothing should be recorded while the profiler is disabled.
+  {
+    ProfileScope scope(outer);
+    Profiler::Add(BaseCasesCounter, 100);
+  }
+
+  BOOST_REQUIRE_EQUAL(Profiler::CounterValue(BaseCasesCounter), 30U);
+
+  const std::string json = Profiler::ToJSON();
+  BOOST_REQUIRE_NE(json.find("\"base_cases\": 30"), std::string::npos);
+  BOOST_REQUIRE_NE(json.find("\"name\": \"profiler_test_outer\", "
+      "\"calls\": "), std::string::npos);
+  // The inner region must be a child of the outer region.
+  BOOST_REQUIRE_GT(json.find("profiler_test_inner"),
+      json.find("profiler_test_outer"));
+
+  const std::string trace = Profiler::ToChromeTrace();
+  BOOST_REQUIRE_NE(trace.find("\"traceEvents\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.find("\"ph\": \"X\""), std::string::npos);
+
+  Profiler::Reset();
+  BOOST_REQUIRE_EQUAL(Profiler::CounterValue(BaseCasesCounter), 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
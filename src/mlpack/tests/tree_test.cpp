@@ -1803,6 +1803,65 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
   BOOST_REQUIRE_EQUAL(tree2.NumChildren(), 2);
 }
 
+/**
+ * Check that two binary space trees have the same structure and bounds, and
+ * that the parent pointers of the second one are right.
+ */
+template<typename TreeType>
+void CheckSameTree(const TreeType& tree, const TreeType& other)
+{
+  BOOST_REQUIRE_EQUAL(tree.Begin(), other.Begin());
+  BOOST_REQUIRE_EQUAL(tree.Count(), other.Count());
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), other.NumChildren());
+  BOOST_REQUIRE_EQUAL(tree.FurthestDescendantDistance(),
+      other.FurthestDescendantDistance());
+  for (size_t d = 0; d < tree.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Bound()[d].Lo(), other.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(tree.Bound()[d].Hi(), other.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < other.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(other.Child(i).Parent(), &other);
+    CheckSameTree(tree.Child(i), other.Child(i));
+  }
+}
+
+/**
+ * Make sure that freezing a tree doesn't change it, and that a frozen tree can
+ * be moved, copied and destroyed.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeFreezeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset);
+  TreeType frozenTree(tree);
+  BOOST_REQUIRE(!frozenTree.IsFrozen());
+
+  // Only the root can be frozen.
+  BOOST_REQUIRE_THROW(frozenTree.Left()->Freeze(), std::invalid_argument);
+
+  frozenTree.Freeze();
+  BOOST_REQUIRE(frozenTree.IsFrozen());
+  CheckSameTree(tree, frozenTree);
+
+  // Freezing twice does nothing.
+  frozenTree.Freeze();
+  CheckSameTree(tree, frozenTree);
+
+  TreeType movedTree(std::move(frozenTree));
+  BOOST_REQUIRE(movedTree.IsFrozen());
+  BOOST_REQUIRE(!frozenTree.IsFrozen());
+  CheckSameTree(tree, movedTree);
+
+  TreeType copiedTree(movedTree);
+  BOOST_REQUIRE(!copiedTree.IsFrozen());
+  CheckSameTree(tree, copiedTree);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -1951,6 +2010,33 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+/**
+ * Create a cover tree large enough for its children to be built in parallel
+ * (when OpenMP is available), and make sure it's accurate.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCoverTreeConstructionTest)
+{
+  arma::mat dataset;
+  dataset.randu(5, 10000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 10000);
+
+  // Ensure each leaf is only created once.
+  arma::vec counts;
+  counts.zeros(10000);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 10000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true> >(tree);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -51,4 +51,52 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Make sure that concurrent unions give the same components as sequential
+ * unions.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10000;
+  UnionFind testUnionFind(testSize);
+  UnionFind sequentialUnionFind(testSize);
+
+  // Random edges; each one is added by the thread that gets it.
+  arma::Mat<size_t> edges = arma::randi<arma::Mat<size_t>>(2, testSize / 2,
+      arma::distr_param(0, (int) testSize - 1));
+
+  size_t merges = 0;
+  #pragma omp parallel for reduction(+:merges)
+  for (omp_size_t i = 0; i < (omp_size_t) edges.n_cols; ++i)
+  {
+    if (testUnionFind.Union(edges(0, i), edges(1, i)))
+      ++merges;
+    testUnionFind.Find(edges(1, i));
+  }
+
+  size_t sequentialMerges = 0;
+  for (size_t i = 0; i < edges.n_cols; ++i)
+    if (sequentialUnionFind.Union(edges(0, i), edges(1, i)))
+      ++sequentialMerges;
+
+  BOOST_REQUIRE_EQUAL(merges, sequentialMerges);
+
+  // Each merge must have removed exactly one component.
+  size_t roots = 0;
+  for (size_t i = 0; i < testSize; ++i)
+    if (testUnionFind.Find(i) == i)
+      ++roots;
+  BOOST_REQUIRE_EQUAL(roots, testSize - merges);
+
+  // The components must be the same.
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    for (size_t j = i + 1; j < testSize; j += 97)
+    {
+      BOOST_REQUIRE_EQUAL(testUnionFind.Find(i) == testUnionFind.Find(j),
+          sequentialUnionFind.Find(i) == sequentialUnionFind.Find(j));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();